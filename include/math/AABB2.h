@@ -1,27 +1,30 @@
 #pragma once
 
+#include <math/fwd.h>
 #include <math/vec2.h>
 
 namespace kx {
 
 /// A 2D axis-aligned bounding box.
-struct AABB2 {
-  vec2 pmin, pmax;
+template <typename T>
+struct AABB2T {
+  vec2T<T> pmin, pmax;
 
-  KX_MATH_API AABB2() : pmin(1), pmax(-1) {}
+  KX_MATH_API constexpr AABB2T() : pmin(1), pmax(-1) {}
 
-  KX_MATH_API AABB2(vec2 pmin, vec2 pmax) : pmin(pmin), pmax(pmax) {}
+  KX_MATH_API constexpr AABB2T(vec2T<T> pmin, vec2T<T> pmax)
+      : pmin(pmin), pmax(pmax) {}
 
   /// Construct an AABB2 from an array of points.
   /// \param ps The array of points.
   /// \param n  The number of points in the array.
-  KX_MATH_API AABB2(vec2* ps, unsigned n);
+  KX_MATH_API AABB2T(vec2T<T>* ps, unsigned n);
 
   /// Update the AABB2 to contain the point.
-  KX_MATH_API void add(const vec2& p);
+  KX_MATH_API void add(const vec2T<T>& p);
 
   /// Update the AABB2 to contain the given AABB2.
-  KX_MATH_API void add(const AABB2&);
+  KX_MATH_API void add(const AABB2T&);
 };
 
 }  // namespace kx
@@ -1,35 +1,90 @@
 #pragma once
 
+#include <math/fwd.h>
 #include <math/vec3.h>
 
+#include <limits>
+
 namespace kx {
 
 /// A 3D axis-aligned bounding box.
-struct AABB3 {
-  vec3 pmin, pmax;
+///
+/// An empty AABB has pmin = +infinity and pmax = -infinity, so that adding a
+/// point or an AABB to it needs no special case. Bounds are inclusive: AABBs
+/// that touch overlap, and an AABB contains the points on its faces.
+///
+/// AABB3a stores a single-precision AABB aligned for SIMD instructions.
+template <typename T>
+struct AABB3T {
+  vec3T<T> pmin, pmax;
 
-  /// Construct an AABB with pmin = 1 and pmax = -1.
-  KX_MATH_API AABB3() : pmin(1), pmax(-1) {}
+  /// Construct an empty AABB.
+  KX_MATH_API constexpr AABB3T()
+      : pmin(std::numeric_limits<T>::infinity()),
+        pmax(-std::numeric_limits<T>::infinity()) {}
 
   /// Construct an AABB from two points.
-  KX_MATH_API AABB3(vec3 pmin, vec3 pmax) : pmin(pmin), pmax(pmax) {}
+  KX_MATH_API constexpr AABB3T(vec3T<T> pmin, vec3T<T> pmax)
+      : pmin(pmin), pmax(pmax) {}
 
   /// Construct an AABB from two points.
-  KX_MATH_API AABB3(R xmin, R ymin, R zmin, R xmax, R ymax, R zmax)
+  KX_MATH_API constexpr AABB3T(T xmin, T ymin, T zmin, T xmax, T ymax, T zmax)
       : pmin(xmin, ymin, zmin), pmax(xmax, ymax, zmax) {}
 
   /// Construct an AABB from two points.
-  KX_MATH_API AABB3(const R val[6])
+  KX_MATH_API constexpr AABB3T(const T val[6])
       : pmin(val[0], val[1], val[2]), pmax(val[3], val[4], val[5]) {}
 
-  /// Construct an AABB from an array of points.
-  KX_MATH_API AABB3(vec3* ps, unsigned n);
+  /// Construct an AABB from an array of points. For large arrays, see
+  /// bounding_box(), which spreads the work across threads.
+  KX_MATH_API AABB3T(vec3T<T>* ps, unsigned n);
+
+  /// Return true if the AABB contains no point.
+  KX_MATH_API bool empty() const;
+
+  /// Return the AABB's center. Undefined if the AABB is empty.
+  KX_MATH_API vec3T<T> centroid() const;
+
+  /// Return the AABB's size along each axis. Undefined if the AABB is empty.
+  KX_MATH_API vec3T<T> extent() const;
+
+  /// Return the AABB's surface area, or 0 if it is empty.
+  KX_MATH_API T surfaceArea() const;
+
+  /// Return true if the AABBs overlap.
+  KX_MATH_API bool overlaps(const AABB3T&) const;
+
+  /// Return true if the AABB contains the point.
+  KX_MATH_API bool contains(const vec3T<T>& p) const;
+
+  /// Return true if the AABB contains the given AABB. Every AABB contains an
+  /// empty one.
+  KX_MATH_API bool contains(const AABB3T&) const;
 
   /// Update the AABB to contain the point.
-  KX_MATH_API void add(const vec3& p);
+  KX_MATH_API void add(const vec3T<T>& p);
 
   /// Update the AABB to contain the given AABB3.
-  KX_MATH_API void add(const AABB3&);
+  KX_MATH_API void add(const AABB3T&);
 };
 
+/// Return the smallest AABB containing both AABBs.
+template <typename T>
+KX_MATH_API AABB3T<T> merge(const AABB3T<T>&, const AABB3T<T>&);
+
+/// Return the AABB of the points in both AABBs. It is empty if they do not
+/// overlap.
+template <typename T>
+KX_MATH_API AABB3T<T> intersection(const AABB3T<T>&, const AABB3T<T>&);
+
+/// Return the smallest AABB containing the AABB transformed by the affine
+/// matrix. This uses Arvo's method, which costs a few multiply-adds per
+/// matrix element instead of transforming the 8 corners.
+template <typename T>
+KX_MATH_API AABB3T<T> transform(const mat4T<T>&, const AABB3T<T>&);
+
 }  // namespace kx
+
+#ifdef KX_MATH_INLINE
+#include <math/AABB3.inl>
+#endif
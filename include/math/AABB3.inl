@@ -0,0 +1,123 @@
+#pragma once
+
+// Definitions of the AABB3 primitives that may be inlined.
+//
+// This file is included by AABB3.h when KX_MATH_INLINE is defined, and by
+// AABB3.cc otherwise. See defs.h.
+
+#include <math/mat4.h>
+
+namespace kx {
+
+template <typename T>
+KX_MATH_INL KX_MATH_API AABB3T<T>::AABB3T(vec3T<T>* ps, unsigned n)
+    : AABB3T() {
+  vec3T<T>* p = ps;
+  for (unsigned i = 0; i < n; ++i, ++p) add(*p);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API bool AABB3T<T>::empty() const {
+  return !(pmin.x <= pmax.x && pmin.y <= pmax.y && pmin.z <= pmax.z);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec3T<T> AABB3T<T>::centroid() const {
+  return (pmin + pmax) / T(2);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec3T<T> AABB3T<T>::extent() const {
+  return pmax - pmin;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API T AABB3T<T>::surfaceArea() const {
+  if (empty()) return 0;
+  const vec3T<T> d = pmax - pmin;
+  return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API bool AABB3T<T>::overlaps(const AABB3T<T>& box) const {
+  return pmin.x <= box.pmax.x && box.pmin.x <= pmax.x &&
+         pmin.y <= box.pmax.y && box.pmin.y <= pmax.y &&
+         pmin.z <= box.pmax.z && box.pmin.z <= pmax.z;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API bool AABB3T<T>::contains(const vec3T<T>& p) const {
+  return pmin.x <= p.x && p.x <= pmax.x && pmin.y <= p.y && p.y <= pmax.y &&
+         pmin.z <= p.z && p.z <= pmax.z;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API bool AABB3T<T>::contains(const AABB3T<T>& box) const {
+  return box.empty() ||
+         (pmin.x <= box.pmin.x && box.pmax.x <= pmax.x &&
+          pmin.y <= box.pmin.y && box.pmax.y <= pmax.y &&
+          pmin.z <= box.pmin.z && box.pmax.z <= pmax.z);
+}
+
+// The conditional expressions below compile to single min and max
+// instructions, unlike fmin and fmax, which must handle NaNs.
+
+template <typename T>
+KX_MATH_INL KX_MATH_API void AABB3T<T>::add(const vec3T<T>& p) {
+  pmin.x = p.x < pmin.x ? p.x : pmin.x;
+  pmin.y = p.y < pmin.y ? p.y : pmin.y;
+  pmin.z = p.z < pmin.z ? p.z : pmin.z;
+  pmax.x = p.x > pmax.x ? p.x : pmax.x;
+  pmax.y = p.y > pmax.y ? p.y : pmax.y;
+  pmax.z = p.z > pmax.z ? p.z : pmax.z;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API void AABB3T<T>::add(const AABB3T<T>& box) {
+  pmin.x = box.pmin.x < pmin.x ? box.pmin.x : pmin.x;
+  pmin.y = box.pmin.y < pmin.y ? box.pmin.y : pmin.y;
+  pmin.z = box.pmin.z < pmin.z ? box.pmin.z : pmin.z;
+  pmax.x = box.pmax.x > pmax.x ? box.pmax.x : pmax.x;
+  pmax.y = box.pmax.y > pmax.y ? box.pmax.y : pmax.y;
+  pmax.z = box.pmax.z > pmax.z ? box.pmax.z : pmax.z;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API AABB3T<T> merge(const AABB3T<T>& a,
+                                        const AABB3T<T>& b) {
+  AABB3T<T> box = a;
+  box.add(b);
+  return box;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API AABB3T<T> intersection(const AABB3T<T>& a,
+                                               const AABB3T<T>& b) {
+  AABB3T<T> box;
+  for (int i = 0; i < 3; ++i) {
+    box.pmin[i] = a.pmin[i] > b.pmin[i] ? a.pmin[i] : b.pmin[i];
+    box.pmax[i] = a.pmax[i] < b.pmax[i] ? a.pmax[i] : b.pmax[i];
+  }
+  return box;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API AABB3T<T> transform(const mat4T<T>& m,
+                                            const AABB3T<T>& box) {
+  // The extremes of each coordinate of the transformed box are sums of the
+  // extremes of each matrix element times the matching box coordinate. The
+  // infinities of an empty box would give NaNs.
+  if (box.empty()) return AABB3T<T>();
+  AABB3T<T> out(m.v3(), m.v3());
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      const T a = m(i, j) * box.pmin[j];
+      const T b = m(i, j) * box.pmax[j];
+      out.pmin[i] += a < b ? a : b;
+      out.pmax[i] += a < b ? b : a;
+    }
+  }
+  return out;
+}
+
+}  // namespace kx
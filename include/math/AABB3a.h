@@ -0,0 +1,257 @@
+#pragma once
+
+#include <math/AABB3.h>
+#include <math/mat4.h>
+#include <math/simd.h>
+
+#include <cmath>
+#include <limits>
+
+namespace kx {
+
+/// A single-precision AABB3 aligned to 16 bytes, for SIMD instructions.
+///
+/// Each corner fills a 4-float register, with a padding lane kept at 0, so
+/// that the tests and updates below compile to a handful of SSE instructions
+/// with no shuffling. The semantics are those of AABB3T: the default AABB is
+/// empty, and bounds are inclusive. Without SSE the functions fall back to
+/// scalar code.
+struct alignas(16) AABB3a {
+  float pmin[4], pmax[4];
+
+  /// Construct an empty AABB.
+  AABB3a() : pmin{kInf, kInf, kInf, 0}, pmax{-kInf, -kInf, -kInf, 0} {}
+
+  /// Construct an AABB from a single-precision one.
+  explicit AABB3a(const AABB3f& box)
+      : pmin{box.pmin.x, box.pmin.y, box.pmin.z, 0},
+        pmax{box.pmax.x, box.pmax.y, box.pmax.z, 0} {}
+
+  /// Construct an AABB from a double-precision one, rounded outwards so that
+  /// it contains it.
+  explicit AABB3a(const AABB3d& box) : AABB3a() {
+    for (int i = 0; i < 3; ++i) {
+      pmin[i] = float(box.pmin[i]);
+      pmax[i] = float(box.pmax[i]);
+      if (pmin[i] > box.pmin[i]) pmin[i] = std::nextafter(pmin[i], -kInf);
+      if (pmax[i] < box.pmax[i]) pmax[i] = std::nextafter(pmax[i], kInf);
+    }
+  }
+
+  /// Convert to an AABB3T.
+  template <typename T>
+  explicit operator AABB3T<T>() const {
+    return AABB3T<T>(pmin[0], pmin[1], pmin[2], pmax[0], pmax[1], pmax[2]);
+  }
+
+  /// Return true if the AABB contains no point.
+  bool empty() const;
+
+  /// Return the AABB's center. Undefined if the AABB is empty.
+  vec3f centroid() const;
+
+  /// Return the AABB's size along each axis. Undefined if the AABB is empty.
+  vec3f extent() const;
+
+  /// Return the AABB's surface area, or 0 if it is empty.
+  float surfaceArea() const;
+
+  /// Return true if the AABBs overlap.
+  bool overlaps(const AABB3a&) const;
+
+  /// Return true if the AABB contains the point.
+  bool contains(const vec3f& p) const;
+
+  /// Return true if the AABB contains the given AABB. Every AABB contains an
+  /// empty one.
+  bool contains(const AABB3a&) const;
+
+  /// Update the AABB to contain the point.
+  void add(const vec3f& p);
+
+  /// Update the AABB to contain the given AABB.
+  void add(const AABB3a&);
+
+ private:
+  static constexpr float kInf = std::numeric_limits<float>::infinity();
+};
+
+/// Return the smallest AABB containing both AABBs.
+AABB3a merge(const AABB3a&, const AABB3a&);
+
+/// Return the AABB of the points in both AABBs. It is empty if they do not
+/// overlap.
+AABB3a intersection(const AABB3a&, const AABB3a&);
+
+/// Return the smallest AABB containing the AABB transformed by the affine
+/// matrix, with Arvo's method.
+AABB3a transform(const mat4f&, const AABB3a&);
+
+#if defined(KX_MATH_SSE2) || defined(KX_MATH_AVX)
+
+inline bool AABB3a::empty() const {
+  return _mm_movemask_ps(_mm_cmpgt_ps(_mm_load_ps(pmin), _mm_load_ps(pmax))) !=
+         0;
+}
+
+inline vec3f AABB3a::centroid() const {
+  alignas(16) float c[4];
+  _mm_store_ps(c, _mm_mul_ps(_mm_add_ps(_mm_load_ps(pmin), _mm_load_ps(pmax)),
+                             _mm_set1_ps(0.5f)));
+  return vec3f(c[0], c[1], c[2]);
+}
+
+inline vec3f AABB3a::extent() const {
+  alignas(16) float d[4];
+  _mm_store_ps(d, _mm_sub_ps(_mm_load_ps(pmax), _mm_load_ps(pmin)));
+  return vec3f(d[0], d[1], d[2]);
+}
+
+inline float AABB3a::surfaceArea() const {
+  if (empty()) return 0;
+  // Multiply (dx, dy, dz, 0) by (dy, dz, dx, 0) and sum the lanes.
+  const __m128 d = _mm_sub_ps(_mm_load_ps(pmax), _mm_load_ps(pmin));
+  __m128 s = _mm_mul_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 0, 2, 1)));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+  return 2 * _mm_cvtss_f32(s);
+}
+
+inline bool AABB3a::overlaps(const AABB3a& box) const {
+  const __m128 m = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(pmin),
+                                           _mm_load_ps(box.pmax)),
+                              _mm_cmple_ps(_mm_load_ps(box.pmin),
+                                           _mm_load_ps(pmax)));
+  return _mm_movemask_ps(m) == 0xf;
+}
+
+inline bool AABB3a::contains(const vec3f& p) const {
+  const __m128 q = _mm_set_ps(0, p.z, p.y, p.x);
+  const __m128 m = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(pmin), q),
+                              _mm_cmple_ps(q, _mm_load_ps(pmax)));
+  return _mm_movemask_ps(m) == 0xf;
+}
+
+inline bool AABB3a::contains(const AABB3a& box) const {
+  const __m128 m = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(pmin),
+                                           _mm_load_ps(box.pmin)),
+                              _mm_cmple_ps(_mm_load_ps(box.pmax),
+                                           _mm_load_ps(pmax)));
+  return box.empty() || _mm_movemask_ps(m) == 0xf;
+}
+
+inline void AABB3a::add(const vec3f& p) {
+  const __m128 q = _mm_set_ps(0, p.z, p.y, p.x);
+  _mm_store_ps(pmin, _mm_min_ps(_mm_load_ps(pmin), q));
+  _mm_store_ps(pmax, _mm_max_ps(_mm_load_ps(pmax), q));
+}
+
+inline void AABB3a::add(const AABB3a& box) {
+  _mm_store_ps(pmin, _mm_min_ps(_mm_load_ps(pmin), _mm_load_ps(box.pmin)));
+  _mm_store_ps(pmax, _mm_max_ps(_mm_load_ps(pmax), _mm_load_ps(box.pmax)));
+}
+
+inline AABB3a intersection(const AABB3a& a, const AABB3a& b) {
+  AABB3a box;
+  _mm_store_ps(box.pmin, _mm_max_ps(_mm_load_ps(a.pmin), _mm_load_ps(b.pmin)));
+  _mm_store_ps(box.pmax, _mm_min_ps(_mm_load_ps(a.pmax), _mm_load_ps(b.pmax)));
+  return box;
+}
+
+inline AABB3a transform(const mat4f& m, const AABB3a& box) {
+  if (box.empty()) return AABB3a();
+  // The columns of the matrix, with their last row cleared to keep the
+  // padding lane at 0.
+  const float* c = m;
+  const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  __m128 lo = _mm_and_ps(_mm_loadu_ps(c + 12), xyz);
+  __m128 hi = lo;
+  for (int j = 0; j < 3; ++j) {
+    const __m128 col = _mm_and_ps(_mm_loadu_ps(c + 4 * j), xyz);
+    const __m128 a = _mm_mul_ps(col, _mm_set1_ps(box.pmin[j]));
+    const __m128 b = _mm_mul_ps(col, _mm_set1_ps(box.pmax[j]));
+    lo = _mm_add_ps(lo, _mm_min_ps(a, b));
+    hi = _mm_add_ps(hi, _mm_max_ps(a, b));
+  }
+  AABB3a out;
+  _mm_store_ps(out.pmin, lo);
+  _mm_store_ps(out.pmax, hi);
+  return out;
+}
+
+#else
+
+inline bool AABB3a::empty() const {
+  return !(pmin[0] <= pmax[0] && pmin[1] <= pmax[1] && pmin[2] <= pmax[2]);
+}
+
+inline vec3f AABB3a::centroid() const {
+  return vec3f(pmin[0] + pmax[0], pmin[1] + pmax[1], pmin[2] + pmax[2]) *
+         0.5f;
+}
+
+inline vec3f AABB3a::extent() const {
+  return vec3f(pmax[0] - pmin[0], pmax[1] - pmin[1], pmax[2] - pmin[2]);
+}
+
+inline float AABB3a::surfaceArea() const {
+  if (empty()) return 0;
+  const vec3f d = extent();
+  return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+inline bool AABB3a::overlaps(const AABB3a& box) const {
+  for (int i = 0; i < 3; ++i)
+    if (!(pmin[i] <= box.pmax[i] && box.pmin[i] <= pmax[i])) return false;
+  return true;
+}
+
+inline bool AABB3a::contains(const vec3f& p) const {
+  for (int i = 0; i < 3; ++i)
+    if (!(pmin[i] <= p[i] && p[i] <= pmax[i])) return false;
+  return true;
+}
+
+inline bool AABB3a::contains(const AABB3a& box) const {
+  if (box.empty()) return true;
+  for (int i = 0; i < 3; ++i)
+    if (!(pmin[i] <= box.pmin[i] && box.pmax[i] <= pmax[i])) return false;
+  return true;
+}
+
+inline void AABB3a::add(const vec3f& p) {
+  for (int i = 0; i < 3; ++i) {
+    pmin[i] = p[i] < pmin[i] ? p[i] : pmin[i];
+    pmax[i] = p[i] > pmax[i] ? p[i] : pmax[i];
+  }
+}
+
+inline void AABB3a::add(const AABB3a& box) {
+  for (int i = 0; i < 3; ++i) {
+    pmin[i] = box.pmin[i] < pmin[i] ? box.pmin[i] : pmin[i];
+    pmax[i] = box.pmax[i] > pmax[i] ? box.pmax[i] : pmax[i];
+  }
+}
+
+inline AABB3a intersection(const AABB3a& a, const AABB3a& b) {
+  AABB3a box;
+  for (int i = 0; i < 3; ++i) {
+    box.pmin[i] = a.pmin[i] > b.pmin[i] ? a.pmin[i] : b.pmin[i];
+    box.pmax[i] = a.pmax[i] < b.pmax[i] ? a.pmax[i] : b.pmax[i];
+  }
+  return box;
+}
+
+inline AABB3a transform(const mat4f& m, const AABB3a& box) {
+  return AABB3a(transform(m, AABB3f(box)));
+}
+
+#endif
+
+inline AABB3a merge(const AABB3a& a, const AABB3a& b) {
+  AABB3a box = a;
+  box.add(b);
+  return box;
+}
+
+}  // namespace kx
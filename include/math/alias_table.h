@@ -0,0 +1,63 @@
+#pragma once
+
+#include <math/defs.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kx {
+
+/// A discrete distribution sampled in constant time.
+///
+/// The table is Walker's alias method built with Vose's algorithm ("A Linear
+/// Algorithm for Generating Random Numbers with a Given Distribution", IEEE
+/// TSE 1991). Each of the n bins holds the probability of keeping its own
+/// index and an alias for the rest, so drawing an index takes one uniform
+/// number, one table lookup and one comparison, whatever the weights.
+class AliasTable {
+ public:
+  /// Construct an empty table.
+  AliasTable();
+
+  /// Construct the table for n weights.
+  /// The weights must be non-negative with a positive sum. Large tables are
+  /// normalised in parallel (see parallel_for()).
+  AliasTable(const R* weights, std::size_t n);
+
+  /// Construct the table for the given weights.
+  explicit AliasTable(const std::vector<R>& weights);
+
+  /// Return an index drawn with probability proportional to its weight.
+  /// u is a uniformly distributed real in [0,1). The integer part of u*n
+  /// selects the bin and the fractional part chooses between the bin's index
+  /// and its alias.
+  std::uint32_t sample(R u) const {
+    R x = u * R(bins_.size());
+    std::uint32_t i = std::uint32_t(x);
+    if (i >= bins_.size()) i = std::uint32_t(bins_.size() - 1);
+    const Bin& b = bins_[i];
+    return x - R(i) < b.prob ? i : b.alias;
+  }
+
+  /// Return the probability of drawing index i.
+  R pmf(std::uint32_t i) const { return pmf_[i]; }
+
+  /// Return the sum of the weights.
+  R total() const { return total_; }
+
+  /// Return the number of indices.
+  std::size_t size() const { return bins_.size(); }
+
+ private:
+  struct Bin {
+    R prob;               // probability of keeping the bin's own index
+    std::uint32_t alias;  // index drawn otherwise
+  };
+
+  std::vector<Bin> bins_;
+  std::vector<R> pmf_;
+  R total_;
+};
+
+}  // namespace kx
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <math/bvh.h>
+#include <math/triangle2.h>
+#include <math/triangle3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+namespace kx {
+
+/// A mesh to bake into a texture.
+/// Triangle i has the object space vertices positions[i] and the texture
+/// coordinates uvs[i], in normalised texture coordinates (see
+/// rasterization.h). If normals is non-null, normals[i] holds the vertex
+/// normals of triangle i, which are interpolated over it; otherwise the
+/// triangle's face normal, p0p1 x p0p2, is used.
+struct BakeMesh {
+  const Triangle3* positions;
+  const Triangle2* uvs;
+  const Triangle3* normals;
+  std::size_t num_triangles;
+};
+
+/// Settings of the ambient occlusion baker.
+struct AOSettings {
+  /// Dimensions of the output texture, in texels.
+  int width = 512;
+  int height = 512;
+
+  /// Rays cast per texel.
+  int num_rays = 64;
+
+  /// Hits further than this from the surface do not occlude.
+  R max_distance = std::numeric_limits<R>::infinity();
+
+  /// Distance the rays start off the surface, along the normal, so that they
+  /// do not hit the surface they start from.
+  R bias = R(1e-4);
+
+  /// Side of the square tiles the texture is split into, in texels.
+  /// Tiles are the unit of work handed to the worker threads.
+  int tile_size = 32;
+
+  /// Seed selecting the sample sets; different seeds give different noise.
+  std::uint32_t seed = 0;
+};
+
+/// Progress callback of the baker, called with the number of tiles done and
+/// the total number of tiles after each tile. Returning false cancels the
+/// bake. Calls are serialised, so the callback need not be thread-safe.
+using BakeProgress = std::function<bool(std::size_t done, std::size_t total)>;
+
+/// Bake the ambient occlusion of the mesh into a texture.
+///
+/// Each texel whose center lies in one of the mesh's triangles in texture
+/// space (see rasterize_triangle_contained()) is mapped to its point on the
+/// surface, and settings.num_rays rays are cast from there into the
+/// hemisphere around the normal. The rays follow a cosine-weighted
+/// distribution, stratified with a correlated multi-jittered set per texel
+/// (see low_discrepancy.h), so the fraction of rays that escape the occluders
+/// within max_distance estimates the cosine-weighted visibility. The value,
+/// 1 for a fully open texel and 0 for a fully occluded one, is written to
+/// out[y * width + x], with the image space coordinates of rasterization.h.
+/// Texels that no triangle covers are left unchanged; where triangles
+/// overlap in texture space, the one listed first wins.
+///
+/// 'occluders' usually holds the mesh itself, but may hold the whole scene.
+/// Rays are tested with BVH::occluded(). Tiles are baked on the worker
+/// threads of parallel_for(), and the result does not depend on the number
+/// of threads.
+///
+/// Return false if the progress callback cancelled the bake, in which case
+/// only some of the tiles are written.
+bool bake_ambient_occlusion(const BVH& occluders, const BakeMesh& mesh,
+                            const AOSettings& settings, R* out,
+                            const BakeProgress& progress = BakeProgress());
+
+}  // namespace kx
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <math/mat4.h>
+#include <math/quat.h>
+#include <math/spatial.h>
+#include <math/vec3.h>
+
+#include <cstddef>
+#include <vector>
+
+/** @defgroup animation Animation Functions
+ * This module samples keyframed transformation tracks.
+ *
+ * A track holds the translation, rotation and scale keyframes of one joint or
+ * object. Each channel is sorted by time and sampled independently:
+ * translations and scales are interpolated linearly and rotations with nlerp.
+ * Sampling before the first key or after the last key clamps to that key, and
+ * an empty channel yields the identity.
+ *
+ * @{
+ */
+
+namespace kx {
+
+/// A keyframe: the value of a channel at a point in time.
+template <typename T>
+struct Key {
+  R time;
+  T value;
+
+  Key() : time(0) {}
+
+  Key(R time, const T& value) : time(time), value(value) {}
+};
+
+/// The keyframes of a transformation, sorted by time.
+struct Track {
+  std::vector<Key<vec3>> translations;
+  std::vector<Key<quat>> rotations;
+  std::vector<Key<vec3>> scales;
+};
+
+/// Samples many tracks at once.
+///
+/// The sampler remembers, for every track and channel, the key segment used in
+/// the previous call. When playback moves forward the segment is found again by
+/// stepping from the cached one, so sampling costs O(1) per track per frame.
+/// Seeking backwards, or jumping far ahead, falls back to a binary search.
+///
+/// The sampler does not reference the tracks; the ith track passed to sample()
+/// must be the same across calls for the cache to be effective.
+class TrackSampler {
+ public:
+  /// Construct a sampler for the given number of tracks.
+  explicit TrackSampler(std::size_t num_tracks = 0);
+
+  /// Forget the cached key segments.
+  void reset();
+
+  /// Sample the tracks at the given time.
+  /// Outputs are arrays of n elements; any of them may be null.
+  void sample(const Track* tracks, std::size_t n, R time, vec3* translations,
+              quat* rotations, vec3* scales);
+
+  /// Sample the tracks at the given time and compose the results into
+  /// transformation matrices M = T * R * S.
+  void sample(const Track* tracks, std::size_t n, R time, mat4* out);
+
+  /// Sample the tracks at the given time and set the spatials' position and
+  /// orientation. Scale keys are ignored since spatials have no scale.
+  void sample(const Track* tracks, std::size_t n, R time, Spatial* out);
+
+ private:
+  struct Cursor {
+    unsigned translation;
+    unsigned rotation;
+    unsigned scale;
+  };
+
+  /// Make room for the cursors of the given number of tracks.
+  void grow(std::size_t num_tracks);
+
+  std::vector<Cursor> cursors;
+};
+
+}  // namespace kx
+
+/** @} */
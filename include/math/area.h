@@ -3,6 +3,8 @@
 #include <math/quad3.h>
 #include <math/triangle3.h>
 
+#include <cstddef>
+
 namespace kx {
 
 /// Return the area of the triangle.
@@ -11,6 +13,10 @@ R area(const Triangle3&);
 /// Return the area of the triangle defined by p0,p1,p2.
 R area(const vec3& p0, const vec3& p1, const vec3& p2);
 
+/// Compute the areas of n triangles.
+/// This is the batch version of area(const Triangle3&).
+void area(const Triangle3* t, R* out, std::size_t n);
+
 /// Return the area of the quad.
 R area(const Quad3&);
 
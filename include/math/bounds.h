@@ -0,0 +1,40 @@
+#pragma once
+
+#include <math/AABB3.h>
+#include <math/sphere.h>
+
+#include <cstddef>
+
+/** @defgroup bounds Bounding Volumes
+ * This module computes the bounding volumes of large point arrays.
+ *
+ * The functions process points in chunks spread across threads (see
+ * parallel.h) and use SIMD instructions within each chunk, so that on large
+ * arrays they run at close to the speed of reading the points from memory.
+ *
+ * @{
+ */
+
+namespace kx {
+
+/// Return the AABB of the points, or an empty AABB if there are none.
+AABB3 bounding_box(const vec3* points, std::size_t n);
+
+/// Return the AABB of the sphere.
+AABB3 bounding_box(const Sphere& sphere);
+
+/// Return a sphere containing the points, nearly as small as the smallest
+/// one, or a sphere of radius 0 at the origin if there are none.
+///
+/// The sphere is found in three passes over the points. The first finds the
+/// points farthest along the axes and the diagonals of a cube; the smallest
+/// sphere containing these (Welzl's algorithm) is close to the smallest
+/// sphere containing all the points. The second grows that sphere over the
+/// points outside it, as in Ritter's method, and the third shrinks its radius
+/// to the farthest point. The result is typically within a few percent of
+/// the smallest radius.
+Sphere bounding_sphere(const vec3* points, std::size_t n);
+
+}  // namespace kx
+
+/** @} */
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <math/AABB3.h>
+#include <math/ray3.h>
+#include <math/triangle3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kx {
+
+/// A bounding volume hierarchy over a triangle mesh, for ray queries.
+///
+/// The tree is built top-down with the surface area heuristic (SAH), binning
+/// the triangle centroids along the widest axis of each node, and stored in
+/// one array in depth-first order: the first child of a node follows it and
+/// the node holds the index of the second. A query visits O(log n) nodes on
+/// typical meshes, where testing every triangle visits n.
+///
+/// Queries do not modify the tree and may run concurrently.
+class BVH {
+ public:
+  /// Construct an empty hierarchy.
+  BVH() {}
+
+  /// Construct a hierarchy over n triangles.
+  /// The hierarchy keeps a copy of the triangles.
+  BVH(const Triangle3* triangles, std::size_t n);
+
+  /// Construct a hierarchy over the triangles of an indexed mesh: triangle i
+  /// has the vertices indices[3i], indices[3i+1] and indices[3i+2].
+  BVH(const vec3* vertices, const std::uint32_t* indices,
+      std::size_t num_triangles);
+
+  /// Find the closest intersection of the ray with the triangles at a ray
+  /// parameter in [tmin, tmax].
+  /// On a hit, set t to the parameter of the intersection and 'triangle' to
+  /// the index of the triangle hit, and return true.
+  bool intersect(const Ray3&, R tmin, R tmax, R& t,
+                 std::uint32_t& triangle) const;
+
+  /// Return true if the ray hits any triangle at a ray parameter in
+  /// [tmin, tmax].
+  /// This stops at the first hit found, so it is faster than intersect();
+  /// use it for shadow and visibility rays.
+  bool occluded(const Ray3&, R tmin, R tmax) const;
+
+  /// Return the bounding box of the triangles.
+  AABB3 bounds() const;
+
+  /// Return the number of triangles.
+  std::size_t size() const { return triangles_.size(); }
+
+ private:
+  /// A node of the tree. Leaves hold 'count' triangles starting at 'offset';
+  /// inner nodes have count = 0, their second child at 'offset' and were
+  /// split along 'axis'.
+  struct Node {
+    AABB3 box;
+    std::uint32_t offset;
+    std::uint16_t count;
+    std::uint16_t axis;
+  };
+
+  void build();
+
+  std::vector<Node> nodes_;
+  std::vector<Triangle3> triangles_;  // in leaf order
+  std::vector<std::uint32_t> ids_;    // index of each triangle in the input
+};
+
+}  // namespace kx
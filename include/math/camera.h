@@ -1,26 +1,83 @@
 #pragma once
 
+#include <math/frustum.h>
 #include <math/mat4.h>
 #include <math/spatial.h>
 
+#include <cstdint>
+
 #undef near
 #undef far
 
 namespace kx {
 
 /// Camera base class.
+///
+/// The projection, view-projection and inverse matrices and the viewing
+/// frustum are cached. The matrices that depend on the camera's position and
+/// orientation are recomputed when the spatial's version() changes, and the
+/// projection when the parameters() of the projection change, so the public
+/// parameters of the derived cameras may be assigned directly. Like the
+/// spatial's, the caches are filled by const functions (see Spatial).
 struct Camera : public Spatial {
+  KX_MATH_API Camera();
+
   /// Return the camera's projection matrix.
-  KX_MATH_API virtual mat4 projection() const = 0;
+  KX_MATH_API const mat4& projection() const;
 
   /// Return the camera's inverse projection matrix.
-  KX_MATH_API virtual mat4 inverseProjection() const = 0;
+  KX_MATH_API const mat4& inverseProjection() const;
+
+  /// Return the camera's view matrix (from world to camera coordinates).
+  /// This is the spatial's inverse transformation.
+  KX_MATH_API const mat4& view() const { return inverseTransform(); }
+
+  /// Return the camera's view-projection matrix, projection() * view().
+  KX_MATH_API const mat4& viewProjection() const;
+
+  /// Return the camera's inverse view-projection matrix, from normalised
+  /// device coordinates to world coordinates.
+  KX_MATH_API const mat4& inverseViewProjection() const;
+
+  /// Return the camera's viewing frustum, in world coordinates.
+  KX_MATH_API const Frustum& frustum() const;
 
   /// Return the camera's near plane.
   KX_MATH_API virtual R getNear() const = 0;
 
   /// Return the camera's far plane.
   KX_MATH_API virtual R getFar() const = 0;
+
+ protected:
+  /// The maximum number of projection parameters.
+  static const int kMaxParameters = 6;
+
+  /// Write the parameters that determine the projection, at most
+  /// kMaxParameters of them, to 'params'.
+  /// The cached matrices are recomputed when a parameter changes.
+  KX_MATH_API virtual void parameters(R params[kMaxParameters]) const = 0;
+
+  /// Compute the camera's projection matrix.
+  KX_MATH_API virtual mat4 computeProjection() const = 0;
+
+  /// Compute the camera's inverse projection matrix.
+  KX_MATH_API virtual mat4 computeInverseProjection() const = 0;
+
+ private:
+  /// Bring the projection caches, and then the view caches, up to date.
+  void updateProjection() const;
+  void updateView() const;
+
+  mutable bool projection_valid_;
+  mutable R params_[kMaxParameters];
+  mutable mat4 projection_;
+  mutable mat4 inverse_projection_;
+
+  mutable bool view_valid_;
+  mutable std::uint64_t view_version_;
+  mutable mat4 view_projection_;
+  mutable mat4 inverse_view_projection_;
+  mutable Frustum frustum_;
 };
 
 /// A perspective projection camera.
@@ -40,17 +97,25 @@ struct PerspectiveCamera : public Camera {
   KX_MATH_API PerspectiveCamera(R fovy, R aspect, R near, R far)
       : fovy(fovy), aspect(aspect), near(near), far(far) {}
 
-  KX_MATH_API mat4 projection() const override {
+  KX_MATH_API R getNear() const override { return near; }
+
+  KX_MATH_API R getFar() const override { return far; }
+
+ protected:
+  KX_MATH_API void parameters(R params[kMaxParameters]) const override {
+    params[0] = fovy;
+    params[1] = aspect;
+    params[2] = near;
+    params[3] = far;
+  }
+
+  KX_MATH_API mat4 computeProjection() const override {
     return mat4::perspective(fovy, aspect, near, far);
   }
 
-  KX_MATH_API mat4 inverseProjection() const override {
+  KX_MATH_API mat4 computeInverseProjection() const override {
     return mat4::perspectiveInverse(fovy, aspect, near, far);
   }
-
-  KX_MATH_API R getNear() const override { return near; }
-
-  KX_MATH_API R getFar() const override { return far; }
 };
 
 /// An orthographic projection camera.
@@ -68,17 +133,27 @@ struct OrthoCamera : public Camera {
         near(near),
         far(far) {}
 
-  KX_MATH_API mat4 projection() const override {
-    return mat4::ortho(left, right, bottom, top, near, far);
-  }
+  KX_MATH_API R getNear() const override { return near; }
+
+  KX_MATH_API R getFar() const override { return far; }
 
-  KX_MATH_API mat4 inverseProjection() const override {
-    return inverse(projection());
+ protected:
+  KX_MATH_API void parameters(R params[kMaxParameters]) const override {
+    params[0] = left;
+    params[1] = right;
+    params[2] = bottom;
+    params[3] = top;
+    params[4] = near;
+    params[5] = far;
   }
 
-  KX_MATH_API R getNear() const override { return near; }
+  KX_MATH_API mat4 computeProjection() const override {
+    return mat4::ortho(left, right, bottom, top, near, far);
+  }
 
-  KX_MATH_API R getFar() const override { return far; }
+  KX_MATH_API mat4 computeInverseProjection() const override {
+    return inverse(computeProjection());
+  }
 };
 
 }  // namespace kx
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <math/camera.h>
+#include <math/philox.h>
+#include <math/ray3.h>
+#include <math/vec2.h>
+
+namespace kx {
+
+/// Primary rays of a camera, for an image of width by height pixels.
+///
+/// Construction unprojects three corners of the image on the camera's near
+/// and far planes once. For the perspective and orthographic projections,
+/// the near and far points of a pixel's ray are affine functions of the
+/// pixel's coordinates, so each ray then costs a few multiply-adds and a
+/// normalisation, where unprojecting each pixel costs two matrix-vector
+/// products and a division. Rays are generated a SIMD register at a time.
+///
+/// Image points are given in pixels from the top-left corner of the image,
+/// as in rasterization.h, so pixel (x, y) covers [x, x+1] x [y, y+1]. Rays
+/// start on the near plane and have unit directions. The generator is a
+/// snapshot: rebuild it when the camera moves or changes its projection.
+class CameraRays {
+ public:
+  /// Construct a generator for an empty image.
+  CameraRays() : width_(0), height_(0) {}
+
+  /// Construct the generator of the camera's rays for the given image size.
+  CameraRays(const Camera& camera, int width, int height);
+
+  /// Return the ray through the image point (x, y).
+  Ray3 operator()(R x, R y) const;
+
+  /// Generate the rays through the centers of the pixels of the tile with
+  /// the top-left pixel (x0, y0) and size w by h, in row-major order.
+  void generate(int x0, int y0, int w, int h, Ray3Batch& out) const;
+
+  /// Generate the rays of the tile's pixels, each offset from the pixel's
+  /// top-left corner by its jitter in [0,1)^2, for sub-pixel sampling.
+  /// jitter holds w*h offsets in the order of the rays, e.g. from a sample
+  /// set of low_discrepancy.h.
+  void generate(int x0, int y0, int w, int h, const vec2* jitter,
+                Ray3Batch& out) const;
+
+  /// Generate the rays of the tile's pixels, jittered uniformly with numbers
+  /// drawn from the generator.
+  void generate(int x0, int y0, int w, int h, Philox4x32& gen,
+                Ray3Batch& out) const;
+
+  /// Generate the rays of the whole image.
+  /// These split the image's rows over the worker threads (see
+  /// parallel_for()).
+  void generate(Ray3Batch& out) const;
+  void generate(const vec2* jitter, Ray3Batch& out) const;
+  void generate(Philox4x32& gen, Ray3Batch& out) const;
+
+  /// Return the image's width.
+  int width() const { return width_; }
+
+  /// Return the image's height.
+  int height() const { return height_; }
+
+ private:
+  int width_;
+  int height_;
+
+  // The near point and the unnormalised direction of the ray through the
+  // image point (x, y) are p + x * p_dx + y * p_dy and d + x * d_dx + y * d_dy.
+  vec3 p_, p_dx_, p_dy_;
+  vec3 d_, d_dx_, d_dy_;
+};
+
+}  // namespace kx
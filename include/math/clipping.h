@@ -0,0 +1,94 @@
+#pragma once
+
+#include <math/quad3.h>
+#include <math/triangle3.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kx {
+
+struct AxisPlane;
+struct Frustum;
+struct Plane;
+
+/// A convex 3D polygon with up to kCapacity points, stored inline.
+///
+/// Clipping a convex polygon of n points against a plane leaves at most n+1
+/// points, so a triangle clipped against a frustum has at most 9 points and
+/// a quad 10. Polygons live on the stack and clipping allocates nothing.
+struct Polygon3 {
+  static const int kCapacity = 16;
+
+  vec3 points[kCapacity];
+  int size;
+
+  /// Construct an empty polygon.
+  Polygon3() : size(0) {}
+
+  /// Construct the polygon of a triangle.
+  explicit Polygon3(const Triangle3& t) : size(3) {
+    points[0] = t.p0;
+    points[1] = t.p1;
+    points[2] = t.p2;
+  }
+
+  /// Construct the polygon of a quad.
+  explicit Polygon3(const Quad3& q) : size(4) {
+    points[0] = q.p0;
+    points[1] = q.p1;
+    points[2] = q.p2;
+    points[3] = q.p3;
+  }
+
+  /// Return true if the polygon has no points.
+  bool empty() const { return size == 0; }
+};
+
+// Clipping
+//
+// The functions below clip polygons with the Sutherland-Hodgman algorithm.
+// They keep the part of the polygon in front of a plane, where its distance
+// (see distanceTo()) is >= 0, and the part inside a frustum, behind its
+// outward-facing planes as in intersect(const Frustum&, const AABB3&). Points
+// are kept in order, and new points are interpolated linearly along the
+// clipped edges. The input polygon must leave room for the points added: one
+// per plane.
+//
+// 'in' and 'out' must be different polygons. The functions return false if
+// nothing remains of the polygon.
+
+/// Clip the polygon against the plane.
+bool clip(const Polygon3& in, const Plane&, Polygon3& out);
+
+/// Clip the polygon against the axis-aligned plane.
+bool clip(const Polygon3& in, const AxisPlane&, Polygon3& out);
+
+/// Clip the polygon against the frustum.
+bool clip(const Polygon3& in, const Frustum&, Polygon3& out);
+
+/// Split the polygon along the plane into its front and back parts.
+/// Points on the plane go to both parts.
+void split(const Polygon3& in, const Plane&, Polygon3& front, Polygon3& back);
+
+/// Split the polygon along the axis-aligned plane into its front and back
+/// parts.
+/// Points on the plane go to both parts.
+void split(const Polygon3& in, const AxisPlane&, Polygon3& front,
+           Polygon3& back);
+
+/// The maximum number of triangles a triangle is clipped into by a frustum.
+const int kMaxClippedTriangles = 7;
+
+/// Clip n triangles against the frustum and write the clipped triangles to
+/// out, which must have room for kMaxClippedTriangles * n of them.
+/// Each clipped polygon is triangulated as a fan around its first point.
+/// Triangles entirely inside the frustum are copied unchanged, and those
+/// entirely outside one of its planes are dropped without clipping. If
+/// 'source' is non-null, source[i] is set to the index of the input triangle
+/// out[i] came from, e.g. to interpolate its vertex attributes.
+/// Return the number of triangles written.
+std::size_t clip(const Triangle3* in, std::size_t n, const Frustum&,
+                 Triangle3* out, std::uint32_t* source = nullptr);
+
+}  // namespace kx
@@ -4,7 +4,16 @@
 // Configuration macros:
 //
 // KX_MATH_FLOAT
-//   - Use floats instead of doubles for real types (R).
+//   - Use floats instead of doubles for real types (R). This only changes the
+//     default precision; the vector and matrix types are templates, and the
+//     aliases in fwd.h give access to both precisions in any build.
+//
+// KX_MATH_INLINE
+//   - Define the small primitives that are called in inner loops (matrix
+//     element and column access, vec4 arithmetic, the AABB3 tests and
+//     updates) in the headers instead of the library, so that they can be
+//     inlined without link-time optimisation. Must be set consistently for
+//     the library and its users; the CMake option of the same name does this.
 //
 // NOMINMAX
 //   - Necessary on Windows to disable min() and max() macros.
@@ -32,6 +41,13 @@ using R = double;
 #define KX_MATH_API
 #endif
 
+// Linkage of the primitives in the .inl files (see KX_MATH_INLINE).
+#ifdef KX_MATH_INLINE
+#define KX_MATH_INL inline
+#else
+#define KX_MATH_INL
+#endif
+
 #define PI 3.14159265359f
 #define INV_PI 0.31830988618f
 
@@ -48,13 +64,10 @@ using R = double;
 // inline R tan (R x) { return std::tan(x); }
 // inline R pow (R x, R e) { return std::pow(x,e); }
 // inline R sqrt (R x) { return std::sqrt(x); }
-#ifdef KX_MATH_FLOAT
-inline R min(R a, R b) { return std::fminf(a, b); }
-inline R max(R a, R b) { return std::fmaxf(a, b); }
-#else   // doubles
-inline R min(R a, R b) { return fmin(a, b); }
-inline R max(R a, R b) { return fmax(a, b); }
-#endif  // KX_MATH_FLOAT
+inline float min(float a, float b) { return std::fmin(a, b); }
+inline float max(float a, float b) { return std::fmax(a, b); }
+inline double min(double a, double b) { return fmin(a, b); }
+inline double max(double a, double b) { return fmax(a, b); }
 
 #else  // device code
 
@@ -64,29 +77,51 @@ inline __device__ R cos(R x) { return cosf(x); }
 inline __device__ R tan(R x) { return tanf(x); }
 inline __device__ R pow(R x, R e) { return powf(x, e); }
 inline __device__ R sqrt(R x) { return sqrtf(x); }
-inline __device__ R min(R a, R b) { return fminf(a, b); }
-inline __device__ R max(R a, R b) { return fmaxf(a, b); }
-#else   // doubles
-inline __device__ R min(R a, R b) { return fmin(a, b); }
-inline __device__ R max(R a, R b) { return fmax(a, b); }
 #endif  // KX_MATH_FLOAT
+inline __device__ float min(float a, float b) { return fminf(a, b); }
+inline __device__ float max(float a, float b) { return fmaxf(a, b); }
+inline __device__ double min(double a, double b) { return fmin(a, b); }
+inline __device__ double max(double a, double b) { return fmax(a, b); }
 
 #endif  // __CUDA_ARCH__
 
-inline KX_MATH_API R abs(R x) { return x >= 0.0 ? x : -x; }
-inline KX_MATH_API R clamp(R x, R low, R high) {
+// Scalar functions are overloaded for float and double so that they serve
+// the vector and matrix types of both precisions (see fwd.h).
+
+constexpr KX_MATH_API float abs(float x) { return x >= 0.0f ? x : -x; }
+constexpr KX_MATH_API double abs(double x) { return x >= 0.0 ? x : -x; }
+inline KX_MATH_API float clamp(float x, float low, float high) {
   return max(low, min(high, x));
 }
-inline KX_MATH_API R sq(R x) { return x * x; }
-inline KX_MATH_API R sign(R x) {
-  if (x < 0)
-    return -1;
-  else if (x > 0)
-    return 1;
-  else
-    return 0;
+inline KX_MATH_API double clamp(double x, double low, double high) {
+  return max(low, min(high, x));
+}
+constexpr KX_MATH_API float sq(float x) { return x * x; }
+constexpr KX_MATH_API double sq(double x) { return x * x; }
+constexpr KX_MATH_API float sign(float x) {
+  return x < 0 ? -1 : (x > 0 ? 1 : 0);
+}
+constexpr KX_MATH_API double sign(double x) {
+  return x < 0 ? -1 : (x > 0 ? 1 : 0);
 }
-inline KX_MATH_API R lerp(R a, R b, R t) { return a + (b - a) * t; }
+constexpr KX_MATH_API float lerp(float a, float b, float t) {
+  return a + (b - a) * t;
+}
+constexpr KX_MATH_API double lerp(double a, double b, double t) {
+  return a + (b - a) * t;
+}
+
+/// Keep a scalar parameter out of template argument deduction.
+/// Functions on vectors take their scalar arguments as NoDeduce<T>, so that
+/// the vector argument alone determines T and any arithmetic type converts,
+/// as in 2 * v.
+template <typename T>
+struct Identity {
+  using type = T;
+};
+
+template <typename T>
+using NoDeduce = typename Identity<T>::type;
 
 #ifdef KX_MATH_FLOAT
 #define R_MAX DBL_MAX
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <math/fwd.h>
 #include <math/vec2.h>
 
 namespace kx {
@@ -8,6 +9,9 @@ namespace kx {
 /// This returns the determinant:
 ///   | a.x b.x |
 ///   | a.y b.y |
-inline R det(const vec2& a, const vec2& b) { return a.x * b.y - a.y * b.x; }
+template <typename T>
+inline T det(const vec2T<T>& a, const vec2T<T>& b) {
+  return a.x * b.y - a.y * b.x;
+}
 
 }  // namespace kx
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <math/quat.h>
+#include <math/vec3.h>
+
+namespace kx {
+
+/// A unit dual quaternion representing a rigid transformation.
+/// The transformation rotates by the real part and then translates.
+struct dualquat {
+  quat real;  ///< Rotation.
+  quat dual;  ///< Translation, encoded as 0.5 * t * real.
+
+  /// Construct the identity transformation.
+  dualquat() : real(1, 0, 0, 0), dual(0, 0, 0, 0) {}
+
+  /// Construct a dual quaternion from its real and dual parts.
+  dualquat(const quat& real, const quat& dual) : real(real), dual(dual) {}
+
+  /// Construct a rigid transformation from a rotation and a translation.
+  /// \param rotation    A unit quaternion.
+  /// \param translation The translation applied after the rotation.
+  dualquat(const quat& rotation, const vec3& translation);
+};
+
+/// Compose two rigid transformations: (a * b)(p) = a(b(p)).
+dualquat operator*(const dualquat& a, const dualquat& b);
+
+/// Return the dual quaternion's conjugate, which for a unit dual quaternion is
+/// the inverse transformation.
+dualquat conj(const dualquat& dq);
+
+/// Normalise the dual quaternion so that its real part has unit length.
+dualquat normalise(const dualquat& dq);
+
+/// Return the translation component of the unit dual quaternion.
+vec3 translation(const dualquat& dq);
+
+/// Transform the point by the unit dual quaternion.
+vec3 transform(const dualquat& dq, const vec3& p);
+
+}  // namespace kx
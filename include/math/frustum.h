@@ -1,5 +1,6 @@
 #pragma once
 
+#include <math/fwd.h>
 #include <math/plane.h>
 
 namespace kx {
@@ -24,8 +25,12 @@ struct Frustum {
         near(near),
         far(far) {}
 
-  /// Extract a viewing frustum from the camera's view-projection matrix.
+  /// Return the camera's viewing frustum.
+  /// This copies the frustum cached by the camera (see Camera::frustum()).
   KX_MATH_API Frustum(const Camera&);
+
+  /// Extract a viewing frustum from a view-projection matrix.
+  KX_MATH_API explicit Frustum(const mat4& view_projection);
 };
 
 }  // namespace kx
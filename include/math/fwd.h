@@ -0,0 +1,59 @@
+#pragma once
+
+#include <math/defs.h>
+
+// Forward declarations of the core types.
+//
+// The vector, matrix, quaternion and bounding box types are templated on their
+// scalar type, so that single-precision bulk data and double-precision
+// computations can be mixed in one program. The unsuffixed aliases use the
+// configurable real type R and are what the rest of the library works with;
+// the 'f' and 'd' aliases name the two precisions explicitly.
+
+namespace kx {
+
+template <typename T>
+struct vec2T;
+template <typename T>
+struct vec3T;
+template <typename T>
+struct vec4T;
+template <typename T>
+class mat3T;
+template <typename T>
+class mat4T;
+template <typename T>
+struct quatT;
+template <typename T>
+struct AABB2T;
+template <typename T>
+struct AABB3T;
+
+using vec2 = vec2T<R>;
+using vec3 = vec3T<R>;
+using vec4 = vec4T<R>;
+using mat3 = mat3T<R>;
+using mat4 = mat4T<R>;
+using quat = quatT<R>;
+using AABB2 = AABB2T<R>;
+using AABB3 = AABB3T<R>;
+
+using vec2f = vec2T<float>;
+using vec3f = vec3T<float>;
+using vec4f = vec4T<float>;
+using mat3f = mat3T<float>;
+using mat4f = mat4T<float>;
+using quatf = quatT<float>;
+using AABB2f = AABB2T<float>;
+using AABB3f = AABB3T<float>;
+
+using vec2d = vec2T<double>;
+using vec3d = vec3T<double>;
+using vec4d = vec4T<double>;
+using mat3d = mat3T<double>;
+using mat4d = mat4T<double>;
+using quatd = quatT<double>;
+using AABB2d = AABB2T<double>;
+using AABB3d = AABB3T<double>;
+
+}  // namespace kx
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <math/AABB3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kx {
+
+struct Frustum;
+struct Ray3;
+struct Sphere;
+
+/// A uniform grid over moving objects, hashed into a fixed number of buckets,
+/// for overlap queries.
+///
+/// Each object is stored in the cell holding its center, so inserting,
+/// moving and removing an object take constant time, and the grid covers
+/// unbounded space. A query visits the cells its bounds overlap, widened by
+/// the largest half-size of the objects inserted; it tests every object
+/// instead when that is cheaper. The grid suits many objects of similar size,
+/// with cells about as large as the objects; for objects of widely varying
+/// size, use LooseOctree.
+///
+/// Objects are identified by the handles insert() returns. Objects live in a
+/// pool that recycles the entries of removed ones, so once the pool has grown
+/// no operation allocates. Queries append the handles of the objects whose
+/// bounds overlap the query to 'out', in no particular order; they do not
+/// modify the grid and may run concurrently.
+class HashGrid {
+ public:
+  /// Construct a grid with the given cell size and number of buckets, which
+  /// is rounded up to a power of two.
+  explicit HashGrid(R cell_size, std::size_t num_buckets = 4096);
+
+  /// Reserve storage for n objects.
+  void reserve(std::size_t n);
+
+  /// Insert an object with the given bounds and return its handle.
+  std::uint32_t insert(const AABB3& bounds);
+  std::uint32_t insert(const Sphere& bounds);
+
+  /// Update the bounds of the object.
+  void move(std::uint32_t handle, const AABB3& bounds);
+  void move(std::uint32_t handle, const Sphere& bounds);
+
+  /// Remove the object. Its handle may be reused by later insertions.
+  void remove(std::uint32_t handle);
+
+  /// Remove all objects.
+  void clear();
+
+  /// Return the bounds of the object.
+  const AABB3& bounds(std::uint32_t handle) const {
+    return objects_[handle].bounds;
+  }
+
+  /// Return the number of objects.
+  std::size_t size() const { return size_; }
+
+  /// Find the objects overlapping the box.
+  void query(const AABB3&, std::vector<std::uint32_t>& out) const;
+
+  /// Find the objects overlapping the sphere.
+  void query(const Sphere&, std::vector<std::uint32_t>& out) const;
+
+  /// Find the objects inside or intersecting the frustum.
+  void query(const Frustum&, std::vector<std::uint32_t>& out) const;
+
+  /// Find the objects whose bounds the ray crosses at a ray parameter in
+  /// [0, tmax].
+  void query(const Ray3&, R tmax, std::vector<std::uint32_t>& out) const;
+
+ private:
+  /// An object, or a free entry of the pool linked through 'next', with no
+  /// bucket. Objects in the same bucket form a list.
+  struct Object {
+    AABB3 bounds;
+    std::int32_t cell[3];
+    std::uint32_t bucket;
+    std::uint32_t prev, next;
+  };
+
+  void cell_of(const AABB3& bounds, std::int32_t cell[3]) const;
+  std::uint32_t bucket(const std::int32_t cell[3]) const;
+  void link(std::uint32_t handle);
+  void unlink(std::uint32_t handle);
+
+  template <typename Overlaps>
+  void collect(const AABB3& range, Overlaps overlaps,
+               std::vector<std::uint32_t>& out) const;
+
+  R inv_cell_size_;
+  vec3 max_half_size_;  // of the objects inserted since the last clear()
+  std::size_t size_;
+  std::vector<std::uint32_t> buckets_;  // the first object of each bucket
+  std::vector<Object> objects_;
+  std::uint32_t free_object_;
+};
+
+}  // namespace kx
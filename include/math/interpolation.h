@@ -5,6 +5,8 @@
 #include <math/triangle2.h>
 #include <math/triangle3.h>
 
+#include <cstddef>
+
 namespace kx {
 
 /// Interpolate the triangle's vertices using the given barycentric coordinates.
@@ -22,6 +24,12 @@ inline vec3 interpolate(const Triangle3& t, const vec2& st) {
   return interpolate(t.p0, t.p1, t.p2, st);
 }
 
+/// Interpolate n triangles' vertices using the given barycentric coordinates.
+/// This is the array version of interpolate() and evaluates in a single pass
+/// over the arrays (see vec_expr.h).
+void interpolate(const vec3* p0, const vec3* p1, const vec3* p2,
+                 const vec2* st, vec3* out, std::size_t n);
+
 /// Interpolate the quad's vertices using the given barycentric coordinates.
 /// The algorithm splits the quad into two triangles, identifies which of the
 /// two triangles contains the point, and then performs a triangle interpolation
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <math/defs.h>
+#include <math/fwd.h>
 
 // Definitions:
 //
@@ -15,7 +16,6 @@
 
 namespace kx {
 
-struct AABB3;
 struct AxisPlane;
 struct Frustum;
 struct Plane;
@@ -24,8 +24,6 @@ struct Ray3;
 struct Sphere;
 struct Triangle2;
 struct Triangle3;
-struct vec3;
-struct vec2;
 
 enum class Side { front, back, zero };
 
@@ -69,6 +67,16 @@ KX_MATH_API bool intersect(const Ray3&, const Plane&, R& t);
 /// Intersect a ray and an AABB.
 KX_MATH_API bool intersect(const Ray3&, const AABB3&, R& tmin, R& tmax);
 
+/// Intersect a ray, given by its position and the inverse of its direction,
+/// and an AABB: narrow [tmin, tmax] to the parameters at which the ray is in
+/// the box, and return false if none are left.
+/// Inverting the direction once per ray makes this the faster test when a ray
+/// is tested against many boxes, as in tree traversals. A zero direction
+/// component gives an infinite inverse; the comparisons are ordered so that
+/// the resulting NaNs leave the interval unchanged.
+KX_MATH_API bool intersect(const vec3& pos, const vec3& inv_dir, const AABB3&,
+                           R& tmin, R& tmax);
+
 /// Intersect a ray and a sphere.
 KX_MATH_API bool intersect(const Ray3&, const Sphere&, R& tmin, R& tmax);
 
@@ -82,6 +90,10 @@ KX_MATH_API bool intersect(const Ray3&, const Sphere&, R& tmin, R& tmax);
 /// tau is used in comparing against 0 and should be a relatively small value.
 KX_MATH_API bool intersect(const Ray3&, const Triangle3&, R& t, R eps, R tau);
 
+/// A value of eps for the ray-triangle tests above that keeps rays through an
+/// edge shared by two triangles of a mesh from slipping between them.
+constexpr R kMeshEdgeEps = R(1e-7);
+
 /// Intersect a ray and a triangle.
 KX_MATH_API bool intersect(const Ray3&, const vec3&, const vec3&, const vec3&,
                            R& t, R eps, R tau);
@@ -100,6 +112,13 @@ KX_MATH_API bool intersect(const Ray3&, const AABB3&);
 /// Test for intersection between a ray and a sphere.
 KX_MATH_API bool intersect(const Ray3&, const Sphere&);
 
+/// Test for intersection between two AABBs.
+/// Boxes that touch intersect.
+KX_MATH_API bool intersect(const AABB3&, const AABB3&);
+
+/// Test for intersection between a sphere and an AABB.
+KX_MATH_API bool intersect(const Sphere&, const AABB3&);
+
 /// Return true if the frustum contains the point, false otherwise.
 KX_MATH_API bool contains(const Frustum&, const vec3& p);
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <math/AABB3.h>
+#include <math/ray3.h>
+#include <math/triangle3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kx {
+
+/// A kd-tree over a triangle mesh, for ray queries.
+///
+/// The tree splits space with axis-aligned planes chosen by the surface area
+/// heuristic (SAH) over all the triangles' bounds, so a triangle straddling a
+/// plane is referenced by both children, clipped to each. Construction sorts
+/// the bounds' events once and keeps them sorted while splitting, for
+/// O(n log n) time overall. Nodes take 8 bytes and the tree's depth is
+/// bounded, so traversal uses a small fixed-size stack.
+///
+/// Compared with BVH, the tree adapts better to the large, axis-aligned
+/// triangles of architectural scenes, but takes longer to build. Queries do
+/// not modify the tree and may run concurrently.
+class KdTree {
+ public:
+  /// Construct an empty tree.
+  KdTree() {}
+
+  /// Construct a tree over n triangles.
+  /// The tree keeps a copy of the triangles.
+  KdTree(const Triangle3* triangles, std::size_t n);
+
+  /// Construct a tree over the triangles of an indexed mesh: triangle i has
+  /// the vertices indices[3i], indices[3i+1] and indices[3i+2].
+  KdTree(const vec3* vertices, const std::uint32_t* indices,
+         std::size_t num_triangles);
+
+  /// Find the closest intersection of the ray with the triangles at a ray
+  /// parameter in [tmin, tmax], with tmin >= 0.
+  /// On a hit, set t to the parameter of the intersection and 'triangle' to
+  /// the index of the triangle hit, and return true.
+  bool intersect(const Ray3&, R tmin, R tmax, R& t,
+                 std::uint32_t& triangle) const;
+
+  /// Return true if the ray hits any triangle at a ray parameter in
+  /// [tmin, tmax], with tmin >= 0.
+  /// This stops at the first hit found, so it is faster than intersect();
+  /// use it for shadow and visibility rays.
+  bool occluded(const Ray3&, R tmin, R tmax) const;
+
+  /// Return the bounding box of the triangles.
+  AABB3 bounds() const { return bounds_; }
+
+  /// Return the number of triangles.
+  std::size_t size() const { return triangles_.size(); }
+
+ private:
+  /// A node of the tree, in 8 bytes. The low two bits of 'flags' hold the
+  /// split axis of an inner node, or 3 for a leaf; the other bits hold the
+  /// index of an inner node's second child, above the plane, or the number of
+  /// triangles of a leaf. The first child of an inner node follows it.
+  struct Node {
+    union {
+      float split;          ///< Inner nodes: the position of the plane.
+      std::uint32_t first;  ///< Leaves: the offset of the triangles in ids_.
+    };
+    std::uint32_t flags;
+
+    bool leaf() const { return (flags & 3) == 3; }
+    int axis() const { return int(flags & 3); }
+    std::uint32_t above() const { return flags >> 2; }
+    std::uint32_t count() const { return flags >> 2; }
+  };
+
+  void build();
+
+  AABB3 bounds_;
+  std::vector<Node> nodes_;
+  std::vector<Triangle3> triangles_;
+  std::vector<std::uint32_t> ids_;  // the triangles of each leaf
+};
+
+}  // namespace kx
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <math/AABB3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kx {
+
+struct Frustum;
+struct Ray3;
+struct Sphere;
+
+/// A loose octree over moving objects, for overlap queries.
+///
+/// Each cell's bounds are twice the size of its place in the octree, so an
+/// object fits in the cell at the depth matching its size that holds its
+/// center. Inserting an object finds that cell in one descent, without
+/// testing any bounds, and moving an object within its cell only updates its
+/// bounds, which makes the tree suited to thousands of objects that move
+/// every frame. Objects centered outside the world bounds go to the root.
+///
+/// Objects are identified by the handles insert() returns. Objects and cells
+/// live in pools that recycle the entries of removed ones, so once the pools
+/// have grown no operation allocates. Queries append the handles of the
+/// objects whose bounds overlap the query to 'out', in no particular order;
+/// they do not modify the tree and may run concurrently.
+class LooseOctree {
+ public:
+  /// The maximum depth of a tree.
+  static const int kMaxDepth = 16;
+
+  /// Construct a tree over the world bounds, with cells down to max_depth.
+  explicit LooseOctree(const AABB3& world, int max_depth = 8);
+
+  /// Reserve storage for n objects.
+  void reserve(std::size_t n);
+
+  /// Insert an object with the given bounds and return its handle.
+  std::uint32_t insert(const AABB3& bounds);
+  std::uint32_t insert(const Sphere& bounds);
+
+  /// Update the bounds of the object.
+  void move(std::uint32_t handle, const AABB3& bounds);
+  void move(std::uint32_t handle, const Sphere& bounds);
+
+  /// Remove the object. Its handle may be reused by later insertions.
+  void remove(std::uint32_t handle);
+
+  /// Remove all objects.
+  void clear();
+
+  /// Return the bounds of the object.
+  const AABB3& bounds(std::uint32_t handle) const {
+    return objects_[handle].bounds;
+  }
+
+  /// Return the number of objects.
+  std::size_t size() const { return size_; }
+
+  /// Find the objects overlapping the box.
+  void query(const AABB3&, std::vector<std::uint32_t>& out) const;
+
+  /// Find the objects overlapping the sphere.
+  void query(const Sphere&, std::vector<std::uint32_t>& out) const;
+
+  /// Find the objects inside or intersecting the frustum.
+  void query(const Frustum&, std::vector<std::uint32_t>& out) const;
+
+  /// Find the objects whose bounds the ray crosses at a ray parameter in
+  /// [0, tmax].
+  void query(const Ray3&, R tmax, std::vector<std::uint32_t>& out) const;
+
+ private:
+  /// A cell of the tree. Its objects form a list through Object::next, and
+  /// 'count' counts the objects in its subtree; empty cells are freed.
+  struct Node {
+    AABB3 loose;  // the cell's bounds, twice its size
+    std::uint32_t children[8];
+    std::uint32_t parent;
+    std::uint32_t first;  // first object, or the next free node
+    std::uint32_t count;
+    std::uint8_t depth;
+    std::uint8_t slot;  // index in the parent's children
+  };
+
+  /// An object, or a free entry of the pool linked through 'next'.
+  struct Object {
+    AABB3 bounds;
+    std::uint32_t node;
+    std::uint32_t prev, next;
+  };
+
+  int depth(const AABB3& bounds) const;
+  bool fits(const AABB3& bounds, std::uint32_t node) const;
+  std::uint32_t cell(const AABB3& bounds);
+  std::uint32_t child(std::uint32_t node, int slot);
+  void link(std::uint32_t handle, std::uint32_t node);
+  void unlink(std::uint32_t handle);
+
+  template <typename Overlaps>
+  void collect(Overlaps overlaps, std::vector<std::uint32_t>& out) const;
+
+  vec3 origin_;  // the minimum corner of the world's cube
+  R extent_;     // the size of the world's cube
+  int max_depth_;
+  std::size_t size_;
+  std::vector<Node> nodes_;
+  std::vector<Object> objects_;
+  std::uint32_t free_node_;
+  std::uint32_t free_object_;
+};
+
+}  // namespace kx
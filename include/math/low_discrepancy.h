@@ -0,0 +1,204 @@
+#pragma once
+
+#include <math/vec2.h>
+
+#include <cstdint>
+#include <vector>
+
+/** @addtogroup sampling
+ * Low-discrepancy sequences and stratified sample sets.
+ *
+ * The generators below produce points in the unit square that cover it more
+ * evenly than pseudo-random points, so Monte Carlo estimates converge faster
+ * (quasi-Monte Carlo). The points can be mapped to other domains with the
+ * (u,v) functions of sampling.h, e.g. sample_hemisphere(square_samples, e).
+ *
+ * @{
+ */
+
+namespace kx {
+
+/// Return the radical inverse of i in the given base: the digits of i
+/// mirrored about the radix point.
+/// This is the ith point of the van der Corput sequence in that base.
+R radical_inverse(unsigned base, std::uint64_t i);
+
+/// The 2D Sobol sequence.
+///
+/// The first dimension is the van der Corput sequence in base 2 and the
+/// second is Sobol's sequence for the primitive polynomial x + 1; together
+/// they form a (0,2)-sequence, so every block of 2^k points is stratified in
+/// all elementary intervals of area 2^-k. Successive points are generated in
+/// Gray code order with one XOR per dimension.
+///
+/// The points can be Owen-scrambled with a seed. Scrambling keeps the
+/// stratification, but decorrelates sequences that use different seeds and
+/// removes the structured error of the raw sequence. The hash-based
+/// scrambling of Burley ("Practical Hash-based Owen Scrambling", JCGT 2020)
+/// costs a few integer operations per point.
+class Sobol {
+ public:
+  /// Construct the unscrambled sequence.
+  Sobol();
+
+  /// Construct a sequence Owen-scrambled with the given seed.
+  explicit Sobol(std::uint32_t seed);
+
+  /// Return the next point.
+  vec2 next();
+
+  /// Move to the ith point of the sequence.
+  void seek(std::uint32_t i);
+
+  /// Return the index of the next point.
+  std::uint32_t index() const { return index_; }
+
+ private:
+  bool scramble_;
+  std::uint32_t seed_[2];
+  std::uint32_t index_;
+  std::uint32_t x_[2];  // unscrambled point index_
+};
+
+/// The 2D Halton sequence.
+///
+/// Each dimension is the radical inverse of the point's index in its own
+/// prime base. The digits of the index are kept and incremented in place,
+/// so the next point takes amortized constant time and is exact: it equals
+/// the radical_inverse() of the index.
+class Halton {
+ public:
+  /// Construct the sequence with the given bases, which should be coprime.
+  explicit Halton(unsigned base0 = 2, unsigned base1 = 3);
+
+  /// Return the next point.
+  vec2 next();
+
+  /// Move to the ith point of the sequence.
+  void seek(std::uint64_t i);
+
+  /// Return the index of the next point.
+  std::uint64_t index() const { return index_; }
+
+ private:
+  /// The digits of the index in one base, least significant first, and the
+  /// integer with the same digits reversed over a fixed number of places.
+  struct Counter {
+    unsigned base;
+    int num_digits;
+    std::uint64_t scale;      // base^num_digits
+    std::uint64_t place[64];  // base^(num_digits-1-k)
+    unsigned char digits[64];
+    std::uint64_t reversed;
+
+    void init(unsigned base);
+    void seek(std::uint64_t i);
+    void increment();
+  };
+
+  std::uint64_t index_;
+  Counter counter_[2];
+};
+
+/// Return the first num_samples points of the Sobol sequence.
+std::vector<vec2> sample_sobol(int num_samples);
+
+/// Return the first num_samples points of the Sobol sequence, Owen-scrambled
+/// with the given seed.
+std::vector<vec2> sample_sobol(int num_samples, std::uint32_t seed);
+
+/// Return the first num_samples points of the Halton sequence in bases 2
+/// and 3.
+std::vector<vec2> sample_halton(int num_samples);
+
+//
+// Stratified sample sets
+//
+// The sets below are computed with hash functions instead of a random number
+// generator (Kensler, "Correlated Multi-Jittered Sampling", Pixar technical
+// memo 13-01, 2013), so any sample of any set is available in constant time
+// with no state or precomputation. The set is selected by a 32-bit pattern
+// number, e.g. a hash of the pixel coordinates, and the sets are immutable:
+// a per-pixel sampler can be built on the fly and queried from any number of
+// threads.
+//
+// The samples of a set come in random order, so the first k samples of a set
+// are a random subset rather than a corner of it.
+//
+
+/// Return element i of a random permutation of [0,n), selected by 'pattern'.
+/// This takes a few integer operations per call for any n.
+std::uint32_t permute(std::uint32_t i, std::uint32_t n, std::uint32_t pattern);
+
+/// A jittered grid: one random sample in each cell of an nx by ny grid.
+class StratifiedSet {
+ public:
+  StratifiedSet(std::uint32_t nx, std::uint32_t ny, std::uint32_t pattern = 0);
+
+  /// Return sample i, for i < size().
+  vec2 operator[](std::uint32_t i) const;
+
+  std::uint32_t size() const { return nx_ * ny_; }
+
+ private:
+  std::uint32_t nx_;
+  std::uint32_t ny_;
+  std::uint32_t pattern_;
+};
+
+/// N-rooks (Latin hypercube) samples: each of the n columns and each of the
+/// n rows of the n by n grid holds exactly one sample.
+class NRooksSet {
+ public:
+  explicit NRooksSet(std::uint32_t n, std::uint32_t pattern = 0);
+
+  /// Return sample i, for i < size().
+  vec2 operator[](std::uint32_t i) const;
+
+  std::uint32_t size() const { return n_; }
+
+ private:
+  std::uint32_t n_;
+  std::uint32_t pattern_;
+};
+
+/// Correlated multi-jittered samples.
+///
+/// The samples are stratified both in the cells of an m by n grid and in the
+/// rows and columns of the finer mn by mn grid, like N-rooks. The column and
+/// row offsets are shuffled the same way in every row and column of the
+/// coarse grid, which lowers the variance further.
+class CMJSet {
+ public:
+  /// Construct a set of num_samples samples on the smallest near-square grid
+  /// that holds them. The samples of a random subset of the grid cells,
+  /// different for each pattern, are dropped.
+  explicit CMJSet(std::uint32_t num_samples, std::uint32_t pattern = 0);
+
+  /// Construct the set of m by n samples.
+  CMJSet(std::uint32_t m, std::uint32_t n, std::uint32_t pattern);
+
+  /// Return sample i, for i < size().
+  vec2 operator[](std::uint32_t i) const;
+
+  std::uint32_t size() const { return size_; }
+
+ private:
+  std::uint32_t m_;
+  std::uint32_t n_;
+  std::uint32_t size_;
+  std::uint32_t pattern_;
+};
+
+/// Return the samples of a jittered nx by ny grid.
+std::vector<vec2> sample_stratified(int nx, int ny, std::uint32_t pattern = 0);
+
+/// Return num_samples N-rooks samples.
+std::vector<vec2> sample_n_rooks(int num_samples, std::uint32_t pattern = 0);
+
+/// Return num_samples correlated multi-jittered samples.
+std::vector<vec2> sample_cmj(int num_samples, std::uint32_t pattern = 0);
+
+}  // namespace kx
+
+/** @} */
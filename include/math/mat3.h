@@ -1,109 +1,138 @@
 #pragma once
 
+#include <math/fwd.h>
 #include <math/vec3.h>
 
 namespace kx {
 
-class mat4;
-
 /// A column-major 3x3 matrix.
-class mat3 {
-  R val[3][3];
+template <typename T>
+class mat3T {
+  T val[3][3];
 
  public:
   /// Construct the identity matrix.
-  KX_MATH_API mat3();
+  KX_MATH_API constexpr mat3T() : val{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}} {}
 
   /// Construct a matrix from 9 values.
-  KX_MATH_API mat3(R m00, R m10, R m20, R m01, R m11, R m21, R m02, R m12,
-                   R m22);
+  KX_MATH_API constexpr mat3T(T m00, T m10, T m20, T m01, T m11, T m21, T m02,
+                              T m12, T m22)
+      : val{{m00, m01, m02}, {m10, m11, m12}, {m20, m21, m22}} {}
 
   /// Construct a matrix from 3 column vectors.
-  KX_MATH_API mat3(const vec3& v0, const vec3& v1, const vec3& v2);
+  KX_MATH_API constexpr mat3T(const vec3T<T>& v0, const vec3T<T>& v1,
+                              const vec3T<T>& v2)
+      : val{{v0.x, v0.y, v0.z}, {v1.x, v1.y, v1.z}, {v2.x, v2.y, v2.z}} {}
 
   /// Construct a transformation matrix from 3 vectors.
-  KX_MATH_API mat3(const vec2& right, const vec2& up, const vec2& position);
+  KX_MATH_API constexpr mat3T(const vec2T<T>& right, const vec2T<T>& up,
+                              const vec2T<T>& position)
+      : val{{right.x, right.y, 0},
+            {up.x, up.y, 0},
+            {position.x, position.y, 1}} {}
 
   /// Construct a 3x3 matrix by taking the upper 3x3 part of the 4x4 matrix.
-  KX_MATH_API mat3(const mat4&);
+  KX_MATH_API mat3T(const mat4T<T>&);
 
   /// Return a mutable reference to the specified value.
-  KX_MATH_API R& operator()(int row, int col);
+  KX_MATH_API T& operator()(int row, int col);
 
   /// Access the value at the specified position.
-  KX_MATH_API R operator()(int row, int col) const;
+  KX_MATH_API constexpr T operator()(int row, int col) const {
+    return val[col][row];
+  }
 
   /// Return a mutable reference to the matrix's first column.
-  KX_MATH_API vec2& v0();
+  KX_MATH_API vec2T<T>& v0();
 
   /// Return a mutable reference to the matrix's second column.
-  KX_MATH_API vec2& v1();
+  KX_MATH_API vec2T<T>& v1();
 
   /// Return a mutable reference to the matrix's third column.
-  KX_MATH_API vec2& v2();
+  KX_MATH_API vec2T<T>& v2();
 
   /// Return the matrix's first column.
-  KX_MATH_API const vec2& v0() const;
+  KX_MATH_API const vec2T<T>& v0() const;
 
   /// Return the matrix's second column.
-  KX_MATH_API const vec2& v1() const;
+  KX_MATH_API const vec2T<T>& v1() const;
 
   /// Return the matrix's third column.
-  KX_MATH_API const vec2& v2() const;
+  KX_MATH_API const vec2T<T>& v2() const;
 
   /// Multiply two matrices.
   /// \return A * B = AB
-  KX_MATH_API mat3 operator*(const mat3&);
+  KX_MATH_API mat3T operator*(const mat3T&);
 
   /// Multiply two matrices and accumulate the result in the first operand.
   /// A *= B === A = AB
-  KX_MATH_API void operator*=(const mat3&);
+  KX_MATH_API void operator*=(const mat3T&);
 
-  /// Return a const R pointer to the matrix's data.
-  KX_MATH_API operator const R*() const { return (R*)val; }
+  /// Return a const T pointer to the matrix's data.
+  KX_MATH_API operator const T*() const { return (T*)val; }
 
   /// Return the translation component of the matrix.
-  KX_MATH_API mat3 transl() const;
+  KX_MATH_API constexpr mat3T transl() const {
+    return mat3T(1, 0, val[2][0], 0, 1, val[2][1], 0, 0, 1);
+  }
 
   /// Return the rotation component of the matrix.
-  KX_MATH_API mat3 rot() const;
+  KX_MATH_API constexpr mat3T rot() const {
+    return mat3T(val[0][0], val[1][0], 0, val[0][1], val[1][1], 0, 0, 0, 1);
+  }
 
   /// Create a rotation matrix.
   /// The angle of rotation is in degrees.
-  KX_MATH_API static mat3 rot(R angle);
+  /// Unlike the other builders, this is evaluated at run time.
+  KX_MATH_API static mat3T rot(T angle);
 
   /// Create a scale matrix.
-  KX_MATH_API static mat3 scale(vec3 s);
+  KX_MATH_API static constexpr mat3T scale(vec3T<T> s) {
+    return scale(s.x, s.y, s.z);
+  }
 
   /// Create a scale matrix.
-  KX_MATH_API static mat3 scale(R x, R y, R z);
+  KX_MATH_API static constexpr mat3T scale(T x, T y, T z) {
+    return mat3T(x, 0, 0, 0, y, 0, 0, 0, z);
+  }
 
   /// Create a translation matrix.
-  KX_MATH_API static mat3 transl(vec2 offset);
+  KX_MATH_API static constexpr mat3T transl(vec2T<T> offset) {
+    return transl(offset.x, offset.y);
+  }
 
   /// Create a translation matrix.
-  KX_MATH_API static mat3 transl(R x, R y);
+  KX_MATH_API static constexpr mat3T transl(T x, T y) {
+    return mat3T(1, 0, x, 0, 1, y, 0, 0, 1);
+  }
 
   /// Return the X-axis reflection matrix.
-  KX_MATH_API static mat3 reflectx();
+  KX_MATH_API static constexpr mat3T reflectx() { return scale(-1, 1, 1); }
 
   /// Return the Y-axis reflection matrix.
-  KX_MATH_API static mat3 reflecty();
+  KX_MATH_API static constexpr mat3T reflecty() { return scale(1, -1, 1); }
 
   /// Return the Z-axis reflection matrix.
-  KX_MATH_API static mat3 reflectz();
+  KX_MATH_API static constexpr mat3T reflectz() { return scale(1, 1, -1); }
 
   /// Return the identity matrix.
-  KX_MATH_API static mat3 id();
+  KX_MATH_API static constexpr mat3T id() { return mat3T(); }
 };
 
 /// Invert the matrix.
-KX_MATH_API mat3 inverse(const mat3&);
+template <typename T>
+KX_MATH_API mat3T<T> inverse(const mat3T<T>&);
 
 /// Transpose the matrix.
-KX_MATH_API mat3 transpose(const mat3&);
+template <typename T>
+KX_MATH_API mat3T<T> transpose(const mat3T<T>&);
 
 /// Return the vector multipled by the matrix.
-KX_MATH_API vec3 operator*(const mat3&, vec3);
+template <typename T>
+KX_MATH_API vec3T<T> operator*(const mat3T<T>&, vec3T<T>);
 
 }  // namespace kx
+
+#ifdef KX_MATH_INLINE
+#include <math/mat3.inl>
+#endif
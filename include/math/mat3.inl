@@ -0,0 +1,47 @@
+#pragma once
+
+// Definitions of the mat3 primitives that may be inlined.
+//
+// This file is included by mat3.h when KX_MATH_INLINE is defined, and by
+// mat3.cc otherwise. See defs.h.
+
+#include <math/vec2.h>
+
+namespace kx {
+
+template <typename T>
+KX_MATH_INL KX_MATH_API T& mat3T<T>::operator()(int row, int col) {
+  return val[col][row];
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec2T<T>& mat3T<T>::v0() {
+  return *((vec2T<T>*)val[0]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec2T<T>& mat3T<T>::v1() {
+  return *((vec2T<T>*)val[1]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec2T<T>& mat3T<T>::v2() {
+  return *((vec2T<T>*)val[2]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec2T<T>& mat3T<T>::v0() const {
+  return *((vec2T<T>*)val[0]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec2T<T>& mat3T<T>::v1() const {
+  return *((vec2T<T>*)val[1]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec2T<T>& mat3T<T>::v2() const {
+  return *((vec2T<T>*)val[2]);
+}
+
+}  // namespace kx
@@ -1,154 +1,193 @@
 #pragma once
 
 #include <math/defs.h>
+#include <math/fwd.h>
 #include <math/vec4.h>
 
 namespace kx {
 
-struct vec3;
-
 /// A 4x4 column-major matrix.
-class mat4 {
-  R val[4][4];
+template <typename T>
+class mat4T {
+  T val[4][4];
 
  public:
   /// Construct the identity matrix.
-  KX_MATH_API mat4();
+  KX_MATH_API constexpr mat4T()
+      : val{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}} {}
 
   /// Construct a matrix from 16 values.
-  KX_MATH_API mat4(R m00, R m10, R m20, R m30, R m01, R m11, R m21, R m31,
-                   R m02, R m12, R m22, R m32, R m03, R m13, R m23, R m33);
+  KX_MATH_API constexpr mat4T(T m00, T m10, T m20, T m30, T m01, T m11, T m21,
+                              T m31, T m02, T m12, T m22, T m32, T m03, T m13,
+                              T m23, T m33)
+      : val{{m00, m01, m02, m03},
+            {m10, m11, m12, m13},
+            {m20, m21, m22, m23},
+            {m30, m31, m32, m33}} {}
 
   /// Construct a matrix from 4 column vectors.
-  KX_MATH_API mat4(const vec4& v0, const vec4& v1, const vec4& v2,
-                   const vec4& v3);
+  KX_MATH_API constexpr mat4T(const vec4T<T>& v0, const vec4T<T>& v1,
+                              const vec4T<T>& v2, const vec4T<T>& v3)
+      : val{{v0.x, v0.y, v0.z, v0.w},
+            {v1.x, v1.y, v1.z, v1.w},
+            {v2.x, v2.y, v2.z, v2.w},
+            {v3.x, v3.y, v3.z, v3.w}} {}
 
   /// Construct a transformation matrix from 4 vectors.
-  KX_MATH_API mat4(const vec3& right, const vec3& up, const vec3& forward,
-                   const vec3& position);
+  KX_MATH_API constexpr mat4T(const vec3T<T>& right, const vec3T<T>& up,
+                              const vec3T<T>& forward,
+                              const vec3T<T>& position)
+      : val{{right.x, right.y, right.z, 0},
+            {up.x, up.y, up.z, 0},
+            {forward.x, forward.y, forward.z, 0},
+            {position.x, position.y, position.z, 1}} {}
 
   /// Return a mutable reference to the value at the specified position.
-  KX_MATH_API R& operator()(int row, int col);
+  KX_MATH_API T& operator()(int row, int col);
 
   /// Access the value at the specified position.
-  KX_MATH_API R operator()(int row, int col) const;
+  KX_MATH_API constexpr T operator()(int row, int col) const {
+    return val[col][row];
+  }
 
   /// Return a mutable reference to the matrix's first column.
-  KX_MATH_API vec3& v0();
+  KX_MATH_API vec3T<T>& v0();
 
   /// Return a mutable reference to the matrix's second column.
-  KX_MATH_API vec3& v1();
+  KX_MATH_API vec3T<T>& v1();
 
   /// Return a mutable reference to the matrix's third column.
-  KX_MATH_API vec3& v2();
+  KX_MATH_API vec3T<T>& v2();
 
   /// Return a mutable reference to the matrix's fourth column.
-  KX_MATH_API vec3& v3();
+  KX_MATH_API vec3T<T>& v3();
 
   /// Return the matrix's first column.
-  KX_MATH_API const vec3& v0() const;
+  KX_MATH_API const vec3T<T>& v0() const;
 
   /// Return the matrix's second column.
-  KX_MATH_API const vec3& v1() const;
+  KX_MATH_API const vec3T<T>& v1() const;
 
   /// Return the matrix's third column.
-  KX_MATH_API const vec3& v2() const;
+  KX_MATH_API const vec3T<T>& v2() const;
 
   ///  Return an immutable reference to the matrix's fourth column.
-  KX_MATH_API const vec3& v3() const;
+  KX_MATH_API const vec3T<T>& v3() const;
 
   /// Return a mutable reference to the matrix's ith column.
-  KX_MATH_API vec4& column(int i);
+  KX_MATH_API vec4T<T>& column(int i);
 
   /// Return the matrix's ith row.
-  KX_MATH_API const vec4& column(int i) const;
+  KX_MATH_API const vec4T<T>& column(int i) const;
 
   /// Return a mutable reference to the matrix's ith column.
-  KX_MATH_API vec4 row(int i);
+  KX_MATH_API vec4T<T> row(int i);
 
   /// Return the matrix's ith row.
-  KX_MATH_API const vec4 row(int i) const;
+  KX_MATH_API const vec4T<T> row(int i) const;
 
   /// Multiply two matrices.
   /// A * B = AB
-  KX_MATH_API mat4 operator*(const mat4&)const;
+  KX_MATH_API mat4T operator*(const mat4T&)const;
 
   /// Multiply two matrices and accumulate the result in the first operand.
   /// A *= B === A = AB
-  KX_MATH_API void operator*=(const mat4&);
+  KX_MATH_API void operator*=(const mat4T&);
 
-  /// Return a const R pointer to the matrix's data.
-  KX_MATH_API operator const R*() const { return (R*)val; }
+  /// Return a const T pointer to the matrix's data.
+  KX_MATH_API operator const T*() const { return (T*)val; }
 
   /// Return the translation component of the matrix.
-  KX_MATH_API mat4 transl() const;
+  KX_MATH_API constexpr mat4T transl() const {
+    return mat4T(1, 0, 0, val[3][0], 0, 1, 0, val[3][1], 0, 0, 1, val[3][2], 0,
+                 0, 0, 1);
+  }
 
   /// Return the rotation component of the matrix.
-  KX_MATH_API mat4 rot() const;
+  KX_MATH_API constexpr mat4T rot() const {
+    return mat4T(val[0][0], val[1][0], val[2][0], 0, val[0][1], val[1][1],
+                 val[2][1], 0, val[0][2], val[1][2], val[2][2], 0, 0, 0, 0, 1);
+  }
+
+  //
+  // The builders below that involve trigonometric functions (rotx, roty,
+  // rotz, rot, transform, lookAt, perspective, perspectiveInverse) are
+  // evaluated at run time: the standard library's sin, cos and tan are not
+  // constexpr. The others are constexpr and can initialise constants.
+  //
 
   /// Create an X-axis rotation matrix.
   /// \param angle The angle of rotation in degrees.
-  KX_MATH_API static mat4 rotx(R angle);
+  KX_MATH_API static mat4T rotx(T angle);
 
   /// Create a Y-axis rotation matrix.
   /// \param angle The angle of rotation in degrees.
-  KX_MATH_API static mat4 roty(R angle);
+  KX_MATH_API static mat4T roty(T angle);
 
   /// Create a Z-axis rotation matrix.
   /// \param angle The angle of rotation in degrees.
-  KX_MATH_API static mat4 rotz(R angle);
+  KX_MATH_API static mat4T rotz(T angle);
 
   /// Create a rotation matrix.
   /// angle The angle of rotation in degrees.
   /// axis  The axis of rotation.
-  KX_MATH_API static mat4 rot(R angle, const vec3& axis);
+  KX_MATH_API static mat4T rot(T angle, const vec3T<T>& axis);
 
   /// Create a rotation matrix.
   /// \param angle The angle of rotation in degrees.
   /// \param x     X component of the rotation axis.
   /// \param y     Y component of the rotation axis.
   /// \param z     Z component of the rotation axis.
-  KX_MATH_API static mat4 rot(R angle, R x, R y, R z);
+  KX_MATH_API static mat4T rot(T angle, T x, T y, T z);
 
   /// Create a scale matrix.
   /// \þaram s Scale vector.
-  KX_MATH_API static mat4 scale(const vec3& s);
+  KX_MATH_API static constexpr mat4T scale(const vec3T<T>& s) {
+    return mat4T(s.x, 0, 0, 0, 0, s.y, 0, 0, 0, 0, s.z, 0, 0, 0, 0, 1);
+  }
 
   /// Create a scale matrix.
   /// \param sx X axis scale factor.
   /// \param sy Y axis scale factor.
   /// \param sz Z axis scale factor.
-  KX_MATH_API static mat4 scale(R sx, R sy, R sz);
+  KX_MATH_API static constexpr mat4T scale(T sx, T sy, T sz) {
+    return mat4T(sx, 0, 0, 0, 0, sy, 0, 0, 0, 0, sz, 0, 0, 0, 0, 1);
+  }
 
   /// Create a translation matrix.
   /// \param offset Translation offset.
-  KX_MATH_API static mat4 transl(const vec3& offset);
+  KX_MATH_API static constexpr mat4T transl(const vec3T<T>& offset) {
+    return transl(offset.x, offset.y, offset.z);
+  }
 
   /// Create a translation matrix.
   /// \param x Translation offset along the X axis.
   /// \param y Translation offset along the Y axis.
   /// \param z Translation offset along the Z axis.
-  KX_MATH_API static mat4 transl(R x, R y, R z);
+  KX_MATH_API static constexpr mat4T transl(T x, T y, T z) {
+    return mat4T(1, 0, 0, x, 0, 1, 0, y, 0, 0, 1, z, 0, 0, 0, 1);
+  }
 
   /// The X-axis reflection matrix.
-  KX_MATH_API static mat4 reflectx();
+  KX_MATH_API static constexpr mat4T reflectx() { return scale(-1, 1, 1); }
 
   /// The Y-axis reflection matrix.
-  KX_MATH_API static mat4 reflecty();
+  KX_MATH_API static constexpr mat4T reflecty() { return scale(1, -1, 1); }
 
   /// The Z-axis reflection matrix.
-  KX_MATH_API static mat4 reflectz();
+  KX_MATH_API static constexpr mat4T reflectz() { return scale(1, 1, -1); }
 
   /// The identity matrix.
-  KX_MATH_API static mat4 id();
+  KX_MATH_API static constexpr mat4T id() { return mat4T(); }
 
   /// Create a transformation matrix from the given forward vector.
-  KX_MATH_API static mat4 transform(vec3 forward);
+  KX_MATH_API static mat4T transform(vec3T<T> forward);
 
   /// Create a transformation matrix.
   /// \param position The object's position.
   /// \param target   The point the object is looking at.
-  KX_MATH_API static mat4 lookAt(const vec3& position, const vec3& target);
+  KX_MATH_API static mat4T lookAt(const vec3T<T>& position,
+                                  const vec3T<T>& target);
 
   /// Create an orthographic projection matrix.
   /// \param left   The coordinate for the left vertical clipping plane.
@@ -157,43 +196,57 @@ class mat4 {
   /// \param top    The coordinate for the top horizontal clipping plane.
   /// \param near   The distance to the near clipping plane.
   /// \param far    The distance to the far clipping plane.
-  KX_MATH_API static mat4 ortho(R left, R right, R bottom, R top, R near,
-                                R far);
+  KX_MATH_API static constexpr mat4T ortho(T left, T right, T bottom, T top,
+                                           T near, T far) {
+    return mat4T(2 / (right - left), 0, 0, -(right + left) / (right - left), 0,
+                 2 / (top - bottom), 0, -(top + bottom) / (top - bottom), 0, 0,
+                 -2 / (far - near), -(far + near) / (far - near), 0, 0, 0, 1);
+  }
 
   /// Create a perspective projection matrix.
   /// \param fovy   The vertical field of view angle in degrees.
   /// \param aspect The aspect ratio that determines the field of view in the
   /// x-direction. \param near   Distance to the near clipping plane. \param far
   /// Distance to the far clipping plane.
-  KX_MATH_API static mat4 perspective(R fovy, R aspect, R near, R far);
+  KX_MATH_API static mat4T perspective(T fovy, T aspect, T near, T far);
 
   /// Create the inverse of a perspective projection matrix.
   /// \param fovy   The vertical field of view angle in degrees.
   /// \param aspect The aspect ratio that determines the field of view in the
   /// x-direction. \param near   Distance to the near clipping plane. \param far
   /// Distance to the far clipping plane.
-  KX_MATH_API static mat4 perspectiveInverse(R fovy, R aspect, R near, R far);
+  KX_MATH_API static mat4T perspectiveInverse(T fovy, T aspect, T near, T far);
 };
 
 /// Return the matrix's determinant.
-KX_MATH_API R det(const mat4& m);
+template <typename T>
+KX_MATH_API T det(const mat4T<T>& m);
 
 /// Invert the matrix.
-KX_MATH_API mat4 inverse(const mat4& m);
+template <typename T>
+KX_MATH_API mat4T<T> inverse(const mat4T<T>& m);
 
 /// Invert the transformation matrix.
 /// This is much faster than the more general inverse() function,
 /// but assumes that the matrix is of the form TR, where T is a
 /// translation and R a rotation.
-KX_MATH_API mat4 inverse_transform(const mat4& m);
+template <typename T>
+KX_MATH_API mat4T<T> inverse_transform(const mat4T<T>& m);
 
 /// Transpose the matrix.
-KX_MATH_API mat4 transpose(const mat4& m);
+template <typename T>
+KX_MATH_API mat4T<T> transpose(const mat4T<T>& m);
 
 /// Transform the vector with the matrix.
-KX_MATH_API vec3 transform(const mat4&, const vec3&, R w);
+template <typename T>
+KX_MATH_API vec3T<T> transform(const mat4T<T>&, const vec3T<T>&, NoDeduce<T> w);
 
 /// Return the vector multiplied by the matrix.
-KX_MATH_API vec4 operator*(const mat4&, const vec4&);
+template <typename T>
+KX_MATH_API vec4T<T> operator*(const mat4T<T>&, const vec4T<T>&);
 
 }  // namespace kx
+
+#ifdef KX_MATH_INLINE
+#include <math/mat4.inl>
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+// Definitions of the mat4 primitives that may be inlined.
+//
+// This file is included by mat4.h when KX_MATH_INLINE is defined, and by
+// mat4.cc otherwise. See defs.h.
+
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+namespace kx {
+
+template <typename T>
+KX_MATH_INL KX_MATH_API T& mat4T<T>::operator()(int row, int col) {
+  return val[col][row];
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec3T<T>& mat4T<T>::v0() {
+  return *((vec3T<T>*)val[0]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec3T<T>& mat4T<T>::v1() {
+  return *((vec3T<T>*)val[1]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec3T<T>& mat4T<T>::v2() {
+  return *((vec3T<T>*)val[2]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec3T<T>& mat4T<T>::v3() {
+  return *((vec3T<T>*)val[3]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec3T<T>& mat4T<T>::v0() const {
+  return *((vec3T<T>*)val[0]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec3T<T>& mat4T<T>::v1() const {
+  return *((vec3T<T>*)val[1]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec3T<T>& mat4T<T>::v2() const {
+  return *((vec3T<T>*)val[2]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec3T<T>& mat4T<T>::v3() const {
+  return *((vec3T<T>*)val[3]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T>& mat4T<T>::column(int i) {
+  return *((vec4T<T>*)val[i]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec4T<T>& mat4T<T>::column(int i) const {
+  return *((vec4T<T>*)val[i]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T> mat4T<T>::row(int i) {
+  return vec4T<T>(val[0][i], val[1][i], val[2][i], val[3][i]);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API const vec4T<T> mat4T<T>::row(int i) const {
+  return vec4T<T>(val[0][i], val[1][i], val[2][i], val[3][i]);
+}
+
+}  // namespace kx
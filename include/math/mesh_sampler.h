@@ -0,0 +1,72 @@
+#pragma once
+
+#include <math/alias_table.h>
+#include <math/sampling.h>
+#include <math/triangle3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kx {
+
+/// A point on the surface of a mesh: its position, its triangle and its
+/// barycentric coordinates in that triangle (see interpolate()).
+struct SurfacePoint {
+  vec3 p;
+  std::uint32_t triangle;
+  vec2 st;
+};
+
+/// Uniformly distributed points on the surface of a triangle mesh.
+///
+/// Construction computes the triangle areas and builds an alias table over
+/// them in parallel, in O(n) time. A point then takes O(1) time and three
+/// uniform numbers: one selects a triangle with probability proportional to
+/// its area and two place the point in it. Drawing points allocates nothing.
+class MeshSampler {
+ public:
+  /// Construct an empty sampler.
+  MeshSampler() {}
+
+  /// Construct a sampler over n triangles.
+  /// The sampler keeps a copy of the triangles. At least one of them must
+  /// have a positive area.
+  MeshSampler(const Triangle3* triangles, std::size_t n);
+
+  /// Construct a sampler over the triangles of an indexed mesh: triangle i
+  /// has the vertices indices[3i], indices[3i+1] and indices[3i+2].
+  MeshSampler(const vec3* vertices, const std::uint32_t* indices,
+              std::size_t num_triangles);
+
+  /// Return the point for the uniform numbers u, in [0,1), and st, in
+  /// [0,1]^2.
+  /// u selects the triangle and st is mapped uniformly onto it, so
+  /// stratified st samples give stratified points within each triangle.
+  SurfacePoint sample(R u, const vec2& st) const;
+
+  /// Draw n points.
+  void sample(RandGen&, SurfacePoint* out, std::size_t n) const;
+  void sample(Philox4x32&, SurfacePoint* out, std::size_t n) const;
+
+  /// Draw the positions of n points.
+  void sample(RandGen&, vec3* out, std::size_t n) const;
+  void sample(Philox4x32&, vec3* out, std::size_t n) const;
+
+  /// Return the surface area of the mesh.
+  R area() const { return table_.total(); }
+
+  /// Return the probability density of the points, with respect to area.
+  R pdf() const { return 1 / table_.total(); }
+
+  /// Return the number of triangles.
+  std::size_t size() const { return triangles_.size(); }
+
+ private:
+  void build();
+
+  std::vector<Triangle3> triangles_;
+  AliasTable table_;
+};
+
+}  // namespace kx
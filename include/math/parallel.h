@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace kx {
+
+/// Return the number of worker threads used by the parallel algorithms.
+inline unsigned num_threads() {
+  unsigned n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+/// Evaluate fn(begin, end) over the range [0, n) split into chunks of 'grain'
+/// elements.
+///
+/// Chunks are handed out dynamically to up to num_threads() threads, the
+/// calling thread included, so uneven chunks balance out. The function returns
+/// once all chunks have been processed. fn must be safe to call concurrently on
+/// disjoint ranges.
+template <typename F>
+void parallel_for(std::size_t n, std::size_t grain, F fn) {
+  grain = std::max<std::size_t>(grain, 1);
+  const std::size_t num_chunks = (n + grain - 1) / grain;
+  const std::size_t num_workers =
+      std::min<std::size_t>(num_threads(), num_chunks);
+  if (num_workers <= 1) {
+    if (n > 0) fn(std::size_t(0), n);
+    return;
+  }
+
+  std::atomic<std::size_t> next_chunk(0);
+  auto work = [&]() {
+    for (std::size_t c = next_chunk++; c < num_chunks; c = next_chunk++) {
+      std::size_t begin = c * grain;
+      fn(begin, std::min(begin + grain, n));
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers - 1);
+  for (std::size_t i = 1; i < num_workers; ++i) workers.emplace_back(work);
+  work();
+  for (std::thread& t : workers) t.join();
+}
+
+}  // namespace kx
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <math/defs.h>
+#include <math/simd.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kx {
+
+/// Philox4x32-10 counter-based random number generator.
+///
+/// The generator encrypts a 128-bit counter with a 64-bit key (Salmon et al.,
+/// "Parallel Random Numbers: As Easy as 1, 2, 3", SC 2011). Each counter value
+/// yields a block of 4 numbers, so the nth number of a stream is available in
+/// constant time, and the whole state fits in a few cache lines, where
+/// std::mt19937 carries 2.5 KB.
+///
+/// The key is the seed. The upper half of the counter selects one of 2^64
+/// independent streams and the lower half indexes the blocks of the stream.
+/// Parallel workers can therefore draw reproducible numbers without sharing
+/// any state: give worker i the stream split(i), or discard() to the start of
+/// its chunk of a single stream.
+///
+/// The class satisfies the standard UniformRandomBitGenerator requirements and
+/// works with the <random> distributions and std::shuffle. Numbers are
+/// generated a buffer at a time with SIMD instructions.
+class Philox4x32 {
+ public:
+  using result_type = std::uint32_t;
+
+  /// Construct a generator for the given seed and stream.
+  explicit Philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return 0xffffffff; }
+
+  /// Return the next number.
+  result_type operator()() {
+    if (next_ - buffer_begin_ >= kBufferSize) refill();
+    return buffer_[next_++ - buffer_begin_];
+  }
+
+  /// Skip the next n numbers in constant time.
+  void discard(std::uint64_t n) { next_ += n; }
+
+  /// Return a generator with the same seed positioned at the start of the
+  /// given stream.
+  Philox4x32 split(std::uint64_t stream) const {
+    return Philox4x32(seed(), stream);
+  }
+
+  /// Return the generator's seed.
+  std::uint64_t seed() const { return key_[0] | std::uint64_t(key_[1]) << 32; }
+
+  /// Return the generator's stream.
+  std::uint64_t stream() const { return stream_; }
+
+  /// Return the index of the next number in the stream.
+  std::uint64_t position() const { return next_; }
+
+  /// Return a uniformly distributed real in [0,1).
+  /// Float builds use 24 random bits, double builds 53.
+  R uniform() {
+#ifdef KX_MATH_FLOAT
+    return R((*this)() >> 8) * (R(1) / R(16777216));
+#else
+    std::uint64_t hi = (*this)();
+    std::uint64_t lo = (*this)();
+    return R(hi << 21 | lo >> 11) * (R(1) / R(9007199254740992.0));
+#endif
+  }
+
+  /// Return a pack of simd::Rv::N uniformly distributed reals in [0,1): 8
+  /// with AVX in float builds, 4 with AVX in double builds or SSE2 in float
+  /// builds, and 2 with SSE2 in double builds.
+  /// The lanes take the values of N successive calls to uniform(), converted
+  /// from the buffered numbers with SIMD instructions.
+  simd::Rv uniform_pack();
+
+  /// Write the next n numbers to out.
+  void generate(std::uint32_t* out, std::size_t n);
+
+  /// Write n uniformly distributed reals in [0,1) to out, converting them
+  /// with SIMD instructions.
+  /// The result is the same as that of n calls to uniform().
+  void generate_uniform(R* out, std::size_t n);
+
+  /// Compute block 'index' of the given stream.
+  /// This is the generator's underlying function: numbers 4*index to
+  /// 4*index+3 of the stream.
+  static void block(std::uint64_t seed, std::uint64_t stream,
+                    std::uint64_t index, std::uint32_t out[4]);
+
+ private:
+  /// Numbers buffered per refill; a multiple of the SIMD block count.
+  static constexpr std::uint64_t kBufferSize = 64;
+
+  /// Fill the buffer with the numbers starting at next_ rounded down to a
+  /// block boundary.
+  void refill();
+
+  std::uint32_t key_[2];
+  std::uint64_t stream_;
+  std::uint64_t next_;
+  std::uint64_t buffer_begin_;
+  std::uint32_t buffer_[kBufferSize];
+};
+
+}  // namespace kx
@@ -1,35 +1,98 @@
 #pragma once
 
 #include <math/defs.h>
+#include <math/fwd.h>
 #include <math/vec3.h>
 
+#include <cstddef>
+
 namespace kx {
 
 /// A quaternion.
-struct quat {
-  R w, x, y, z;
+template <typename T>
+struct quatT {
+  T w, x, y, z;
+
+  constexpr quatT() : w(1), x(0), y(0), z(0) {}
 
-  quat() : w(1.0f), x(0.0f), y(0.0f), z(0.0f) {}
+  constexpr quatT(T _w, T _x, T _y, T _z) : w(_w), x(_x), y(_y), z(_z) {}
 
-  quat(R _w, R _x, R _y, R _z) : w(_w), x(_x), y(_y), z(_z) {}
+  /// Convert a quaternion of a different precision.
+  template <typename U>
+  constexpr explicit quatT(const quatT<U>& q)
+      : w(T(q.w)), x(T(q.x)), y(T(q.y)), z(T(q.z)) {}
 };
 
 /// Multiply two quaternions.
-quat operator*(quat q1, quat q2);
+template <typename T>
+quatT<T> operator*(quatT<T> q1, quatT<T> q2);
 
 /// Construct a rotation quaternion.
-quat qrot(R angle, R x, R y, R z);
+template <typename T = R>
+quatT<T> qrot(NoDeduce<T> angle, NoDeduce<T> x, NoDeduce<T> y, NoDeduce<T> z);
 
 /// Invert the quaternion.
-quat inv(quat q);
+template <typename T>
+quatT<T> inv(quatT<T> q);
 
 /// Return the quaternion's conjugate.
-quat conj(quat q);
+template <typename T>
+quatT<T> conj(quatT<T> q);
+
+/// Return the quaternions' dot product.
+template <typename T>
+T dot(const quatT<T>& a, const quatT<T>& b);
+
+/// Return the quaternion divided by its magnitude.
+template <typename T>
+quatT<T> normalise(quatT<T> q);
 
 /// Rotate the given vector by the given unit quaternion.
-vec3 rot(const quat& q, const vec3& v);
+template <typename T>
+vec3T<T> rot(const quatT<T>& q, const vec3T<T>& v);
 
 /// Rotate the given vector by the given unit quaternion.
-void rot(const quat& q, vec3& v);
+template <typename T>
+void rot(const quatT<T>& q, vec3T<T>& v);
+
+/// Interpolate two unit quaternions linearly and normalise the result.
+/// The interpolation follows the shortest arc between the two rotations.
+template <typename T>
+quatT<T> nlerp(const quatT<T>& a, const quatT<T>& b, NoDeduce<T> t);
+
+/// Interpolate two unit quaternions spherically.
+/// The interpolation follows the shortest arc between the two rotations. The
+/// result is normalised, like that of nlerp(), so that repeated blending does
+/// not drift away from unit length; the batch slerp() below does the same.
+template <typename T>
+quatT<T> slerp(const quatT<T>& a, const quatT<T>& b, NoDeduce<T> t);
+
+//
+// Batch functions
+//
+// These functions operate on arrays of n elements and are implemented with
+// SIMD kernels (see simd.h). Output arrays may be the same as input arrays,
+// but must not otherwise overlap them.
+//
+
+/// Multiply two arrays of quaternions: out[i] = q1[i] * q2[i].
+void mul(const quat* q1, const quat* q2, quat* out, std::size_t n);
+
+/// Rotate each vector by its unit quaternion: out[i] = rot(q[i], v[i]).
+void rot(const quat* q, const vec3* v, vec3* out, std::size_t n);
+
+/// Rotate each vector by the unit quaternion: out[i] = rot(q, v[i]).
+void rot(const quat& q, const vec3* v, vec3* out, std::size_t n);
+
+/// Normalise each quaternion.
+void normalise(const quat* q, quat* out, std::size_t n);
+
+/// Interpolate two arrays of unit quaternions linearly and normalise the
+/// results: out[i] = nlerp(a[i], b[i], t).
+void nlerp(const quat* a, const quat* b, R t, quat* out, std::size_t n);
+
+/// Interpolate two arrays of unit quaternions spherically:
+/// out[i] = slerp(a[i], b[i], t).
+void slerp(const quat* a, const quat* b, R t, quat* out, std::size_t n);
 
 }  // namespace kx
@@ -2,6 +2,9 @@
 
 #include <math/vec3.h>
 
+#include <cstddef>
+#include <vector>
+
 namespace kx {
 
 /// A 3D ray.
@@ -37,4 +40,31 @@ inline KX_MATH_API Ray3 operator+=(const Ray3& ray, const R& offset) {
   return Ray3(ray(offset), ray.dir);
 }
 
+/// A batch of 3D rays in structure-of-arrays form: ray i has the position
+/// (px[i], py[i], pz[i]) and the direction (dx[i], dy[i], dz[i]).
+struct Ray3Batch {
+  std::vector<R> px, py, pz;
+  std::vector<R> dx, dy, dz;
+
+  /// Resize the batch to n rays.
+  /// Vectors keep their storage when they shrink, so a batch reused for
+  /// batches of the same or smaller size does not allocate.
+  void resize(std::size_t n) {
+    px.resize(n);
+    py.resize(n);
+    pz.resize(n);
+    dx.resize(n);
+    dy.resize(n);
+    dz.resize(n);
+  }
+
+  /// Return the number of rays.
+  std::size_t size() const { return px.size(); }
+
+  /// Return ray i.
+  Ray3 operator[](std::size_t i) const {
+    return Ray3(vec3(px[i], py[i], pz[i]), vec3(dx[i], dy[i], dz[i]));
+  }
+};
+
 }  // namespace kx
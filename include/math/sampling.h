@@ -1,138 +1,341 @@
-#pragma once
-
-#include <math/vec2.h>
-#include <math/vec3.h>
-
-#include <random>
-#include <vector>
-
-/** @defgroup sampling Sampling Functions
- * This module provides various sampling functions.
- *
- * For functions sampling the unit hemisphere, the following
- * coordinate system is used:
- *
- *     w = z
- *     |
- *     |
- *     |
- *     |
- *     ---------- v = y
- *    /
- *   /
- *  /
- * u = x
- *
- * These functions also take a skew factor e >= 1. The skew factor determines
- * whether the resulting samples are uniformly distributed or whether they
- * are skewed towards the tip of the hemisphere:
- *
- * e = 1 generates a uniform distribution.
- * e > 1 skews samples towards z.
- *
- * @{
- */
-
-namespace kx {
-
-using RandGen = std::mt19937;
-
-//
-// Functions relying on the client for random number generation
-//
-
-/// Sample the consine-weighted, unit Z-oriented hemisphere (tangent space).
-/// (u,v) are two random numbers in [0,1].
-/// e >= 1 is the skew factor.
-vec3 sample_hemisphere(R u, R v, R e = 1);
-
-/// Sample the consine-weighted, normal-oriented unit hemisphere (object space).
-/// (u,v) are two random numbers in [0,1].
-/// e >= 1 is the skew factor.
-vec3 sample_hemisphere(const vec3& n, R u, R v, R e = 1);
-
-/// Sample the consine-weighted, Z-oriented hemisphere (tangent space).
-/// This function maps samples in the unit square to samples in the unit
-/// hemisphere. The resulting distribution has the same properties as the input
-/// one (for e=1), so if the square samples are uniformly distributed, the
-/// hemisphere samples are also uniformly distributed.
-std::vector<vec3> sample_hemisphere(const std::vector<vec2>& square_samples,
-                                    R e = 1);
-
-/// Uniformly sample the unit sphere.
-vec3 sample_sphere(R u, R v);
-
-//
-// Functions using a random number generator
-//
-
-/// Sample the cosine-weighted, unit Z-oriented hemisphere.
-vec3 sample_hemisphere(RandGen&, R e = 1);
-
-/// Sample the unit sphere.
-vec3 sample_sphere(RandGen&);
-
-/// Sample the unit disk.
-vec2 sample_disk(RandGen&);
-
-/// Sample the unit circle.
-vec2 sample_circle(RandGen&);
-
-/// Sample the unit circle.
-vec2 sample_semicircle(RandGen&);
-
-/// Sample the unity square.
-vec2 sample_square(RandGen&);
-
-//
-// Functions using a random number generator, vector version
-//
-
-/// Sample the cosine-weighted, unit Z-oriented hemisphere (tangent space).
-std::vector<vec3> sample_hemisphere(RandGen&, int num_samples, R e = 1);
-
-/// Sample the unit sphere.
-std::vector<vec3> sample_sphere(RandGen&, int num_samples);
-
-/// Sample the unit disk.
-std::vector<vec2> sample_disk(RandGen&, int num_samples);
-
-/// Sample the unit circle.
-/// This produces 'num_samples' uniformly distributed samples by walking
-/// along the perimeter of the unit circle taking steps of a fixed size.
-std::vector<vec2> sample_circle(int num_samples);
-
-/// Sample the unit circle.
-/// Like the above, but computes a random permutation of the samples to break
-/// the angular correlation between them.
-std::vector<vec2> sample_circle(RandGen&, int num_samples);
-
-/// Sample the unit semicircle.
-std::vector<vec2> sample_semicircle(int num_samples);
-
-/// Sample the unit semicircle.
-/// Like the above, but computes a random permutation of the samples to break
-/// the angular correlation between them.
-std::vector<vec2> sample_semicircle(RandGen&, int num_samples);
-
-/// Sample the unit square.
-std::vector<vec2> sample_square(RandGen&, int num_samples);
-
-/// Poisson disk, 64 samples.
-extern const vec2 poisson_disk_64[64];
-
-/// Poisson disk, 32 samples.
-extern const vec2 poisson_disk_32[32];
-
-/// Poisson disk, 16 samples.
-extern const vec2 poisson_disk_16[16];
-
-/// Poisson disk, 8 samples.
-extern const vec2 poisson_disk_8[8];
-
-/// Poisson disk, 4 samples.
-extern const vec2 poisson_disk_4[4];
-
-}  // namespace kx
-
-/** @} */
+#pragma once
+
+#include <math/philox.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/** @defgroup sampling Sampling Functions
+ * This module provides various sampling functions.
+ *
+ * For functions sampling the unit hemisphere, the following
+ * coordinate system is used:
+ *
+ *     w = z
+ *     |
+ *     |
+ *     |
+ *     |
+ *     ---------- v = y
+ *    /
+ *   /
+ *  /
+ * u = x
+ *
+ * These functions also take a skew factor e >= 1. The skew factor determines
+ * whether the resulting samples are uniformly distributed or whether they
+ * are skewed towards the tip of the hemisphere:
+ *
+ * e = 1 generates a uniform distribution.
+ * e > 1 skews samples towards z.
+ *
+ * @{
+ */
+
+namespace kx {
+
+using RandGen = std::mt19937;
+
+//
+// Functions relying on the client for random number generation
+//
+
+/// Sample the consine-weighted, unit Z-oriented hemisphere (tangent space).
+/// (u,v) are two random numbers in [0,1].
+/// e >= 1 is the skew factor.
+vec3 sample_hemisphere(R u, R v, R e = 1);
+
+/// Sample the consine-weighted, normal-oriented unit hemisphere (object space).
+/// (u,v) are two random numbers in [0,1].
+/// e >= 1 is the skew factor.
+vec3 sample_hemisphere(const vec3& n, R u, R v, R e = 1);
+
+/// Sample the consine-weighted, Z-oriented hemisphere (tangent space).
+/// This function maps samples in the unit square to samples in the unit
+/// hemisphere. The resulting distribution has the same properties as the input
+/// one (for e=1), so if the square samples are uniformly distributed, the
+/// hemisphere samples are also uniformly distributed.
+std::vector<vec3> sample_hemisphere(const std::vector<vec2>& square_samples,
+                                    R e = 1);
+
+/// Map the n square samples to the hemisphere, as above, writing the results
+/// to 'out', which must hold n vectors. Nothing is allocated.
+void sample_hemisphere(const vec2* square_samples, vec3* out, std::size_t n,
+                       R e = 1);
+
+/// Sample the cosine-weighted, Z-oriented hemisphere (tangent space).
+/// This is the batch version of sample_hemisphere(u, v, e) for separate
+/// arrays of u and v, and uses SIMD instructions (see below).
+void sample_hemisphere(const R* u, const R* v, vec3* out, std::size_t n,
+                       R e = 1);
+
+/// Uniformly sample the unit sphere.
+/// (u,v) are two random numbers in [0,1].
+vec3 sample_sphere(R u, R v);
+
+/// Uniformly sample the unit sphere.
+/// Like sample_hemisphere(), this maps samples in the unit square and keeps
+/// their distribution, so stratified or low-discrepancy square samples (see
+/// low_discrepancy.h) yield well distributed sphere samples.
+std::vector<vec3> sample_sphere(const std::vector<vec2>& square_samples);
+
+/// Map the n square samples to the sphere, writing the results to 'out',
+/// which must hold n vectors. Nothing is allocated.
+void sample_sphere(const vec2* square_samples, vec3* out, std::size_t n);
+
+/// Uniformly sample the unit sphere.
+/// This is the batch version of sample_sphere(u, v) for separate arrays of u
+/// and v, and uses SIMD instructions (see below).
+void sample_sphere(const R* u, const R* v, vec3* out, std::size_t n);
+
+/// Uniformly sample the unit disk.
+/// (u,v) are two random numbers in [0,1].
+vec2 sample_disk(R u, R v);
+
+/// Uniformly sample the unit disk.
+/// This maps samples in the unit square and keeps their distribution.
+std::vector<vec2> sample_disk(const std::vector<vec2>& square_samples);
+
+/// Map the n square samples to the disk, writing the results to 'out', which
+/// must hold n points. Nothing is allocated.
+void sample_disk(const vec2* square_samples, vec2* out, std::size_t n);
+
+/// Uniformly sample the unit disk.
+/// This is the batch version of sample_disk(u, v) for separate arrays of u
+/// and v, and uses SIMD instructions (see below).
+void sample_disk(const R* u, const R* v, vec2* out, std::size_t n);
+
+/// Uniformly sample the unit disk with Shirley and Chiu's concentric mapping.
+/// (u,v) are two random numbers in [0,1].
+/// The mapping takes concentric squares to concentric circles and distorts
+/// areas less than the polar mapping of sample_disk(u, v), so stratified or
+/// low-discrepancy square samples stay well distributed on the disk.
+vec2 sample_concentric_disk(R u, R v);
+
+/// Uniformly sample the unit disk with the concentric mapping.
+/// This is the batch version of sample_concentric_disk(u, v).
+std::vector<vec2> sample_concentric_disk(
+    const std::vector<vec2>& square_samples);
+
+/// Map the n square samples, or the n pairs (u[i], v[i]), to the disk with
+/// the concentric mapping, writing the results to 'out', which must hold n
+/// points. Nothing is allocated.
+void sample_concentric_disk(const vec2* square_samples, vec2* out,
+                            std::size_t n);
+void sample_concentric_disk(const R* u, const R* v, vec2* out, std::size_t n);
+
+/// Sample the cosine-weighted, Z-oriented hemisphere (tangent space).
+/// (u,v) are two random numbers in [0,1].
+/// This projects sample_concentric_disk(u, v) up to the hemisphere, giving the
+/// distribution of sample_hemisphere(u, v, 1) with the concentric mapping's
+/// stratification and without pow().
+vec3 sample_cosine_hemisphere(R u, R v);
+
+/// Sample the cosine-weighted, Z-oriented hemisphere (tangent space).
+/// This is the batch version of sample_cosine_hemisphere(u, v).
+std::vector<vec3> sample_cosine_hemisphere(
+    const std::vector<vec2>& square_samples);
+
+/// Map the n square samples, or the n pairs (u[i], v[i]), to the cosine-
+/// weighted hemisphere, writing the results to 'out', which must hold n
+/// vectors. Nothing is allocated.
+void sample_cosine_hemisphere(const vec2* square_samples, vec3* out,
+                              std::size_t n);
+void sample_cosine_hemisphere(const R* u, const R* v, vec3* out,
+                              std::size_t n);
+
+// The functions above that map arrays or vectors of samples compute sin, cos
+// and pow with the polynomials of simd.h, so their results differ slightly
+// from those of the single-sample functions. The error of each component is
+// below 3 ULP of 1 for the sphere, the disks, the cosine hemisphere and the
+// hemisphere with e = 0 or e = 1; these cases avoid pow and the cancellation
+// in sqrt(1 - cos^2) near the pole, and are more accurate than the
+// single-sample functions. Other skews go through simd::pow() and lose
+// precision near the pole as the single-sample function does.
+
+//
+// Functions using a random number generator
+//
+// Every function comes in two versions: one for the standard RandGen and one
+// for Philox4x32, whose streams can be split among threads to sample in
+// parallel without shared state (see philox.h).
+//
+
+/// Sample the cosine-weighted, unit Z-oriented hemisphere.
+vec3 sample_hemisphere(RandGen&, R e = 1);
+vec3 sample_hemisphere(Philox4x32&, R e = 1);
+
+/// Sample the unit sphere.
+vec3 sample_sphere(RandGen&);
+vec3 sample_sphere(Philox4x32&);
+
+/// Sample the unit disk.
+/// This uses the concentric mapping, so every sample takes two numbers.
+vec2 sample_disk(RandGen&);
+vec2 sample_disk(Philox4x32&);
+
+/// Sample the unit circle.
+vec2 sample_circle(RandGen&);
+vec2 sample_circle(Philox4x32&);
+
+/// Sample the unit circle.
+vec2 sample_semicircle(RandGen&);
+vec2 sample_semicircle(Philox4x32&);
+
+/// Sample the unity square.
+vec2 sample_square(RandGen&);
+vec2 sample_square(Philox4x32&);
+
+//
+// Functions using a random number generator, vector version
+//
+
+/// Sample the cosine-weighted, unit Z-oriented hemisphere (tangent space).
+std::vector<vec3> sample_hemisphere(RandGen&, int num_samples, R e = 1);
+std::vector<vec3> sample_hemisphere(Philox4x32&, int num_samples, R e = 1);
+
+/// Sample the unit sphere.
+std::vector<vec3> sample_sphere(RandGen&, int num_samples);
+std::vector<vec3> sample_sphere(Philox4x32&, int num_samples);
+
+/// Sample the unit disk.
+std::vector<vec2> sample_disk(RandGen&, int num_samples);
+std::vector<vec2> sample_disk(Philox4x32&, int num_samples);
+
+/// Sample the unit circle.
+/// This produces 'num_samples' uniformly distributed samples by walking
+/// along the perimeter of the unit circle taking steps of a fixed size.
+std::vector<vec2> sample_circle(int num_samples);
+
+/// Sample the unit circle.
+/// Like the above, but computes a random permutation of the samples to break
+/// the angular correlation between them.
+std::vector<vec2> sample_circle(RandGen&, int num_samples);
+std::vector<vec2> sample_circle(Philox4x32&, int num_samples);
+
+/// Sample the unit semicircle.
+std::vector<vec2> sample_semicircle(int num_samples);
+
+/// Sample the unit semicircle.
+/// Like the above, but computes a random permutation of the samples to break
+/// the angular correlation between them.
+std::vector<vec2> sample_semicircle(RandGen&, int num_samples);
+std::vector<vec2> sample_semicircle(Philox4x32&, int num_samples);
+
+/// Sample the unit square.
+std::vector<vec2> sample_square(RandGen&, int num_samples);
+std::vector<vec2> sample_square(Philox4x32&, int num_samples);
+
+//
+// Functions using a random number generator, array version
+//
+// These functions write n samples to the caller's array and allocate
+// nothing, so a buffer can be reused across calls. They produce the same
+// samples as the vector versions.
+//
+
+/// Sample the cosine-weighted, unit Z-oriented hemisphere (tangent space).
+void sample_hemisphere(RandGen&, vec3* out, std::size_t n, R e = 1);
+void sample_hemisphere(Philox4x32&, vec3* out, std::size_t n, R e = 1);
+
+/// Sample the unit sphere.
+void sample_sphere(RandGen&, vec3* out, std::size_t n);
+void sample_sphere(Philox4x32&, vec3* out, std::size_t n);
+
+/// Sample the unit disk.
+void sample_disk(RandGen&, vec2* out, std::size_t n);
+void sample_disk(Philox4x32&, vec2* out, std::size_t n);
+
+/// Sample the unit circle with n evenly spaced samples.
+void sample_circle(vec2* out, std::size_t n);
+
+/// Sample the unit circle with n evenly spaced samples in random order.
+void sample_circle(RandGen&, vec2* out, std::size_t n);
+void sample_circle(Philox4x32&, vec2* out, std::size_t n);
+
+/// Sample the unit semicircle with n evenly spaced samples.
+void sample_semicircle(vec2* out, std::size_t n);
+
+/// Sample the unit semicircle with n evenly spaced samples in random order.
+void sample_semicircle(RandGen&, vec2* out, std::size_t n);
+void sample_semicircle(Philox4x32&, vec2* out, std::size_t n);
+
+/// Sample the unit square.
+void sample_square(RandGen&, vec2* out, std::size_t n);
+void sample_square(Philox4x32&, vec2* out, std::size_t n);
+
+//
+// Poisson disk sampling
+//
+// These functions generate samples no closer to each other than min_dist
+// with Bridson's algorithm, in O(N) time. max_attempts is the number of
+// candidates tried around a sample before it is retired; larger values give
+// denser sets.
+//
+
+/// Sample the unit square [0,1)^2.
+std::vector<vec2> sample_poisson_square(RandGen&, R min_dist,
+                                       int max_attempts = 30);
+std::vector<vec2> sample_poisson_square(Philox4x32&, R min_dist,
+                                       int max_attempts = 30);
+
+/// Sample the unit square [0,1)^2, measuring distances across its edges,
+/// so that copies of the set tile the plane without seams.
+std::vector<vec2> sample_poisson_tile(RandGen&, R min_dist,
+                                     int max_attempts = 30);
+std::vector<vec2> sample_poisson_tile(Philox4x32&, R min_dist,
+                                     int max_attempts = 30);
+
+/// Sample the unit disk.
+std::vector<vec2> sample_poisson_disk(RandGen&, R min_dist,
+                                     int max_attempts = 30);
+std::vector<vec2> sample_poisson_disk(Philox4x32&, R min_dist,
+                                     int max_attempts = 30);
+
+/// Sample the unit sphere.
+/// min_dist is the straight-line (chord) distance between samples.
+std::vector<vec3> sample_poisson_sphere(RandGen&, R min_dist,
+                                       int max_attempts = 30);
+std::vector<vec3> sample_poisson_sphere(Philox4x32&, R min_dist,
+                                       int max_attempts = 30);
+
+/// Sample the unit Z-oriented hemisphere (z >= 0).
+/// The samples are spread uniformly over the area of the hemisphere, not
+/// cosine-weighted. min_dist is the chord distance between samples.
+std::vector<vec3> sample_poisson_hemisphere(RandGen&, R min_dist,
+                                           int max_attempts = 30);
+std::vector<vec3> sample_poisson_hemisphere(Philox4x32&, R min_dist,
+                                           int max_attempts = 30);
+
+/// Return a tileable blue-noise set in the unit square.
+/// The set is a sample_poisson_tile() set of about num_samples points,
+/// rounded up to a power of two in [16, 65536]. Sets are generated with a
+/// fixed seed the first time each size is requested and kept for the
+/// lifetime of the program, so repeated calls are free and the result is the
+/// same in every run. This function is thread-safe.
+const std::vector<vec2>& blue_noise_tile(int num_samples);
+
+// The Poisson disk tables below are defined once, in the library, so each has
+// the same address in every translation unit.
+
+/// Poisson disk, 64 samples.
+extern const vec2 poisson_disk_64[64];
+
+/// Poisson disk, 32 samples.
+extern const vec2 poisson_disk_32[32];
+
+/// Poisson disk, 16 samples.
+extern const vec2 poisson_disk_16[16];
+
+/// Poisson disk, 8 samples.
+extern const vec2 poisson_disk_8[8];
+
+/// Poisson disk, 4 samples.
+extern const vec2 poisson_disk_4[4];
+
+}  // namespace kx
+
+/** @} */
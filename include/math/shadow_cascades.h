@@ -0,0 +1,73 @@
+#pragma once
+
+#include <math/AABB3.h>
+#include <math/camera.h>
+
+namespace kx {
+
+/// A slice of a camera's view frustum covered by one shadow map.
+struct ShadowCascade {
+  R near;  ///< Distance of the slice's near face from the camera.
+  R far;   ///< Distance of the slice's far face from the camera.
+
+  /// The slice's corners in world space: the near face's corners at
+  /// normalised device coordinates (-1,-1), (1,-1), (-1,1) and (1,1), then
+  /// the far face's in the same order.
+  vec3 corners[8];
+
+  /// The bounds of the corners in the view space of the light camera.
+  AABB3 bounds;
+
+  /// The light's orthographic camera covering the slice.
+  OrthoCamera camera;
+
+  /// The light camera's view-projection matrix.
+  mat4 view_projection;
+};
+
+/// Settings of split_cascades().
+struct CascadeSettings {
+  /// Number of cascades.
+  int num_cascades = 4;
+
+  /// Blend of the split distances between uniform (0) and logarithmic (1);
+  /// see cascade_splits().
+  R lambda = R(0.75);
+
+  /// Size of the shadow maps, in texels.
+  int resolution = 2048;
+
+  /// Whether to stabilise the light cameras (see split_cascades()).
+  bool stabilise = true;
+
+  /// Bounds of the shadow casters in world space. If non-empty, each light
+  /// camera's near plane is pulled back to include the casters between the
+  /// light and the slice; otherwise the camera only covers the slice.
+  AABB3 casters;
+};
+
+/// Compute the distances of the n+1 faces of n cascades over [near, far].
+/// Face i is at lambda * log_i + (1 - lambda) * uniform_i, with
+/// log_i = near (far/near)^(i/n) and uniform_i = near + (far - near) i/n
+/// (Zhang et al., "Parallel-Split Shadow Maps", 2006).
+void cascade_splits(R near, R far, int n, R lambda, R* out);
+
+/// Split the camera's view frustum into settings.num_cascades slices and fit
+/// an orthographic light camera, looking along light_dir, to each of them.
+///
+/// The frustum's corners are unprojected once with the camera's cached
+/// inverse view-projection matrix, and each slice's corners are
+/// interpolated between them. The slices span [getNear(), getFar()].
+///
+/// Stabilised cameras cover the bounding sphere of their slice, with a
+/// radius rounded up so that it does not change as the camera turns, and
+/// their position is snapped to whole shadow map texels in light space. The
+/// shadows then do not shimmer as the camera moves, at the cost of up to
+/// half the resolution of tight fitting. Otherwise, each light camera
+/// covers the light-space bounds of its slice exactly.
+///
+/// The cascades are written to out[0, num_cascades); nothing is allocated.
+void split_cascades(const Camera& camera, const vec3& light_dir,
+                    const CascadeSettings& settings, ShadowCascade* out);
+
+}  // namespace kx
@@ -0,0 +1,497 @@
+#pragma once
+
+//
+// Configuration macros:
+//
+// KX_MATH_NO_SIMD
+//   - Disable SIMD intrinsics; batch kernels fall back to scalar code.
+//
+// The instruction set is picked from the compiler's target flags: AVX when
+// __AVX__ is defined, SSE2 otherwise on x86, and scalar code elsewhere.
+//
+
+#include <math/defs.h>
+
+#include <cstdint>
+#include <cstring>
+
+#if !defined(KX_MATH_NO_SIMD) && !defined(__CUDA_ARCH__)
+#if defined(__AVX__)
+#define KX_MATH_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KX_MATH_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+#if defined(KX_MATH_AVX) && defined(KX_MATH_FLOAT)
+#define KX_SIMD_WIDTH 8
+#define KX_SIMD_TYPE __m256
+#define KX_SIMD(op) _mm256_##op##_ps
+#define KX_SIMD_CMP(a, b, op) _mm256_cmp_ps(a, b, op)
+#elif defined(KX_MATH_AVX)
+#define KX_SIMD_WIDTH 4
+#define KX_SIMD_TYPE __m256d
+#define KX_SIMD(op) _mm256_##op##_pd
+#define KX_SIMD_CMP(a, b, op) _mm256_cmp_pd(a, b, op)
+#elif defined(KX_MATH_SSE2) && defined(KX_MATH_FLOAT)
+#define KX_SIMD_WIDTH 4
+#define KX_SIMD_TYPE __m128
+#define KX_SIMD(op) _mm_##op##_ps
+#elif defined(KX_MATH_SSE2)
+#define KX_SIMD_WIDTH 2
+#define KX_SIMD_TYPE __m128d
+#define KX_SIMD(op) _mm_##op##_pd
+#else
+#define KX_SIMD_WIDTH 1
+#endif
+
+/** @defgroup simd SIMD Primitives
+ * A thin wrapper over the SIMD instruction set available at compile time.
+ *
+ * The batch kernels of the library are written once against the Rv type
+ * below and compile to AVX, SSE2 or plain scalar code. Rv packs as many Rs as
+ * fit in a vector register, so float builds process twice as many elements
+ * per instruction as double builds.
+ *
+ * @{
+ */
+
+namespace kx {
+namespace simd {
+
+#if KX_SIMD_WIDTH > 1
+
+/// A pack of Rv::N reals processed in lock-step.
+struct Rv {
+  enum { N = KX_SIMD_WIDTH };
+
+  KX_SIMD_TYPE v;
+
+  Rv() {}
+
+  Rv(KX_SIMD_TYPE _v) : v(_v) {}
+
+  /// Broadcast the value to all lanes.
+  Rv(R x) : v(KX_SIMD(set1)(x)) {}
+};
+
+/// A per-lane boolean, as produced by comparisons.
+struct Mask {
+  KX_SIMD_TYPE m;
+
+  Mask(KX_SIMD_TYPE _m) : m(_m) {}
+};
+
+/// Load Rv::N consecutive reals. The pointer need not be aligned.
+inline Rv load(const R* p) { return KX_SIMD(loadu)(p); }
+
+/// Store Rv::N consecutive reals. The pointer need not be aligned.
+inline void store(R* p, Rv a) { KX_SIMD(storeu)(p, a.v); }
+
+inline Rv operator+(Rv a, Rv b) { return KX_SIMD(add)(a.v, b.v); }
+inline Rv operator-(Rv a, Rv b) { return KX_SIMD(sub)(a.v, b.v); }
+inline Rv operator*(Rv a, Rv b) { return KX_SIMD(mul)(a.v, b.v); }
+inline Rv operator/(Rv a, Rv b) { return KX_SIMD(div)(a.v, b.v); }
+inline Rv operator-(Rv a) { return KX_SIMD(sub)(KX_SIMD(setzero)(), a.v); }
+
+inline Rv min(Rv a, Rv b) { return KX_SIMD(min)(a.v, b.v); }
+inline Rv max(Rv a, Rv b) { return KX_SIMD(max)(a.v, b.v); }
+inline Rv sqrt(Rv a) { return KX_SIMD(sqrt)(a.v); }
+
+/// Return the absolute value of each lane.
+inline Rv abs(Rv a) { return KX_SIMD(andnot)(Rv(-0.0f).v, a.v); }
+
+#if defined(KX_MATH_AVX)
+inline Mask operator<(Rv a, Rv b) { return KX_SIMD_CMP(a.v, b.v, _CMP_LT_OQ); }
+inline Mask operator<=(Rv a, Rv b) {
+  return KX_SIMD_CMP(a.v, b.v, _CMP_LE_OQ);
+}
+inline Mask operator>(Rv a, Rv b) { return KX_SIMD_CMP(a.v, b.v, _CMP_GT_OQ); }
+inline Mask operator>=(Rv a, Rv b) {
+  return KX_SIMD_CMP(a.v, b.v, _CMP_GE_OQ);
+}
+#else
+inline Mask operator<(Rv a, Rv b) { return KX_SIMD(cmplt)(a.v, b.v); }
+inline Mask operator<=(Rv a, Rv b) { return KX_SIMD(cmple)(a.v, b.v); }
+inline Mask operator>(Rv a, Rv b) { return KX_SIMD(cmpgt)(a.v, b.v); }
+inline Mask operator>=(Rv a, Rv b) { return KX_SIMD(cmpge)(a.v, b.v); }
+#endif
+
+inline Mask operator&(Mask a, Mask b) { return KX_SIMD(and)(a.m, b.m); }
+inline Mask operator|(Mask a, Mask b) { return KX_SIMD(or)(a.m, b.m); }
+
+/// Return a where the mask is set and b elsewhere.
+inline Rv select(Mask m, Rv a, Rv b) {
+  return KX_SIMD(or)(KX_SIMD(and)(m.m, a.v), KX_SIMD(andnot)(m.m, b.v));
+}
+
+/// Return a bit mask with bit i set if lane i of the mask is set.
+inline int bits(Mask m) { return KX_SIMD(movemask)(m.m); }
+
+#else  // scalar fallback
+
+struct Rv {
+  enum { N = 1 };
+
+  R v;
+
+  Rv() {}
+
+  Rv(R x) : v(x) {}
+};
+
+struct Mask {
+  bool m;
+
+  Mask(bool _m) : m(_m) {}
+};
+
+inline Rv load(const R* p) { return *p; }
+inline void store(R* p, Rv a) { *p = a.v; }
+
+inline Rv operator+(Rv a, Rv b) { return a.v + b.v; }
+inline Rv operator-(Rv a, Rv b) { return a.v - b.v; }
+inline Rv operator*(Rv a, Rv b) { return a.v * b.v; }
+inline Rv operator/(Rv a, Rv b) { return a.v / b.v; }
+inline Rv operator-(Rv a) { return -a.v; }
+
+inline Rv min(Rv a, Rv b) { return a.v < b.v ? a.v : b.v; }
+inline Rv max(Rv a, Rv b) { return a.v > b.v ? a.v : b.v; }
+inline Rv sqrt(Rv a) { return std::sqrt(a.v); }
+inline Rv abs(Rv a) { return a.v < 0 ? -a.v : a.v; }
+
+inline Mask operator<(Rv a, Rv b) { return a.v < b.v; }
+inline Mask operator<=(Rv a, Rv b) { return a.v <= b.v; }
+inline Mask operator>(Rv a, Rv b) { return a.v > b.v; }
+inline Mask operator>=(Rv a, Rv b) { return a.v >= b.v; }
+
+inline Mask operator&(Mask a, Mask b) { return a.m && b.m; }
+inline Mask operator|(Mask a, Mask b) { return a.m || b.m; }
+
+inline Rv select(Mask m, Rv a, Rv b) { return m.m ? a : b; }
+
+inline int bits(Mask m) { return m.m ? 1 : 0; }
+
+#endif  // KX_SIMD_WIDTH > 1
+
+inline void operator+=(Rv& a, Rv b) { a = a + b; }
+inline void operator-=(Rv& a, Rv b) { a = a - b; }
+inline void operator*=(Rv& a, Rv b) { a = a * b; }
+
+/// Return true if any lane of the mask is set.
+inline bool any(Mask m) { return bits(m) != 0; }
+
+/// Load the reals p[0], p[stride], ..., p[(N-1)*stride].
+/// This is used to transpose arrays of structures into packs.
+inline Rv gather(const R* p, int stride) {
+  R tmp[Rv::N];
+  for (int i = 0; i < Rv::N; ++i) tmp[i] = p[i * stride];
+  return load(tmp);
+}
+
+/// Store the pack to p[0], p[stride], ..., p[(N-1)*stride].
+inline void scatter(R* p, int stride, Rv a) {
+  R tmp[Rv::N];
+  store(tmp, a);
+  for (int i = 0; i < Rv::N; ++i) p[i * stride] = tmp[i];
+}
+
+//
+// Bit manipulation. The lanes are reinterpreted as unsigned integers of the
+// same width as R (Bits); these are the building blocks of exp2() and log2().
+//
+
+#ifdef KX_MATH_FLOAT
+using Bits = std::uint32_t;
+#else
+using Bits = std::uint64_t;
+#endif
+
+/// Broadcast the real with the given bit pattern to all lanes.
+inline Rv from_bits(Bits b) {
+  R x;
+  std::memcpy(&x, &b, sizeof(x));
+  return Rv(x);
+}
+
+#if KX_SIMD_WIDTH > 1
+
+inline Rv bit_and(Rv a, Rv b) { return KX_SIMD(and)(a.v, b.v); }
+inline Rv bit_or(Rv a, Rv b) { return KX_SIMD(or)(a.v, b.v); }
+
+#if defined(KX_MATH_AVX)
+// AVX has no 256-bit integer shifts (they came with AVX2), so the two halves
+// of the register are shifted with SSE2.
+#ifdef KX_MATH_FLOAT
+#define KX_SIMD_SLL _mm_slli_epi32
+#define KX_SIMD_SRL _mm_srli_epi32
+#define KX_SIMD_TO_INT _mm256_castps_si256
+#define KX_SIMD_FROM_INT _mm256_castsi256_ps
+#else
+#define KX_SIMD_SLL _mm_slli_epi64
+#define KX_SIMD_SRL _mm_srli_epi64
+#define KX_SIMD_TO_INT _mm256_castpd_si256
+#define KX_SIMD_FROM_INT _mm256_castsi256_pd
+#endif
+#define KX_SIMD_SHIFT(a, S, op)                                    \
+  KX_SIMD_FROM_INT(_mm256_insertf128_si256(                        \
+      _mm256_castsi128_si256(                                      \
+          op(_mm256_castsi256_si128(KX_SIMD_TO_INT(a)), S)),       \
+      op(_mm256_extractf128_si256(KX_SIMD_TO_INT(a), 1), S), 1))
+#else
+#ifdef KX_MATH_FLOAT
+#define KX_SIMD_SLL _mm_slli_epi32
+#define KX_SIMD_SRL _mm_srli_epi32
+#define KX_SIMD_TO_INT _mm_castps_si128
+#define KX_SIMD_FROM_INT _mm_castsi128_ps
+#else
+#define KX_SIMD_SLL _mm_slli_epi64
+#define KX_SIMD_SRL _mm_srli_epi64
+#define KX_SIMD_TO_INT _mm_castpd_si128
+#define KX_SIMD_FROM_INT _mm_castsi128_pd
+#endif
+#define KX_SIMD_SHIFT(a, S, op) KX_SIMD_FROM_INT(op(KX_SIMD_TO_INT(a), S))
+#endif
+
+/// Shift the bits of each lane left by S.
+template <int S>
+inline Rv shift_left(Rv a) {
+  return KX_SIMD_SHIFT(a.v, S, KX_SIMD_SLL);
+}
+
+/// Shift the bits of each lane right by S, shifting in zeros.
+template <int S>
+inline Rv shift_right(Rv a) {
+  return KX_SIMD_SHIFT(a.v, S, KX_SIMD_SRL);
+}
+
+#else  // scalar fallback
+
+inline Bits to_bits(R x) {
+  Bits b;
+  std::memcpy(&b, &x, sizeof(b));
+  return b;
+}
+
+inline Rv bit_and(Rv a, Rv b) { return from_bits(to_bits(a.v) & to_bits(b.v)); }
+inline Rv bit_or(Rv a, Rv b) { return from_bits(to_bits(a.v) | to_bits(b.v)); }
+
+template <int S>
+inline Rv shift_left(Rv a) {
+  return from_bits(to_bits(a.v) << S);
+}
+
+template <int S>
+inline Rv shift_right(Rv a) {
+  return from_bits(to_bits(a.v) >> S);
+}
+
+#endif  // KX_SIMD_WIDTH > 1
+
+/// Round each lane to the nearest integer (ties to even).
+/// Valid for |x| < 2^22 in float builds and |x| < 2^51 in double builds.
+inline Rv round(Rv x) {
+#ifdef KX_MATH_FLOAT
+  const Rv magic(12582912.0f);  // 1.5 * 2^23
+#else
+  const Rv magic(6755399441055744.0);  // 1.5 * 2^52
+#endif
+  return (x + magic) - magic;
+}
+
+/// Compute the sine and cosine of each lane.
+///
+/// The argument is reduced to [-pi/4, pi/4] with a three-part Cody-Waite
+/// reduction and the Cephes minimax polynomials are evaluated on the result.
+/// The maximum error is below 2 ULP for |x| < 1e5 in double builds and
+/// |x| < 1e3 in float builds; larger arguments lose accuracy gradually.
+inline void sin_cos(Rv x, Rv& s, Rv& c) {
+  const Rv j = round(x * Rv((R)0.63661977236758134308));  // 2/pi
+#ifdef KX_MATH_FLOAT
+  Rv r = x - j * Rv(1.5703125f);
+  r = r - j * Rv(4.837512969970703125e-4f);
+  r = r - j * Rv(7.54978995489188216e-8f);
+#else
+  Rv r = x - j * Rv(1.57079625129699707031);
+  r = r - j * Rv(7.54978941586159635336e-8);
+  r = r - j * Rv(5.39030285815811905290e-15);
+#endif
+
+  const Rv z = r * r;
+  Rv ps = Rv((R)1.58962301576546568060e-10);
+  ps = ps * z + Rv((R)-2.50507477628578072866e-8);
+  ps = ps * z + Rv((R)2.75573136213857245213e-6);
+  ps = ps * z + Rv((R)-1.98412698295895385996e-4);
+  ps = ps * z + Rv((R)8.33333333332211858878e-3);
+  ps = ps * z + Rv((R)-1.66666666666666307295e-1);
+  const Rv sr = r + r * z * ps;
+
+  Rv pc = Rv((R)-1.13585365213876817300e-11);
+  pc = pc * z + Rv((R)2.08757008419747316778e-9);
+  pc = pc * z + Rv((R)-2.75573141792967388112e-7);
+  pc = pc * z + Rv((R)2.48015872888517045348e-5);
+  pc = pc * z + Rv((R)-1.38888888888730564116e-3);
+  pc = pc * z + Rv((R)4.16666666666665929218e-2);
+  const Rv cr = Rv(1) - Rv((R)0.5) * z + z * z * pc;
+
+  // Quadrant q = j mod 4 selects the octant identities:
+  //   q = 0: ( sr,  cr)    q = 1: ( cr, -sr)
+  //   q = 2: (-sr, -cr)    q = 3: (-cr,  sr)
+  const Rv q = j - Rv(4) * round((j - Rv((R)1.5)) * Rv((R)0.25));
+  const Mask q1 = (q > Rv((R)0.5)) & (q < Rv((R)1.5));
+  const Mask q2 = (q > Rv((R)1.5)) & (q < Rv((R)2.5));
+  const Mask q3 = q > Rv((R)2.5);
+  const Mask swap = q1 | q3;
+  const Rv s0 = select(swap, cr, sr);
+  const Rv c0 = select(swap, sr, cr);
+  s = select(q2 | q3, -s0, s0);
+  c = select(q1 | q2, -c0, c0);
+}
+
+/// Compute the arc tangent of each lane.
+///
+/// This is the Cephes rational approximation with range reduction about
+/// tan(pi/8) and tan(3pi/8). The maximum error is below 2 ULP.
+inline Rv atan(Rv x) {
+  const Rv ax = abs(x);
+  const Mask big = ax > Rv((R)2.41421356237309504880);  // tan(3pi/8)
+  const Mask mid = (ax > Rv((R)0.66)) & (ax <= Rv((R)2.41421356237309504880));
+
+  // Reduce: big -> -1/x, mid -> (x-1)/(x+1).
+  Rv t = select(big, Rv(-1) / ax, ax);
+  t = select(mid, (ax - Rv(1)) / (ax + Rv(1)), t);
+  const Rv y0 = select(big, Rv((R)1.57079632679489661923),
+                       select(mid, Rv((R)0.78539816339744830962), Rv(0)));
+  const Rv more = select(big, Rv((R)6.123233995736765886130e-17),
+                         select(mid, Rv((R)3.061616997868382943065e-17), Rv(0)));
+
+  const Rv z = t * t;
+  Rv p = Rv((R)-8.750608600031904122785e-1);
+  p = p * z + Rv((R)-1.615753718733365076637e1);
+  p = p * z + Rv((R)-7.500855792314704667340e1);
+  p = p * z + Rv((R)-1.228866684490136173410e2);
+  p = p * z + Rv((R)-6.485021904942025371773e1);
+  Rv q = z + Rv((R)2.485846490142306297962e1);
+  q = q * z + Rv((R)1.650270098316988542046e2);
+  q = q * z + Rv((R)4.328810604912902668951e2);
+  q = q * z + Rv((R)4.853903996359136964868e2);
+  q = q * z + Rv((R)1.945506571482613964425e2);
+  const Rv r = y0 + (t * z * (p / q) + t + more);
+
+  return select(x < Rv(0), -r, r);
+}
+
+//
+// Exponentials and logarithms. The exponent and mantissa fields of the lanes
+// are taken apart and put together with the bit operations above; the
+// polynomials are truncated Taylor series, with enough terms that the
+// truncation error is below half an ULP.
+//
+
+#ifdef KX_MATH_FLOAT
+const int kMantissaBits = 23;
+const int kExponentBias = 127;
+#else
+const int kMantissaBits = 52;
+const int kExponentBias = 1023;
+#endif
+
+/// Compute 2^x for each lane.
+///
+/// x is clamped to the exponent range of normal numbers, so the result
+/// neither overflows nor becomes subnormal. The maximum error is 2 ULP.
+inline Rv exp2(Rv x) {
+  x = min(max(x, Rv(R(1 - kExponentBias))), Rv(R(kExponentBias)));
+  const Rv n = round(x);
+  const Rv g = (x - n) * Rv((R)0.69314718055994530942);  // |g| <= ln(2)/2
+
+  // e^g = sum g^k/k!, up to k = 7 for floats and k = 13 for doubles. The
+  // even and odd terms from k = 2 are summed separately, as polynomials in
+  // g^2, to shorten the chain of dependent operations; 1 + g is added last.
+  const Rv g2 = g * g;
+#ifdef KX_MATH_FLOAT
+  Rv pe = Rv(1.38888888888888888889e-3f);
+  Rv po = Rv(1.98412698412698412698e-4f);
+#else
+  Rv pe = Rv(2.08767569878680989792e-9);
+  Rv po = Rv(1.60590438368216145994e-10);
+  pe = pe * g2 + Rv(2.75573192239858906526e-7);
+  po = po * g2 + Rv(2.50521083854417187751e-8);
+  pe = pe * g2 + Rv(2.48015873015873015873e-5);
+  po = po * g2 + Rv(2.75573192239858906526e-6);
+  pe = pe * g2 + Rv(1.38888888888888888889e-3);
+  po = po * g2 + Rv(1.98412698412698412698e-4);
+#endif
+  pe = pe * g2 + Rv((R)4.16666666666666666667e-2);
+  po = po * g2 + Rv((R)8.33333333333333333333e-3);
+  pe = pe * g2 + Rv((R)0.5);
+  po = po * g2 + Rv((R)1.66666666666666666667e-1);
+  const Rv p = Rv(1) + (g + g2 * (pe + g * po));
+
+  // 2^n: adding 2^M puts n + bias in the low bits of the mantissa, from
+  // where a shift moves it to the exponent field.
+  const R two_m = R(Bits(1) << kMantissaBits);
+  const Rv scale = shift_left<kMantissaBits>(n + Rv(two_m + kExponentBias));
+  return p * scale;
+}
+
+/// Compute the base 2 logarithm of each lane.
+///
+/// x must be a positive normal number. The maximum error is 2 ULP of
+/// max(1, |log2(x)|).
+inline Rv log2(Rv x) {
+  // x = m * 2^e with m in [1,2). The exponent field, shifted down into the
+  // mantissa of 2^M, reads as 2^M + e + bias.
+  const R two_m = R(Bits(1) << kMantissaBits);
+  const Rv biased = bit_or(shift_right<kMantissaBits>(x), Rv(two_m));
+  Rv e = biased - Rv(two_m + kExponentBias);
+  Rv m = bit_or(bit_and(x, from_bits((Bits(1) << kMantissaBits) - 1)), Rv(1));
+
+  // Centre m on 1, in [sqrt(2)/2, sqrt(2)).
+  const Mask big = m > Rv((R)1.41421356237309504880);
+  m = select(big, m * Rv((R)0.5), m);
+  e = select(big, e + Rv(1), e);
+
+  // log2(m) = 2/ln(2) * atanh(t) = 2/ln(2) * sum t^(2k+1)/(2k+1), with
+  // t = (m-1)/(m+1) and |t| < 0.172, up to k = 4 for floats and k = 9 for
+  // doubles. As in exp2(), the sum is split in two polynomials in t^4.
+  const Rv t = (m - Rv(1)) / (m + Rv(1));
+  const Rv z = t * t;
+  const Rv z2 = z * z;
+#ifdef KX_MATH_FLOAT
+  Rv pe = Rv(1.11111111111111111111e-1f);
+  Rv po = Rv(1.42857142857142857143e-1f);
+#else
+  Rv pe = Rv(5.88235294117647058824e-2);
+  Rv po = Rv(5.26315789473684210526e-2);
+  pe = pe * z2 + Rv(7.69230769230769230769e-2);
+  po = po * z2 + Rv(6.66666666666666666667e-2);
+  pe = pe * z2 + Rv(1.11111111111111111111e-1);
+  po = po * z2 + Rv(9.09090909090909090909e-2);
+  po = po * z2 + Rv(1.42857142857142857143e-1);
+#endif
+  pe = pe * z2 + Rv((R)0.2);
+  po = po * z2 + Rv((R)3.33333333333333333333e-1);
+  pe = pe * z2 + Rv(1);
+  const Rv p = pe + z * po;
+  return e + t * p * Rv((R)2.88539008177792681472);  // 2/ln(2)
+}
+
+/// Compute x^y for each lane, as 2^(y log2(x)).
+///
+/// x must be zero or a positive normal number, and y must be positive; 0^y
+/// is 0. The error is at most 2 + 2|y log2(x)| ULP: log2(x) is rounded
+/// before it is scaled by y, and an absolute error d in the exponent becomes
+/// a relative error of ln(2) d in the result.
+inline Rv pow(Rv x, Rv y) {
+  const Rv r = exp2(y * log2(max(x, Rv(FLT_MIN))));
+  return select(x > Rv(0), r, Rv(0));
+}
+
+}  // namespace simd
+}  // namespace kx
+
+/** @} */
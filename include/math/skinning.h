@@ -0,0 +1,70 @@
+#pragma once
+
+#include <math/dualquat.h>
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <cstddef>
+
+/** @defgroup skinning Skinning Functions
+ * This module deforms meshes by a palette of joint transformations.
+ *
+ * Each palette entry is the joint's skinning transformation, that is, the
+ * joint's current transformation composed with the inverse of its bind pose.
+ * Every vertex is influenced by up to SkinWeights::max_influences joints.
+ *
+ * The functions process vertices in chunks spread across threads (see
+ * parallel.h) and use SIMD instructions within each chunk. Positions and
+ * normals are read from and written to separate arrays; output arrays must not
+ * overlap input arrays.
+ *
+ * @{
+ */
+
+namespace kx {
+
+/// The joint influences of a vertex.
+struct SkinWeights {
+  enum { max_influences = 4 };
+
+  /// Indices of the influencing joints in the palette.
+  unsigned short joints[max_influences];
+
+  /// Blend weights, one per joint. Weights should add up to 1; unused
+  /// influences must have a weight of 0.
+  R weights[max_influences];
+};
+
+/// Skin vertices with linear blend skinning.
+/// Each vertex is transformed by the weighted sum of its joints' matrices.
+/// Normals are transformed by the blended matrix and renormalised, which is
+/// exact as long as the palette does not contain non-uniform scaling.
+/// \param palette       Skinning matrices.
+/// \param weights       Joint influences, one per vertex.
+/// \param positions     Bind-pose positions.
+/// \param normals       Bind-pose normals, or null to skip normals.
+/// \param n             Number of vertices.
+/// \param out_positions Skinned positions.
+/// \param out_normals   Skinned normals; ignored if normals is null.
+void skin_linear(const mat4* palette, const SkinWeights* weights,
+                 const vec3* positions, const vec3* normals, std::size_t n,
+                 vec3* out_positions, vec3* out_normals);
+
+/// Skin vertices with dual quaternion skinning.
+/// Each vertex is transformed by the normalised weighted sum of its joints'
+/// dual quaternions. Unlike linear blend skinning this preserves volume around
+/// twisting joints, but the palette must only contain rigid transformations.
+/// \param palette       Skinning transformations as unit dual quaternions.
+/// \param weights       Joint influences, one per vertex.
+/// \param positions     Bind-pose positions.
+/// \param normals       Bind-pose normals, or null to skip normals.
+/// \param n             Number of vertices.
+/// \param out_positions Skinned positions.
+/// \param out_normals   Skinned normals; ignored if normals is null.
+void skin_dual_quat(const dualquat* palette, const SkinWeights* weights,
+                    const vec3* positions, const vec3* normals, std::size_t n,
+                    vec3* out_positions, vec3* out_normals);
+
+}  // namespace kx
+
+/** @} */
@@ -3,15 +3,30 @@
 #include <math/mat4.h>
 #include <math/vec3.h>
 
+#include <cstdint>
+
 namespace kx {
 
 /// An object in 3D space.
+///
+/// The transformation matrix and its inverse are cached, and recomputed on
+/// the first query after the spatial changes. The caches are filled by const
+/// functions, so a spatial that has changed must not be queried from several
+/// threads at once; query it once before sharing it.
 class Spatial {
   vec3 r;
   vec3 u;
   vec3 f;
   vec3 p;
 
+  std::uint64_t version_;
+  mutable std::uint64_t cached_version_;
+  mutable mat4 transform_;
+  mutable mat4 inverse_transform_;
+
+  /// Record a change to the spatial.
+  void touch();
+
  public:
   /// Construct a degenerate spatial with position 0 and direction vectors 0.
   KX_MATH_API Spatial();
@@ -143,11 +158,19 @@ class Spatial {
 
   /// Return the spatial's transformation matrix (from spatial to world
   /// coordinates).
-  KX_MATH_API mat4 transform() const;
+  KX_MATH_API const mat4& transform() const;
 
   /// Return the spatial's inverse transformation matrix (from world to spatial
   /// coordinates).
-  KX_MATH_API mat4 inverseTransform() const;
+  KX_MATH_API const mat4& inverseTransform() const;
+
+  /// Return the spatial's version, which changes with every change to its
+  /// position or orientation.
+  /// Versions are unique across all spatials, and copies share their
+  /// source's version, so two spatials with the same version are in the same
+  /// state. Objects derived from a spatial can compare versions to tell
+  /// whether it has changed since they were computed.
+  KX_MATH_API std::uint64_t version() const { return version_; }
 };
 
 }  // namespace kx
@@ -26,8 +26,11 @@ struct Sphere {
       : center(cx, cy, cz), radius2(r2) {}
 
   /// Update the sphere to contain the given point.
-  /// The sphere's center is not moved, only its radius may change.
-  KX_MATH_API void add(vec3 p) { radius2 = max(radius2, norm2(p)); }
+  /// The sphere's center is not moved, only its radius may change. To bound
+  /// a set of points tightly, use bounding_sphere().
+  KX_MATH_API void add(vec3 p) {
+    radius2 = max(radius2, norm2(p - center));
+  }
 
   /// Return the sphere's radius.
   KX_MATH_API R radius() const { return sqrt(radius2); }
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <math/AABB3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kx {
+
+/// A pair of overlapping boxes, by index, with a < b.
+struct BoxPair {
+  std::uint32_t a, b;
+};
+
+/// A sweep-and-prune broad phase: finds the pairs of overlapping boxes in a
+/// set that moves from frame to frame.
+///
+/// The broad phase keeps the boxes' endpoints sorted along one or three axes
+/// between updates. Boxes move little from one frame to the next, so the
+/// endpoints stay nearly sorted and an insertion sort restores their order in
+/// close to linear time.
+///
+/// - With one axis, each update sorts the boxes' minima along the axis along
+///   which their centers spread most, then sweeps the sorted boxes, testing
+///   each against the boxes that start before it ends, a SIMD register at a
+///   time. Large sets are swept in parallel (see parallel_for()).
+/// - With three axes, the set of overlapping pairs is kept from frame to
+///   frame: the insertion sorts add a pair when two boxes start to overlap
+///   along an axis, and remove it when they stop. This does less work than
+///   the sweep when few boxes move, but runs on one thread.
+///
+/// Boxes that touch overlap, as in intersect(const AABB3&, const AABB3&).
+class SweepAndPrune {
+ public:
+  enum class Axes { one, three };
+
+  /// Construct an empty broad phase that sorts along the given axes.
+  explicit SweepAndPrune(Axes axes = Axes::one);
+
+  /// Update the broad phase with the boxes' new positions, and find the
+  /// pairs that overlap. Box i of an update must be the same object as box i
+  /// of the previous one; if the number of boxes changes, the broad phase
+  /// starts over.
+  void update(const AABB3* boxes, std::size_t n);
+
+  /// Return the pairs of overlapping boxes found by the last update, in no
+  /// particular order.
+  const std::vector<BoxPair>& pairs() const { return pairs_; }
+
+  /// Forget the boxes, so that the next update starts over.
+  void clear();
+
+ private:
+  /// An endpoint of a box along an axis, for sorting. 'id' holds the box's
+  /// index, shifted left by one, with the low bit set for maxima.
+  struct Endpoint {
+    R value;
+    std::uint32_t id;
+  };
+
+  /// A set of box pairs, hashed with open addressing.
+  class PairSet {
+   public:
+    void clear(std::size_t capacity);
+    void insert(std::uint64_t key);
+    void erase(std::uint64_t key);
+    void get(std::vector<BoxPair>& out) const;
+
+   private:
+    std::size_t slot(std::uint64_t key) const;
+
+    std::vector<std::uint64_t> keys_;
+    std::size_t size_;
+  };
+
+  void start(const AABB3* boxes, std::size_t n);
+  void sweep(const AABB3* boxes);
+  void sweep(std::size_t begin, std::size_t end,
+             std::vector<BoxPair>& out) const;
+  void sort(const AABB3* boxes, int axis);
+
+  Axes axes_;
+  std::size_t n_;
+  int axis_;  // the axis swept
+  std::vector<Endpoint> sorted_[3];  // minima, or all endpoints with 3 axes
+  std::vector<std::uint32_t> order_;  // the boxes in sweep order
+  std::vector<R> lo_[3], hi_[3];      // and their bounds
+  std::vector<std::vector<BoxPair>> chunks_;
+  PairSet set_;
+  std::vector<BoxPair> pairs_;
+};
+
+}  // namespace kx
@@ -2,6 +2,10 @@
 
 #include <math/vec3.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace kx {
 
 /// A 3D triangle.
@@ -16,4 +20,11 @@ struct Triangle3 {
       : p0(p0), p1(p1), p2(p2) {}
 };
 
+/// Return the triangles of an indexed mesh: triangle i has the vertices
+/// indices[3i], indices[3i+1] and indices[3i+2].
+/// Large meshes are converted in parallel (see parallel.h).
+std::vector<Triangle3> mesh_triangles(const vec3* vertices,
+                                      const std::uint32_t* indices,
+                                      std::size_t num_triangles);
+
 }  // namespace kx
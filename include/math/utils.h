@@ -5,10 +5,9 @@
 #include <math/mat4.h>
 #include <math/quat.h>
 
-namespace kx {
+#include <cstddef>
 
-class mat3;
-struct quat;
+namespace kx {
 
 /// Compare two floating-point numbers for equality.
 ///
@@ -26,14 +25,21 @@ KX_MATH_API bool R_eq(R a, R b, R eps, int ULPs);
 
 /// Construct a 3x3 matrix representing the same rotation as the given
 /// quaternion.
-KX_MATH_API mat3 qmat3(const quat& q);
+template <typename T>
+KX_MATH_API mat3T<T> qmat3(const quatT<T>& q);
 
 /// Construct a 4x4 matrix representing the same rotation as the given
 /// quaternion.
-KX_MATH_API mat4 qmat4(const quat& q);
+template <typename T>
+KX_MATH_API mat4T<T> qmat4(const quatT<T>& q);
+
+/// Construct the 3x3 rotation matrices of an array of quaternions.
+/// This is the batch version of qmat3() and uses SIMD instructions.
+void qmat3(const quat* q, mat3* out, std::size_t n);
 
-/// Return the sign of the given value.
-KX_MATH_API R sign(R x);
+/// Construct the 4x4 rotation matrices of an array of quaternions.
+/// This is the batch version of qmat4() and uses SIMD instructions.
+void qmat4(const quat* q, mat4* out, std::size_t n);
 
 /// Return the pitch formed by the given forward vector.
 KX_MATH_API R pitch_from_fwd(vec3 forward);
@@ -1,124 +1,225 @@
 #pragma once
 
 #include <math/defs.h>
+#include <math/fwd.h>
 
 namespace kx {
 
 /// A 2D vector.
-struct vec2 {
-  R x;
-  R y;
+template <typename T>
+struct vec2T {
+  T x;
+  T y;
 
   /// Construct the 0 vector.
-  KX_MATH_API vec2() : x(0), y(0) {}
+  KX_MATH_API constexpr vec2T() : x(0), y(0) {}
 
   /// Construct a vector from 2 coordinates.
-  KX_MATH_API vec2(R x, R y) : x(x), y(y) {}
+  KX_MATH_API constexpr vec2T(T x, T y) : x(x), y(y) {}
 
   /// Construct a vector from a value.
   /// x = y = val
-  KX_MATH_API vec2(R val) : x(val), y(val) {}
+  KX_MATH_API constexpr vec2T(T val) : x(val), y(val) {}
+
+  /// Convert a vector of a different precision.
+  template <typename U>
+  KX_MATH_API constexpr explicit vec2T(const vec2T<U>& v)
+      : x(T(v.x)), y(T(v.y)) {}
 
   /// Normalise the vector.
   KX_MATH_API void normalise() {
-    R n = std::sqrt(x * x + y * y);
-    n = n == 0.0f ? 1.0f : n;
+    T n = std::sqrt(x * x + y * y);
+    n = n == T(0) ? T(1) : n;
     x /= n;
     y /= n;
   }
 
-  /// Return a const R pointer to the given vector's values.
-  KX_MATH_API operator const R*() const { return (R*)this; }
+  /// Return a const T pointer to the given vector's values.
+  KX_MATH_API operator const T*() const { return (T*)this; }
 };
 
 /// Negate the given vector.
-inline KX_MATH_API vec2 operator-(vec2 a) { return vec2(-a.x, -a.y); }
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator-(vec2T<T> a) {
+  return vec2T<T>(-a.x, -a.y);
+}
 
 /// Add two vectors.
-inline KX_MATH_API vec2 operator+(vec2 a, vec2 b) {
-  return vec2(a.x + b.x, a.y + b.y);
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator+(vec2T<T> a, vec2T<T> b) {
+  return vec2T<T>(a.x + b.x, a.y + b.y);
 }
 
 /// Subtract two vectors.
-inline KX_MATH_API vec2 operator-(vec2 a, vec2 b) {
-  return vec2(a.x - b.x, a.y - b.y);
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator-(vec2T<T> a, vec2T<T> b) {
+  return vec2T<T>(a.x - b.x, a.y - b.y);
 }
 
 /// Modulate two vectors (component-wise multiplication).
-inline KX_MATH_API vec2 operator*(vec2 a, vec2 b) {
-  return vec2(a.x * b.x, a.y * b.y);
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator*(vec2T<T> a, vec2T<T> b) {
+  return vec2T<T>(a.x * b.x, a.y * b.y);
 }
 
 /// Divide two vectors component-wise.
-inline KX_MATH_API vec2 operator/(vec2 a, vec2 b) {
-  return vec2(a.x / b.x, a.y / b.y);
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator/(vec2T<T> a, vec2T<T> b) {
+  return vec2T<T>(a.x / b.x, a.y / b.y);
+}
+
+/// Add a scalar to each component.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator+(vec2T<T> a, NoDeduce<T> s) {
+  return a + vec2T<T>(s);
+}
+
+/// Add a scalar to each component.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator+(NoDeduce<T> s, vec2T<T> a) {
+  return vec2T<T>(s) + a;
+}
+
+/// Subtract a scalar from each component.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator-(vec2T<T> a, NoDeduce<T> s) {
+  return a - vec2T<T>(s);
+}
+
+/// Subtract each component from a scalar.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator-(NoDeduce<T> s, vec2T<T> a) {
+  return vec2T<T>(s) - a;
+}
+
+/// Scale the vector.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator*(vec2T<T> a, NoDeduce<T> s) {
+  return vec2T<T>(a.x * s, a.y * s);
+}
+
+/// Scale the vector.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator*(NoDeduce<T> s, vec2T<T> a) {
+  return vec2T<T>(s * a.x, s * a.y);
+}
+
+/// Divide each component by a scalar.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator/(vec2T<T> a, NoDeduce<T> s) {
+  return vec2T<T>(a.x / s, a.y / s);
+}
+
+/// Divide a scalar by each component.
+template <typename T>
+constexpr KX_MATH_API vec2T<T> operator/(NoDeduce<T> s, vec2T<T> a) {
+  return vec2T<T>(s / a.x, s / a.y);
 }
 
 /// Add two vectors.
-inline KX_MATH_API void operator+=(vec2& a, vec2 b) {
+template <typename T>
+inline KX_MATH_API void operator+=(vec2T<T>& a, vec2T<T> b) {
   a.x += b.x;
   a.y += b.y;
 }
 
 /// Subtract two vectors.
-inline KX_MATH_API void operator-=(vec2& a, vec2 b) {
+template <typename T>
+inline KX_MATH_API void operator-=(vec2T<T>& a, vec2T<T> b) {
   a.x -= b.x;
   a.y -= b.y;
 }
 
 /// Modulate two vectors (component-wise multiplication).
-inline KX_MATH_API void operator*=(vec2& a, vec2 b) {
+template <typename T>
+inline KX_MATH_API void operator*=(vec2T<T>& a, vec2T<T> b) {
   a.x *= b.x;
   a.y *= b.y;
 }
 
 /// Divide two vectors component-wise.
-inline KX_MATH_API void operator/=(vec2& a, vec2 b) {
+template <typename T>
+inline KX_MATH_API void operator/=(vec2T<T>& a, vec2T<T> b) {
   a.x /= b.x;
   a.y /= b.y;
 }
 
+/// Scale the vector.
+template <typename T>
+inline KX_MATH_API void operator*=(vec2T<T>& a, NoDeduce<T> s) {
+  a.x *= s;
+  a.y *= s;
+}
+
+/// Divide each component by a scalar.
+template <typename T>
+inline KX_MATH_API void operator/=(vec2T<T>& a, NoDeduce<T> s) {
+  a.x /= s;
+  a.y /= s;
+}
+
 /// Compare two vectors.
-inline KX_MATH_API bool operator!=(vec2& a, const vec2& b) {
+template <typename T>
+constexpr KX_MATH_API bool operator!=(const vec2T<T>& a, const vec2T<T>& b) {
   return a.x != b.x || a.y != b.y;
 }
 
+/// Compare two vectors.
+template <typename T>
+constexpr KX_MATH_API bool operator==(const vec2T<T>& a, const vec2T<T>& b) {
+  return a.x == b.x && a.y == b.y;
+}
+
 /// Return the vector's magnitude.
-inline KX_MATH_API R norm(vec2 v) { return std::sqrt(v.x * v.x + v.y * v.y); }
+template <typename T>
+inline KX_MATH_API T norm(vec2T<T> v) {
+  return std::sqrt(v.x * v.x + v.y * v.y);
+}
 
 /// Return the vector's squared magnitude.
-inline KX_MATH_API R norm2(vec2 v) { return v.x * v.x + v.y * v.y; }
+template <typename T>
+constexpr KX_MATH_API T norm2(vec2T<T> v) {
+  return v.x * v.x + v.y * v.y;
+}
 
 /// Return the distance between two points.
-inline KX_MATH_API R dist(vec2 a, vec2 b) {
-  vec2 v = a - b;
+template <typename T>
+inline KX_MATH_API T dist(vec2T<T> a, vec2T<T> b) {
+  vec2T<T> v = a - b;
   return std::sqrt(v.x * v.x + v.y * v.y);
 }
 
 /// Return the squared distance between two points.
-inline KX_MATH_API R dist2(vec2 a, vec2 b) {
-  vec2 v = a - b;
+template <typename T>
+inline KX_MATH_API T dist2(vec2T<T> a, vec2T<T> b) {
+  vec2T<T> v = a - b;
   return v.x * v.x + v.y * v.y;
 }
 
 /// Return the vector divided by its magnitude.
-inline KX_MATH_API vec2 normalise(vec2 v) {
-  R n = sqrt(v.x * v.x + v.y * v.y);
-  n = n == 0.0 ? 1.0 : n;
-  return vec2(v.x / n, v.y / n);
+template <typename T>
+inline KX_MATH_API vec2T<T> normalise(vec2T<T> v) {
+  T n = std::sqrt(v.x * v.x + v.y * v.y);
+  n = n == T(0) ? T(1) : n;
+  return vec2T<T>(v.x / n, v.y / n);
 }
 
 /// Return vectors' dot product.
-inline KX_MATH_API R dot(vec2 a, vec2 b) { return a.x * b.x + a.y * b.y; }
+template <typename T>
+constexpr KX_MATH_API T dot(vec2T<T> a, vec2T<T> b) {
+  return a.x * b.x + a.y * b.y;
+}
 
 /// Reflect the vector about a normal.
-inline KX_MATH_API vec2 reflect(vec2 v, vec2 n) {
+template <typename T>
+constexpr KX_MATH_API vec2T<T> reflect(vec2T<T> v, vec2T<T> n) {
   return (-2 * dot(v, n)) * n + v;
 }
 
 /// Swap the two vectors.
-inline void swap(vec2& a, vec2& b) {
-  vec2 tmp = a;
+template <typename T>
+inline void swap(vec2T<T>& a, vec2T<T>& b) {
+  vec2T<T> tmp = a;
   a = b;
   b = tmp;
 }
@@ -1,81 +1,121 @@
 #pragma once
 
 #include <math/defs.h>
+#include <math/fwd.h>
 
 namespace kx {
 
-struct vec3;
-
 /// A 4D vector.
-struct vec4 {
-  R x;
-  R y;
-  R z;
-  R w;
+template <typename T>
+struct vec4T {
+  T x;
+  T y;
+  T z;
+  T w;
 
   /// Construct the 0 vector.
-  KX_MATH_API vec4() : x(0), y(0), z(0), w(0) {}
+  KX_MATH_API constexpr vec4T() : x(0), y(0), z(0), w(0) {}
 
   /// Construct a vector from 4 coordinates.
-  KX_MATH_API vec4(R _x, R _y, R _z, R _w) : x(_x), y(_y), z(_z), w(_w) {}
+  KX_MATH_API constexpr vec4T(T _x, T _y, T _z, T _w)
+      : x(_x), y(_y), z(_z), w(_w) {}
+
+  /// Convert a vector of a different precision.
+  template <typename U>
+  KX_MATH_API constexpr explicit vec4T(const vec4T<U>& v)
+      : x(T(v.x)), y(T(v.y)), z(T(v.z)), w(T(v.w)) {}
 
   /// Construct a vector from a value.
   /// x = y = z = w = val
-  KX_MATH_API vec4(R val) : x(val), y(val), z(val), w(val) {}
+  KX_MATH_API constexpr vec4T(T val) : x(val), y(val), z(val), w(val) {}
 
   /// Construct a vector from a 3d vector and a w-coordinate.
-  KX_MATH_API vec4(const vec3&, R w);
+  KX_MATH_API constexpr vec4T(const vec3T<T>& v, T w)
+      : x(v.x), y(v.y), z(v.z), w(w) {}
 
   /// Normalise the vector.
   KX_MATH_API void normalise();
 
-  /// Return a const R pointer to the given vector's values.
-  KX_MATH_API operator const R*() const { return (R*)this; }
+  /// Return a const T pointer to the given vector's values.
+  KX_MATH_API operator const T*() const { return (T*)this; }
 };
 
-KX_MATH_API vec4 normalise(const vec4&);
-
 /// Negate the given vector.
-KX_MATH_API vec4 operator-(vec4);
+template <typename T>
+KX_MATH_API vec4T<T> operator-(vec4T<T>);
 
 /// Add two vectors.
-KX_MATH_API vec4 operator+(vec4, vec4);
+template <typename T>
+KX_MATH_API vec4T<T> operator+(vec4T<T>, vec4T<T>);
 
 /// Subtract two vectors.
-KX_MATH_API vec4 operator-(vec4, vec4);
+template <typename T>
+KX_MATH_API vec4T<T> operator-(vec4T<T>, vec4T<T>);
 
 /// Modulate two vectors (component-wise multiplication).
-KX_MATH_API vec4 operator*(vec4, vec4);
+template <typename T>
+KX_MATH_API vec4T<T> operator*(vec4T<T>, vec4T<T>);
 
 /// Divide two vectors component-wise.
-KX_MATH_API vec4 operator/(vec4, vec4);
+template <typename T>
+KX_MATH_API vec4T<T> operator/(vec4T<T>, vec4T<T>);
+
+/// Scale the vector.
+template <typename T>
+inline KX_MATH_API vec4T<T> operator*(vec4T<T> a, NoDeduce<T> s) {
+  return a * vec4T<T>(s);
+}
+
+/// Scale the vector.
+template <typename T>
+inline KX_MATH_API vec4T<T> operator*(NoDeduce<T> s, vec4T<T> a) {
+  return vec4T<T>(s) * a;
+}
+
+/// Divide each component by a scalar.
+template <typename T>
+inline KX_MATH_API vec4T<T> operator/(vec4T<T> a, NoDeduce<T> s) {
+  return a / vec4T<T>(s);
+}
 
 /// Add two vectors.
-KX_MATH_API void operator+=(vec4&, vec4);
+template <typename T>
+KX_MATH_API void operator+=(vec4T<T>&, vec4T<T>);
 
 /// Subtract two vectors.
-KX_MATH_API void operator-=(vec4&, vec4);
+template <typename T>
+KX_MATH_API void operator-=(vec4T<T>&, vec4T<T>);
 
 /// Modulate two vectors (component-wise multiplication).
-KX_MATH_API void operator*=(vec4&, vec4);
+template <typename T>
+KX_MATH_API void operator*=(vec4T<T>&, vec4T<T>);
 
 /// Divide two vectors component-wise.
-KX_MATH_API void operator/=(vec4&, vec4);
+template <typename T>
+KX_MATH_API void operator/=(vec4T<T>&, vec4T<T>);
 
 /// Return the given vector divided by its magnitude.
-KX_MATH_API vec4 normalise(const vec4& v);
+template <typename T>
+KX_MATH_API vec4T<T> normalise(const vec4T<T>& v);
 
 /// Return the vector's magnitude.
-KX_MATH_API R norm(vec4 v);
+template <typename T>
+KX_MATH_API T norm(vec4T<T> v);
 
 /// Return the vector's squared magnitude.
-KX_MATH_API R norm2(vec4 v);
+template <typename T>
+KX_MATH_API T norm2(vec4T<T> v);
 
 /// Swap the two vectors.
-inline void swap(vec4& a, vec4& b) {
-  vec4 tmp = a;
+template <typename T>
+inline void swap(vec4T<T>& a, vec4T<T>& b) {
+  vec4T<T> tmp = a;
   a = b;
   b = tmp;
 }
 
 }  // namespace kx
+
+#ifdef KX_MATH_INLINE
+#include <math/vec4.inl>
+#endif
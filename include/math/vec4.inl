@@ -0,0 +1,94 @@
+#pragma once
+
+// Definitions of the vec4 primitives that may be inlined.
+//
+// This file is included by vec4.h when KX_MATH_INLINE is defined, and by
+// vec4.cc otherwise. See defs.h.
+
+namespace kx {
+
+template <typename T>
+KX_MATH_INL KX_MATH_API void vec4T<T>::normalise() {
+  T n = std::sqrt(x * x + y * y + z * z + w * w);
+  n = n == T(0) ? T(1) : n;
+  x /= n;
+  y /= n;
+  z /= n;
+  w /= n;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T> operator-(vec4T<T> a) {
+  return vec4T<T>(-a.x, -a.y, -a.z, -a.w);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T> operator+(vec4T<T> a, vec4T<T> b) {
+  return vec4T<T>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T> operator-(vec4T<T> a, vec4T<T> b) {
+  return vec4T<T>(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T> operator*(vec4T<T> a, vec4T<T> b) {
+  return vec4T<T>(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T> operator/(vec4T<T> a, vec4T<T> b) {
+  return vec4T<T>(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API void operator+=(vec4T<T>& a, vec4T<T> b) {
+  a.x += b.x;
+  a.y += b.y;
+  a.z += b.z;
+  a.w += b.w;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API void operator-=(vec4T<T>& a, vec4T<T> b) {
+  a.x -= b.x;
+  a.y -= b.y;
+  a.z -= b.z;
+  a.w -= b.w;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API void operator*=(vec4T<T>& a, vec4T<T> b) {
+  a.x *= b.x;
+  a.y *= b.y;
+  a.z *= b.z;
+  a.w *= b.w;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API void operator/=(vec4T<T>& a, vec4T<T> b) {
+  a.x /= b.x;
+  a.y /= b.y;
+  a.z /= b.z;
+  a.w /= b.w;
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API vec4T<T> normalise(const vec4T<T>& v) {
+  T n = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+  n = n == T(0) ? T(1) : n;
+  return vec4T<T>(v.x / n, v.y / n, v.z / n, v.w / n);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API T norm(vec4T<T> v) {
+  return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+}
+
+template <typename T>
+KX_MATH_INL KX_MATH_API T norm2(vec4T<T> v) {
+  return v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w;
+}
+
+}  // namespace kx
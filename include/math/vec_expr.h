@@ -0,0 +1,373 @@
+#pragma once
+
+//
+// Expression templates over arrays of vectors.
+//
+// Arithmetic on array expressions builds a tree of small nodes instead of
+// computing anything; evaluate() then walks the arrays once and computes
+// every element of the result in a single loop, without intermediate
+// buffers. For example, the array version of interpolate():
+//
+//   VecArray<vec3> a = vec_array(p0, n);
+//   VecArray<vec3> b = vec_array(p1, n);
+//   VecArray<vec3> c = vec_array(p2, n);
+//   VecArray<vec2> uv = vec_array(st, n);
+//   evaluate(out, a + get_x(uv) * (b - a) + get_y(uv) * (c - a));
+//
+// reads p0, p1, p2 and st once and writes out once, where the same chain on
+// std::vector<vec3> values would make a pass over memory per operator.
+//
+// Operands may be array expressions, single vectors or scalars; single
+// values are broadcast to every element. Arrays of scalars (scalar_array())
+// scale vectors element-wise. Nodes hold their operands by value and the
+// leaves only hold a pointer, so expressions are cheap to build and to copy,
+// but the arrays must outlive them.
+//
+
+#include <math/parallel.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kx {
+
+/// Base of the array expressions.
+/// Every expression E has a value_type, returns its ith element through
+/// E::operator[] and its length through E::size().
+template <typename E>
+struct VecExpr {
+  const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/// An array of vectors or scalars.
+template <typename V>
+class VecArray : public VecExpr<VecArray<V>> {
+  const V* data_;
+  std::size_t n_;
+
+ public:
+  using value_type = V;
+
+  VecArray(const V* data, std::size_t n) : data_(data), n_(n) {}
+
+  V operator[](std::size_t i) const { return data_[i]; }
+  std::size_t size() const { return n_; }
+};
+
+/// A single value repeated over any length.
+template <typename V>
+class VecUniform : public VecExpr<VecUniform<V>> {
+  V value_;
+
+ public:
+  using value_type = V;
+
+  explicit VecUniform(const V& value) : value_(value) {}
+
+  V operator[](std::size_t) const { return value_; }
+  std::size_t size() const { return std::numeric_limits<std::size_t>::max(); }
+};
+
+/// An operation applied element-wise to one expression.
+template <typename Op, typename A>
+class VecUnary : public VecExpr<VecUnary<Op, A>> {
+  A a_;
+
+ public:
+  using value_type =
+      decltype(std::declval<Op>()(std::declval<typename A::value_type>()));
+
+  explicit VecUnary(const A& a) : a_(a) {}
+
+  value_type operator[](std::size_t i) const { return Op()(a_[i]); }
+  std::size_t size() const { return a_.size(); }
+};
+
+/// An operation applied element-wise to two expressions.
+/// The result is as long as the shorter of the two.
+template <typename Op, typename A, typename B>
+class VecBinary : public VecExpr<VecBinary<Op, A, B>> {
+  A a_;
+  B b_;
+
+ public:
+  using value_type =
+      decltype(std::declval<Op>()(std::declval<typename A::value_type>(),
+                                  std::declval<typename B::value_type>()));
+
+  VecBinary(const A& a, const B& b) : a_(a), b_(b) {}
+
+  value_type operator[](std::size_t i) const { return Op()(a_[i], b_[i]); }
+  std::size_t size() const { return std::min(a_.size(), b_.size()); }
+};
+
+namespace expr {
+
+struct Neg {
+  template <typename A>
+  auto operator()(const A& a) const -> decltype(-a) {
+    return -a;
+  }
+};
+
+struct Add {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const -> decltype(a + b) {
+    return a + b;
+  }
+};
+
+struct Sub {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const -> decltype(a - b) {
+    return a - b;
+  }
+};
+
+struct Mul {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const -> decltype(a * b) {
+    return a * b;
+  }
+};
+
+struct Div {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const -> decltype(a / b) {
+    return a / b;
+  }
+};
+
+struct Dot {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const -> decltype(dot(a, b)) {
+    return dot(a, b);
+  }
+};
+
+struct Cross {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const -> decltype(cross(a, b)) {
+    return cross(a, b);
+  }
+};
+
+struct Normalise {
+  template <typename A>
+  auto operator()(const A& a) const -> decltype(normalise(a)) {
+    return normalise(a);
+  }
+};
+
+struct GetX {
+  template <typename A>
+  auto operator()(const A& a) const -> decltype(a.x) {
+    return a.x;
+  }
+};
+
+struct GetY {
+  template <typename A>
+  auto operator()(const A& a) const -> decltype(a.y) {
+    return a.y;
+  }
+};
+
+struct GetZ {
+  template <typename A>
+  auto operator()(const A& a) const -> decltype(a.z) {
+    return a.z;
+  }
+};
+
+struct GetW {
+  template <typename A>
+  auto operator()(const A& a) const -> decltype(a.w) {
+    return a.w;
+  }
+};
+
+/// Map an operand to its expression type: expressions are kept as they are,
+/// vectors and scalars are broadcast. Other types have no Node, which removes
+/// the operators below from overload resolution.
+template <typename X, typename = void>
+struct Operand {};
+
+template <typename E>
+struct Operand<E, typename std::enable_if<
+                      std::is_base_of<VecExpr<E>, E>::value>::type> {
+  using Node = E;
+  static const E& make(const E& e) { return e; }
+};
+
+template <typename X>
+struct Broadcast {
+  using Node = VecUniform<X>;
+  static Node make(const X& x) { return Node(x); }
+};
+
+template <typename T>
+struct Operand<vec2T<T>> : Broadcast<vec2T<T>> {};
+
+template <typename T>
+struct Operand<vec3T<T>> : Broadcast<vec3T<T>> {};
+
+template <typename T>
+struct Operand<vec4T<T>> : Broadcast<vec4T<T>> {};
+
+template <typename X>
+struct Operand<X, typename std::enable_if<std::is_arithmetic<X>::value>::type>
+    : Broadcast<X> {};
+
+template <typename X>
+using Node = typename Operand<X>::Node;
+
+template <typename X>
+struct IsExpr : std::is_base_of<VecExpr<X>, X> {};
+
+/// The binary node for A op B, defined if at least one side is an array
+/// expression and the other is an expression, a vector or a scalar.
+template <typename Op, typename A, typename B>
+using BinaryFor =
+    typename std::enable_if<IsExpr<A>::value || IsExpr<B>::value,
+                            VecBinary<Op, Node<A>, Node<B>>>::type;
+
+template <typename Op, typename A, typename B>
+BinaryFor<Op, A, B> make_binary(const A& a, const B& b) {
+  return BinaryFor<Op, A, B>(Operand<A>::make(a), Operand<B>::make(b));
+}
+
+}  // namespace expr
+
+/// Wrap an array of vectors as an expression.
+template <typename V>
+VecArray<V> vec_array(const V* data, std::size_t n) {
+  return VecArray<V>(data, n);
+}
+
+/// Wrap a vector of vectors as an expression.
+template <typename V>
+VecArray<V> vec_array(const std::vector<V>& v) {
+  return VecArray<V>(v.data(), v.size());
+}
+
+/// Wrap an array of scalars as an expression.
+/// Scalar expressions scale vector expressions element-wise.
+template <typename T>
+VecArray<T> scalar_array(const T* data, std::size_t n) {
+  return VecArray<T>(data, n);
+}
+
+/// Negate each element.
+template <typename E>
+VecUnary<expr::Neg, E> operator-(const VecExpr<E>& e) {
+  return VecUnary<expr::Neg, E>(e.self());
+}
+
+/// Add element-wise.
+template <typename A, typename B>
+expr::BinaryFor<expr::Add, A, B> operator+(const A& a, const B& b) {
+  return expr::make_binary<expr::Add>(a, b);
+}
+
+/// Subtract element-wise.
+template <typename A, typename B>
+expr::BinaryFor<expr::Sub, A, B> operator-(const A& a, const B& b) {
+  return expr::make_binary<expr::Sub>(a, b);
+}
+
+/// Multiply element-wise; a scalar operand scales the vectors.
+template <typename A, typename B>
+expr::BinaryFor<expr::Mul, A, B> operator*(const A& a, const B& b) {
+  return expr::make_binary<expr::Mul>(a, b);
+}
+
+/// Divide element-wise; a scalar operand divides the vectors.
+template <typename A, typename B>
+expr::BinaryFor<expr::Div, A, B> operator/(const A& a, const B& b) {
+  return expr::make_binary<expr::Div>(a, b);
+}
+
+/// Return the element-wise dot product.
+template <typename A, typename B>
+expr::BinaryFor<expr::Dot, A, B> dot(const A& a, const B& b) {
+  return expr::make_binary<expr::Dot>(a, b);
+}
+
+/// Return the element-wise cross product.
+template <typename A, typename B>
+expr::BinaryFor<expr::Cross, A, B> cross(const A& a, const B& b) {
+  return expr::make_binary<expr::Cross>(a, b);
+}
+
+/// Normalise each element.
+template <typename E>
+VecUnary<expr::Normalise, E> normalise(const VecExpr<E>& e) {
+  return VecUnary<expr::Normalise, E>(e.self());
+}
+
+/// Return the X component of each element.
+template <typename E>
+VecUnary<expr::GetX, E> get_x(const VecExpr<E>& e) {
+  return VecUnary<expr::GetX, E>(e.self());
+}
+
+/// Return the Y component of each element.
+template <typename E>
+VecUnary<expr::GetY, E> get_y(const VecExpr<E>& e) {
+  return VecUnary<expr::GetY, E>(e.self());
+}
+
+/// Return the Z component of each element.
+template <typename E>
+VecUnary<expr::GetZ, E> get_z(const VecExpr<E>& e) {
+  return VecUnary<expr::GetZ, E>(e.self());
+}
+
+/// Return the W component of each element.
+template <typename E>
+VecUnary<expr::GetW, E> get_w(const VecExpr<E>& e) {
+  return VecUnary<expr::GetW, E>(e.self());
+}
+
+/// Evaluate the expression into out[0, e.size()) in a single pass.
+/// The expression must contain at least one array. out may alias one of the
+/// expression's arrays, since each element is only read before its own
+/// result is written.
+template <typename V, typename E>
+void evaluate(V* out, const VecExpr<E>& e) {
+  const E& x = e.self();
+  const std::size_t n = x.size();
+  assert(n != std::numeric_limits<std::size_t>::max());
+  for (std::size_t i = 0; i < n; ++i) out[i] = V(x[i]);
+}
+
+/// Evaluate the expression into a vector, resizing it to the expression's
+/// length.
+template <typename V, typename E>
+void evaluate(std::vector<V>& out, const VecExpr<E>& e) {
+  out.resize(e.self().size());
+  evaluate(out.data(), e);
+}
+
+/// Evaluate the expression into out[0, e.size()), splitting the range over
+/// the worker threads (see parallel_for()).
+template <typename V, typename E>
+void evaluate_parallel(V* out, const VecExpr<E>& e,
+                       std::size_t grain = 16384) {
+  const E& x = e.self();
+  assert(x.size() != std::numeric_limits<std::size_t>::max());
+  parallel_for(x.size(), grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) out[i] = V(x[i]);
+  });
+}
+
+}  // namespace kx
@@ -12,8 +12,11 @@ else {
 }
 
 QMAKE_CXXFLAGS_DEBUG += -DDEBUG
+kx_math_inline {
+    DEFINES += KX_MATH_INLINE
+}
 unix: {
-    QMAKE_CXXFLAGS += --std=c++11
+    QMAKE_CXXFLAGS += --std=c++11 -pthread
 }
 win32: {
     QMAKE_CXXFLAGS += -DNOMINMAX
@@ -27,17 +30,37 @@ DEPENDPATH = include
 HEADERS += \
     include/math/AABB2.h \
     include/math/AABB3.h \
+    include/math/AABB3.inl \
+    include/math/AABB3a.h \
+    include/math/alias_table.h \
+    include/math/ambient_occlusion.h \
+    include/math/animation.h \
     include/math/area.h \
     include/math/axis_plane.h \
+    include/math/bounds.h \
+    include/math/bvh.h \
     include/math/camera.h \
+    include/math/camera_rays.h \
     include/math/circle.h \
+    include/math/clipping.h \
     include/math/defs.h \
     include/math/determinant.h \
+    include/math/dualquat.h \
     include/math/frustum.h \
+    include/math/fwd.h \
+    include/math/hash_grid.h \
     include/math/interpolation.h \
     include/math/intersection.h \
+    include/math/kd_tree.h \
+    include/math/low_discrepancy.h \
+    include/math/loose_octree.h \
     include/math/mat3.h \
+    include/math/mat3.inl \
     include/math/mat4.h \
+    include/math/mat4.inl \
+    include/math/mesh_sampler.h \
+    include/math/parallel.h \
+    include/math/philox.h \
     include/math/plane.h \
     include/math/quad2.h \
     include/math/quad3.h \
@@ -45,30 +68,54 @@ HEADERS += \
     include/math/rasterization.h \
     include/math/ray3.h \
     include/math/sampling.h \
+    include/math/shadow_cascades.h \
+    include/math/simd.h \
+    include/math/skinning.h \
     include/math/spatial.h \
     include/math/sphere.h \
+    include/math/sweep_and_prune.h \
     include/math/texel.h \
     include/math/triangle2.h \
     include/math/triangle3.h \
     include/math/utils.h \
     include/math/vec2.h \
     include/math/vec3.h \
-    include/math/vec4.h
+    include/math/vec4.h \
+    include/math/vec4.inl \
+    include/math/vec_expr.h
 
 SOURCES += \
     src/AABB2.cc \
     src/AABB3.cc \
+    src/alias_table.cc \
+    src/ambient_occlusion.cc \
+    src/animation.cc \
     src/area.cc \
+    src/bounds.cc \
+    src/bvh.cc \
+    src/camera.cc \
+    src/camera_rays.cc \
+    src/clipping.cc \
+    src/dualquat.cc \
     src/frustum.cc \
+    src/hash_grid.cc \
     src/interpolation.cc \
     src/intersection.cc \
+    src/kd_tree.cc \
+    src/low_discrepancy.cc \
+    src/loose_octree.cc \
     src/mat3.cc \
     src/mat4.cc \
+    src/mesh_sampler.cc \
+    src/philox.cc \
     src/plane.cc \
     src/quat.cc \
     src/rasterization.cc \
     src/sampling.cc \
+    src/shadow_cascades.cc \
+    src/skinning.cc \
     src/spatial.cc \
+    src/sweep_and_prune.cc \
+    src/triangle3.cc \
     src/utils.cc \
-    src/vec3.cc \
     src/vec4.cc
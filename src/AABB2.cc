@@ -2,13 +2,15 @@
 
 using namespace kx;
 
-KX_MATH_API AABB2::AABB2(vec2* ps, unsigned n) {
-  vec2* p = ps;
+template <typename T>
+KX_MATH_API AABB2T<T>::AABB2T(vec2T<T>* ps, unsigned n) {
+  vec2T<T>* p = ps;
   for (unsigned i = 0; i < n; ++i, ++p) add(*p);
 }
 
-KX_MATH_API void AABB2::add(const vec2& p) {
-  if (pmin == vec2(1) && pmax == vec2(-1))  // AABB uninitialised
+template <typename T>
+KX_MATH_API void AABB2T<T>::add(const vec2T<T>& p) {
+  if (pmin == vec2T<T>(1) && pmax == vec2T<T>(-1))  // AABB uninitialised
   {
     pmin = p;
     pmax = p;
@@ -20,7 +22,11 @@ KX_MATH_API void AABB2::add(const vec2& p) {
   }
 }
 
-KX_MATH_API void AABB2::add(const kx::AABB2& box) {
+template <typename T>
+KX_MATH_API void AABB2T<T>::add(const AABB2T<T>& box) {
   add(box.pmin);
   add(box.pmax);
 }
+
+template struct kx::AABB2T<float>;
+template struct kx::AABB2T<double>;
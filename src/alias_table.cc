@@ -0,0 +1,78 @@
+#include <math/alias_table.h>
+#include <math/parallel.h>
+
+#include <cassert>
+
+using namespace kx;
+
+namespace {
+
+/// Elements per parallel chunk when normalising the weights.
+const std::size_t kGrain = 1 << 16;
+
+/// Return the sum of the weights, summing chunks in parallel.
+R sum(const R* w, std::size_t n) {
+  const std::size_t num_chunks = (n + kGrain - 1) / kGrain;
+  std::vector<double> partial(num_chunks);
+  parallel_for(num_chunks, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      double s = 0;
+      const std::size_t last = std::min(n, (c + 1) * kGrain);
+      for (std::size_t i = c * kGrain; i < last; ++i) s += w[i];
+      partial[c] = s;
+    }
+  });
+  double s = 0;
+  for (double p : partial) s += p;
+  return R(s);
+}
+
+}  // namespace
+
+AliasTable::AliasTable() : total_(0) {}
+
+AliasTable::AliasTable(const std::vector<R>& weights)
+    : AliasTable(weights.data(), weights.size()) {}
+
+AliasTable::AliasTable(const R* weights, std::size_t n)
+    : bins_(n), pmf_(n), total_(sum(weights, n)) {
+  assert(n > 0 && total_ > 0);
+
+  // Scale the weights so that they average 1; a bin is "small" if its weight
+  // falls short of 1 and gets topped up by a "large" one.
+  const R to_pmf = 1 / total_;
+  const R to_bin = R(n) / total_;
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      pmf_[i] = weights[i] * to_pmf;
+      bins_[i].prob = weights[i] * to_bin;
+      bins_[i].alias = std::uint32_t(i);
+    }
+  });
+
+  // Vose's pairing. The small and large worklists share one array, filled
+  // from either end.
+  std::vector<std::uint32_t> work(n);
+  std::size_t num_small = 0;
+  std::size_t large_begin = n;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (bins_[i].prob < 1)
+      work[num_small++] = std::uint32_t(i);
+    else
+      work[--large_begin] = std::uint32_t(i);
+  }
+  while (num_small > 0 && large_begin < n) {
+    const std::uint32_t s = work[--num_small];
+    const std::uint32_t l = work[large_begin];
+    bins_[s].alias = l;
+    bins_[l].prob -= 1 - bins_[s].prob;
+    if (bins_[l].prob < 1) {
+      ++large_begin;
+      work[num_small++] = l;
+    }
+  }
+
+  // What is left is 1 up to rounding errors.
+  for (std::size_t i = 0; i < num_small; ++i) bins_[work[i]].prob = 1;
+  for (std::size_t i = large_begin; i < n; ++i) bins_[work[i]].prob = 1;
+}
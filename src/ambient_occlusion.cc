@@ -0,0 +1,123 @@
+#include <math/ambient_occlusion.h>
+#include <math/interpolation.h>
+#include <math/low_discrepancy.h>
+#include <math/parallel.h>
+#include <math/rasterization.h>
+#include <math/sampling.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace kx;
+
+namespace {
+
+/// Triangles per parallel chunk when rasterizing.
+const std::size_t kGrain = 256;
+
+/// Owner of the texels that no triangle covers.
+const std::uint32_t kNone = 0xffffffff;
+
+/// Return, for each texel, the index of the first triangle covering it, or
+/// kNone.
+std::vector<std::uint32_t> rasterize(const BakeMesh& mesh, int width,
+                                     int height) {
+  // Rasterize chunks of triangles in parallel, then merge the chunks in
+  // order so that the first triangle wins regardless of the scheduling.
+  using Covered = std::vector<std::pair<std::size_t, std::uint32_t>>;
+  const std::size_t num_chunks = (mesh.num_triangles + kGrain - 1) / kGrain;
+  std::vector<Covered> chunks(num_chunks);
+  parallel_for(num_chunks, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      const std::size_t last = std::min(mesh.num_triangles, (c + 1) * kGrain);
+      for (std::size_t i = c * kGrain; i < last; ++i) {
+        for (const Texel& t :
+             rasterize_triangle_contained(mesh.uvs[i], width, height)) {
+          if (t.x < 0 || t.x >= width || t.y < 0 || t.y >= height) continue;
+          chunks[c].emplace_back(std::size_t(t.y) * width + t.x,
+                                 std::uint32_t(i));
+        }
+      }
+    }
+  });
+
+  std::vector<std::uint32_t> owner(std::size_t(width) * height, kNone);
+  for (const Covered& chunk : chunks)
+    for (const auto& texel : chunk)
+      if (owner[texel.first] == kNone) owner[texel.first] = texel.second;
+  return owner;
+}
+
+}  // namespace
+
+bool kx::bake_ambient_occlusion(const BVH& occluders, const BakeMesh& mesh,
+                                const AOSettings& settings, R* out,
+                                const BakeProgress& progress) {
+  const int width = settings.width;
+  const int height = settings.height;
+  const int tile_size = std::max(settings.tile_size, 1);
+  const std::vector<std::uint32_t> owner = rasterize(mesh, width, height);
+
+  const int tiles_x = (width + tile_size - 1) / tile_size;
+  const int tiles_y = (height + tile_size - 1) / tile_size;
+  const std::size_t num_tiles = std::size_t(tiles_x) * tiles_y;
+  const std::size_t num_rays = std::size_t(std::max(settings.num_rays, 1));
+
+  std::atomic<bool> cancelled(false);
+  std::mutex progress_mutex;
+  std::size_t tiles_done = 0;
+
+  parallel_for(num_tiles, 1, [&](std::size_t begin, std::size_t end) {
+    std::vector<vec2> square(num_rays);
+    std::vector<vec3> hemisphere(num_rays);
+    for (std::size_t tile = begin; tile < end && !cancelled; ++tile) {
+      const int x0 = int(tile % tiles_x) * tile_size;
+      const int y0 = int(tile / tiles_x) * tile_size;
+      const int x1 = std::min(x0 + tile_size, width);
+      const int y1 = std::min(y0 + tile_size, height);
+      for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+          const std::size_t texel = std::size_t(y) * width + x;
+          const std::uint32_t tri = owner[texel];
+          if (tri == kNone) continue;
+
+          // Map the texel to the surface through the point the rasterizer
+          // tested for coverage, which lies in the triangle.
+          vec2 uv = texture_coordinates(Texel(x, y), width, height) +
+                    vec2(R(1) / width, R(-1) / height);
+          vec2 st = barycentric_coordinates(mesh.uvs[tri], uv);
+          const Triangle3& p = mesh.positions[tri];
+          vec3 pos = interpolate(p, st);
+          vec3 n = mesh.normals ? normalise(interpolate(mesh.normals[tri], st))
+                                : normalise(cross(p.p1 - p.p0, p.p2 - p.p0));
+          vec3 t = normalise(cross(vec3(0.0034f, 1.f, 0.0071f), n));
+          vec3 b = cross(n, t);
+
+          CMJSet set(std::uint32_t(num_rays),
+                     std::uint32_t(texel) ^ settings.seed * 0x9e3779b9);
+          for (std::size_t i = 0; i < num_rays; ++i)
+            square[i] = set[std::uint32_t(i)];
+          sample_cosine_hemisphere(square.data(), hemisphere.data(), num_rays);
+
+          Ray3 ray(pos + n * settings.bias, vec3());
+          std::size_t open = 0;
+          for (const vec3& w : hemisphere) {
+            ray.dir = w.x * t + w.y * b + w.z * n;
+            if (!occluders.occluded(ray, 0, settings.max_distance)) ++open;
+          }
+          out[texel] = R(open) / R(num_rays);
+        }
+      }
+
+      if (progress) {
+        std::lock_guard<std::mutex> lock(progress_mutex);
+        if (!cancelled && !progress(++tiles_done, num_tiles)) cancelled = true;
+      }
+    }
+  });
+
+  return !cancelled;
+}
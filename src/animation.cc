@@ -0,0 +1,144 @@
+#include <math/animation.h>
+
+#include <algorithm>
+
+using namespace kx;
+
+namespace {
+
+// Number of keys to step over before falling back to a binary search.
+const unsigned max_linear_steps = 4;
+
+struct TimeLess {
+  template <typename T>
+  bool operator()(R t, const Key<T>& key) const {
+    return t < key.time;
+  }
+};
+
+// Return the index i of the key segment [keys[i], keys[i+1]) containing t,
+// starting the search from the cached index. keys must not be empty.
+template <typename T>
+unsigned seek(const std::vector<Key<T>>& keys, R t, unsigned cursor) {
+  const unsigned n = (unsigned)keys.size();
+  unsigned i = cursor < n ? cursor : 0;
+  if (t >= keys[i].time) {
+    // Step forward from the cached segment.
+    for (unsigned steps = 0; i + 1 < n && keys[i + 1].time <= t; ++steps) {
+      if (steps == max_linear_steps) {
+        i = (unsigned)(std::upper_bound(keys.begin() + i, keys.end(), t,
+                                        TimeLess()) -
+                       keys.begin()) -
+            1;
+        break;
+      }
+      ++i;
+    }
+  } else {
+    // Time went backwards, e.g. a looping animation restarted.
+    unsigned j = (unsigned)(std::upper_bound(keys.begin(), keys.begin() + i, t,
+                                             TimeLess()) -
+                            keys.begin());
+    i = j == 0 ? 0 : j - 1;
+  }
+  return i;
+}
+
+// Return the interpolation parameter of t in the segment starting at key i.
+template <typename T>
+R segment_param(const std::vector<Key<T>>& keys, unsigned i, R t) {
+  if (i + 1 >= keys.size()) return 0;
+  R t0 = keys[i].time;
+  R t1 = keys[i + 1].time;
+  if (t1 <= t0) return 0;
+  return clamp((t - t0) / (t1 - t0), 0, 1);
+}
+
+vec3 sample_vec3(const std::vector<Key<vec3>>& keys, R t, unsigned& cursor,
+                 const vec3& identity) {
+  if (keys.empty()) return identity;
+  unsigned i = seek(keys, t, cursor);
+  cursor = i;
+  R u = segment_param(keys, i, t);
+  if (u == 0) return keys[i].value;
+  const vec3& a = keys[i].value;
+  const vec3& b = keys[i + 1].value;
+  return a + u * (b - a);
+}
+
+quat sample_quat(const std::vector<Key<quat>>& keys, R t, unsigned& cursor) {
+  if (keys.empty()) return quat();
+  unsigned i = seek(keys, t, cursor);
+  cursor = i;
+  R u = segment_param(keys, i, t);
+  if (u == 0) return keys[i].value;
+  return nlerp(keys[i].value, keys[i + 1].value, u);
+}
+
+// Compose M = T * R * S, with the rotation matrix following rot()'s convention.
+mat4 compose(const vec3& t, const quat& q, const vec3& s) {
+  R xx = q.x * q.x, xy = q.x * q.y, xz = q.x * q.z;
+  R yy = q.y * q.y, yz = q.y * q.z, zz = q.z * q.z;
+  R wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+  return mat4((1 - 2 * (yy + zz)) * s.x, 2 * (xy - wz) * s.y,
+              2 * (xz + wy) * s.z, t.x, 2 * (xy + wz) * s.x,
+              (1 - 2 * (xx + zz)) * s.y, 2 * (yz - wx) * s.z, t.y,
+              2 * (xz - wy) * s.x, 2 * (yz + wx) * s.y,
+              (1 - 2 * (xx + yy)) * s.z, t.z, 0, 0, 0, 1);
+}
+
+}  // namespace
+
+TrackSampler::TrackSampler(std::size_t num_tracks) : cursors(num_tracks) {
+  reset();
+}
+
+void TrackSampler::reset() {
+  for (Cursor& c : cursors) c.translation = c.rotation = c.scale = 0;
+}
+
+void TrackSampler::grow(std::size_t num_tracks) {
+  if (cursors.size() >= num_tracks) return;
+  Cursor c;
+  c.translation = c.rotation = c.scale = 0;
+  cursors.resize(num_tracks, c);
+}
+
+void TrackSampler::sample(const Track* tracks, std::size_t n, R time,
+                          vec3* translations, quat* rotations, vec3* scales) {
+  grow(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const Track& track = tracks[i];
+    Cursor& c = cursors[i];
+    if (translations)
+      translations[i] =
+          sample_vec3(track.translations, time, c.translation, vec3(0));
+    if (rotations) rotations[i] = sample_quat(track.rotations, time, c.rotation);
+    if (scales) scales[i] = sample_vec3(track.scales, time, c.scale, vec3(1));
+  }
+}
+
+void TrackSampler::sample(const Track* tracks, std::size_t n, R time,
+                          mat4* out) {
+  grow(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const Track& track = tracks[i];
+    Cursor& c = cursors[i];
+    vec3 t = sample_vec3(track.translations, time, c.translation, vec3(0));
+    quat q = sample_quat(track.rotations, time, c.rotation);
+    vec3 s = sample_vec3(track.scales, time, c.scale, vec3(1));
+    out[i] = compose(t, q, s);
+  }
+}
+
+void TrackSampler::sample(const Track* tracks, std::size_t n, R time,
+                          Spatial* out) {
+  grow(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const Track& track = tracks[i];
+    Cursor& c = cursors[i];
+    vec3 t = sample_vec3(track.translations, time, c.translation, vec3(0));
+    quat q = sample_quat(track.rotations, time, c.rotation);
+    out[i].setTransform(compose(t, q, vec3(1)));
+  }
+}
@@ -11,6 +11,10 @@ R kx::area(const vec3& p0, const vec3& p1, const vec3& p2) {
   return norm(normal) / 2;
 }
 
+void kx::area(const Triangle3* t, R* out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) out[i] = area(t[i]);
+}
+
 R kx::area(const Quad3& q) { return area(q.p0, q.p1, q.p2, q.p3); }
 
 R kx::area(const vec3& p0, const vec3& p1, const vec3& p2, const vec3& p3) {
@@ -0,0 +1,370 @@
+#include <math/bounds.h>
+#include <math/parallel.h>
+#include <math/simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace kx;
+using namespace simd;
+
+namespace {
+
+/// Points handed to a thread at a time.
+const std::size_t kGrain = 1 << 16;
+
+static_assert(sizeof(vec3) == 3 * sizeof(R), "vec3 must be packed");
+
+/// Relative tolerance of the sphere tests, for rounding errors.
+const R kTolerance = 16 * std::numeric_limits<R>::epsilon();
+
+/// Return the AABB of the points [begin, end).
+AABB3 box_of(const vec3* points, std::size_t begin, std::size_t end) {
+  // Seen as an array of reals, the coordinates repeat every three, so each of
+  // three consecutive registers sees the same coordinates from one block of
+  // Rv::N points to the next.
+  const R inf = std::numeric_limits<R>::infinity();
+  Rv lo[3] = {inf, inf, inf};
+  Rv hi[3] = {-inf, -inf, -inf};
+  const std::size_t blocks = (end - begin) / Rv::N;
+  const R* p = &points[begin].x;
+  for (std::size_t b = 0; b < blocks; ++b, p += 3 * Rv::N) {
+    for (int k = 0; k < 3; ++k) {
+      const Rv v = load(p + k * Rv::N);
+      lo[k] = min(v, lo[k]);
+      hi[k] = max(v, hi[k]);
+    }
+  }
+
+  // Lane l of register k holds the coordinate (k * Rv::N + l) % 3.
+  R l[3 * Rv::N];
+  R h[3 * Rv::N];
+  for (int k = 0; k < 3; ++k) {
+    store(l + k * Rv::N, lo[k]);
+    store(h + k * Rv::N, hi[k]);
+  }
+  AABB3 box;
+  for (int i = 0; i < 3 * Rv::N; ++i) {
+    R& bmin = box.pmin[i % 3];
+    R& bmax = box.pmax[i % 3];
+    bmin = l[i] < bmin ? l[i] : bmin;
+    bmax = h[i] > bmax ? h[i] : bmax;
+  }
+  for (std::size_t i = begin + blocks * Rv::N; i < end; ++i)
+    box.add(points[i]);
+  return box;
+}
+
+/// Return the largest squared distance from the points [begin, end) to c.
+R max_distance2(const vec3* points, std::size_t begin, std::size_t end,
+                const vec3& c) {
+  const Rv cx(c.x);
+  const Rv cy(c.y);
+  const Rv cz(c.z);
+  Rv m(0);
+  std::size_t i = begin;
+  for (const R* p = &points[begin].x; i + Rv::N <= end;
+       i += Rv::N, p += 3 * Rv::N) {
+    const Rv dx = gather(p, 3) - cx;
+    const Rv dy = gather(p + 1, 3) - cy;
+    const Rv dz = gather(p + 2, 3) - cz;
+    m = max(dx * dx + dy * dy + dz * dz, m);
+  }
+  R lanes[Rv::N];
+  store(lanes, m);
+  R d2 = 0;
+  for (R x : lanes) d2 = x > d2 ? x : d2;
+  for (; i < end; ++i) {
+    const R x = norm2(points[i] - c);
+    d2 = x > d2 ? x : d2;
+  }
+  return d2;
+}
+
+/// The number of directions along which the farthest points are searched
+/// for: the axes and the diagonals of a cube.
+const int kNumDirections = 7;
+
+/// Project the point on the directions, unnormalised.
+template <typename V>
+void project(V x, V y, V z, V t[kNumDirections]) {
+  const V xpy = x + y;
+  const V xmy = x - y;
+  t[0] = x;
+  t[1] = y;
+  t[2] = z;
+  t[3] = xpy + z;
+  t[4] = xpy - z;
+  t[5] = xmy + z;
+  t[6] = xmy - z;
+}
+
+/// The points with the lowest and highest projections on each direction.
+struct Extremes {
+  R lo[kNumDirections], hi[kNumDirections];
+  std::size_t lo_index[kNumDirections], hi_index[kNumDirections];
+
+  Extremes() {
+    for (int d = 0; d < kNumDirections; ++d) {
+      lo[d] = std::numeric_limits<R>::infinity();
+      hi[d] = -std::numeric_limits<R>::infinity();
+      lo_index[d] = hi_index[d] = 0;
+    }
+  }
+
+  void add(int d, R t, std::size_t index) {
+    addLow(d, t, index);
+    addHigh(d, t, index);
+  }
+
+  void addLow(int d, R t, std::size_t index) {
+    if (t < lo[d]) {
+      lo[d] = t;
+      lo_index[d] = index;
+    }
+  }
+
+  void addHigh(int d, R t, std::size_t index) {
+    if (t > hi[d]) {
+      hi[d] = t;
+      hi_index[d] = index;
+    }
+  }
+
+  void add(const Extremes& e) {
+    for (int d = 0; d < kNumDirections; ++d) {
+      if (e.lo[d] < lo[d]) {
+        lo[d] = e.lo[d];
+        lo_index[d] = e.lo_index[d];
+      }
+      if (e.hi[d] > hi[d]) {
+        hi[d] = e.hi[d];
+        hi_index[d] = e.hi_index[d];
+      }
+    }
+  }
+};
+
+/// Return the extreme projections of the points in [begin, end), which must
+/// hold at most kGrain points.
+Extremes extremes_of(const vec3* points, std::size_t begin,
+                     std::size_t end) {
+  // Each lane keeps its extreme projections and the offsets of their points
+  // from 'begin', which the kGrain bound keeps exact as reals.
+  const R inf = std::numeric_limits<R>::infinity();
+  Rv lo[kNumDirections], hi[kNumDirections];
+  Rv lo_at[kNumDirections], hi_at[kNumDirections];
+  for (int d = 0; d < kNumDirections; ++d) {
+    lo[d] = inf;
+    hi[d] = -inf;
+    lo_at[d] = hi_at[d] = 0;
+  }
+  R lane[Rv::N];
+  for (int l = 0; l < Rv::N; ++l) lane[l] = R(l);
+  Rv at = load(lane);
+
+  std::size_t i = begin;
+  for (const R* p = &points[begin].x; i + Rv::N <= end;
+       i += Rv::N, p += 3 * Rv::N, at = at + Rv(R(Rv::N))) {
+    Rv t[kNumDirections];
+    project(gather(p, 3), gather(p + 1, 3), gather(p + 2, 3), t);
+    for (int d = 0; d < kNumDirections; ++d) {
+      const Mask below = t[d] < lo[d];
+      const Mask above = t[d] > hi[d];
+      lo[d] = select(below, t[d], lo[d]);
+      hi[d] = select(above, t[d], hi[d]);
+      lo_at[d] = select(below, at, lo_at[d]);
+      hi_at[d] = select(above, at, hi_at[d]);
+    }
+  }
+
+  Extremes e;
+  for (int d = 0; d < kNumDirections; ++d) {
+    R l[Rv::N], h[Rv::N], l_at[Rv::N], h_at[Rv::N];
+    store(l, lo[d]);
+    store(h, hi[d]);
+    store(l_at, lo_at[d]);
+    store(h_at, hi_at[d]);
+    // A lane's lows and highs are kept apart: a lane that saw no point holds
+    // +inf and -inf, which must not reach the other bound.
+    for (int k = 0; k < Rv::N; ++k) {
+      e.addLow(d, l[k], begin + std::size_t(l_at[k]));
+      e.addHigh(d, h[k], begin + std::size_t(h_at[k]));
+    }
+  }
+  for (; i < end; ++i) {
+    R t[kNumDirections];
+    project(points[i].x, points[i].y, points[i].z, t);
+    for (int d = 0; d < kNumDirections; ++d) e.add(d, t[d], i);
+  }
+  return e;
+}
+
+/// Return true if the sphere contains the point, up to rounding errors.
+bool inside(const vec3& p, const Sphere& s) {
+  return norm2(p - s.center) <= s.radius2 * (1 + kTolerance);
+}
+
+/// Set 's' to the smallest sphere with the n <= 4 points on its boundary, and
+/// return true, or return false if the points are too close to collinear or
+/// coplanar.
+bool circumsphere(const vec3* p, int n, Sphere& s) {
+  const R eps = std::numeric_limits<R>::epsilon();
+  if (n == 0) {
+    s = Sphere(vec3(0), -1);
+    return true;
+  } else if (n == 1) {
+    s.center = p[0];
+  } else if (n == 2) {
+    s.center = (p[0] + p[1]) / R(2);
+  } else if (n == 3) {
+    const vec3 a = p[1] - p[0];
+    const vec3 b = p[2] - p[0];
+    const vec3 c = cross(a, b);
+    const R c2 = norm2(c);
+    if (!(c2 > eps * norm2(a) * norm2(b))) return false;
+    s.center = p[0] + (cross(c, a) * norm2(b) + cross(b, c) * norm2(a)) /
+                          (2 * c2);
+  } else {
+    const vec3 a = p[1] - p[0];
+    const vec3 b = p[2] - p[0];
+    const vec3 c = p[3] - p[0];
+    const R det = dot(a, cross(b, c));
+    if (!(det * det > eps * norm2(a) * norm2(b) * norm2(c))) return false;
+    s.center = p[0] + (norm2(a) * cross(b, c) + norm2(b) * cross(c, a) +
+                       norm2(c) * cross(a, b)) /
+                          (2 * det);
+  }
+  s.radius2 = 0;
+  for (int i = 0; i < n; ++i)
+    s.radius2 = max(s.radius2, norm2(p[i] - s.center));
+  return true;
+}
+
+/// Return the smallest sphere with the n <= 4 points on its boundary. If the
+/// points are degenerate, return the smallest sphere through fewer of them
+/// that contains them all.
+Sphere through(const vec3* p, int n) {
+  Sphere best;
+  if (circumsphere(p, n, best)) return best;
+  bool found = false;
+  for (int skip = 0; skip < n; ++skip) {
+    vec3 q[3];
+    for (int i = 0, k = 0; i < n; ++i)
+      if (i != skip) q[k++] = p[i];
+    const Sphere s = through(q, n - 1);
+    const bool contains = inside(p[skip], s);
+    // Rounding errors may leave every candidate short; take the largest then.
+    if (contains ? !found || s.radius2 < best.radius2
+                 : !found && s.radius2 > best.radius2) {
+      best = s;
+      found = contains;
+    }
+  }
+  return best;
+}
+
+/// Return the smallest sphere containing the first n points, with the
+/// points of 'support' on its boundary (Welzl's algorithm).
+Sphere welzl(const vec3* p, int n, vec3 support[4], int num_support) {
+  if (n == 0 || num_support == 4) return through(support, num_support);
+  const Sphere s = welzl(p, n - 1, support, num_support);
+  if (inside(p[n - 1], s)) return s;
+  support[num_support] = p[n - 1];
+  return welzl(p, n - 1, support, num_support + 1);
+}
+
+/// Grow the sphere to contain the point, moving its center towards it.
+/// Return true if the point was outside.
+bool grow(Sphere& s, const vec3& p) {
+  const vec3 d = p - s.center;
+  const R d2 = norm2(d);
+  if (d2 <= s.radius2) return false;
+  const R dist = std::sqrt(d2);
+  const R r = std::sqrt(s.radius2);
+  const R grown = (r + dist) / 2;
+  s.center += d * ((grown - r) / dist);
+  s.radius2 = grown * grown;
+  return true;
+}
+
+/// Return a sphere containing both spheres.
+Sphere enclose(const Sphere& a, const Sphere& b) {
+  const vec3 d = b.center - a.center;
+  const R dist = norm(d);
+  const R ra = a.radius();
+  const R rb = b.radius();
+  if (dist + rb <= ra) return a;
+  if (dist + ra <= rb) return b;
+  const R r = (dist + ra + rb) / 2;
+  return Sphere(a.center + d * ((r - ra) / dist), r * r);
+}
+
+}  // namespace
+
+AABB3 kx::bounding_box(const vec3* points, std::size_t n) {
+  std::vector<AABB3> boxes((n + kGrain - 1) / kGrain);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    boxes[begin / kGrain] = box_of(points, begin, end);
+  });
+  AABB3 box;
+  for (const AABB3& b : boxes) box.add(b);
+  return box;
+}
+
+AABB3 kx::bounding_box(const Sphere& sphere) {
+  const R r = sphere.radius();
+  return AABB3(sphere.center - vec3(r), sphere.center + vec3(r));
+}
+
+Sphere kx::bounding_sphere(const vec3* points, std::size_t n) {
+  if (n == 0) return Sphere();
+  const std::size_t num_chunks = (n + kGrain - 1) / kGrain;
+
+  std::vector<Extremes> extremes(num_chunks);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    // A single thread gets the whole range in one call; split it.
+    Extremes& e = extremes[begin / kGrain];
+    for (std::size_t b = begin; b < end; b += kGrain)
+      e.add(extremes_of(points, b, std::min(b + kGrain, end)));
+  });
+  Extremes e;
+  for (const Extremes& c : extremes) e.add(c);
+  vec3 candidates[2 * kNumDirections];
+  for (int d = 0; d < kNumDirections; ++d) {
+    candidates[2 * d] = points[e.lo_index[d]];
+    candidates[2 * d + 1] = points[e.hi_index[d]];
+  }
+  vec3 support[4];
+  const Sphere initial = welzl(candidates, 2 * kNumDirections, support, 0);
+
+  // Grow a copy of the sphere over each chunk, then enclose the copies.
+  std::vector<Sphere> grown(num_chunks, initial);
+  std::vector<char> moved(num_chunks, false);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    Sphere& s = grown[begin / kGrain];
+    bool m = false;
+    for (std::size_t i = begin; i < end; ++i) m |= grow(s, points[i]);
+    moved[begin / kGrain] = m;
+  });
+  Sphere sphere = initial;
+  bool any_moved = false;
+  for (std::size_t c = 0; c < num_chunks; ++c) {
+    if (!moved[c]) continue;
+    sphere = any_moved ? enclose(sphere, grown[c]) : grown[c];
+    any_moved = true;
+  }
+  if (!any_moved) return sphere;
+
+  // The growing steps only bound the points up to rounding errors, and the
+  // enclosing spheres of the chunks may be loose; measure the radius.
+  std::vector<R> radius2(num_chunks);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    radius2[begin / kGrain] = max_distance2(points, begin, end, sphere.center);
+  });
+  sphere.radius2 = 0;
+  for (R r2 : radius2) sphere.radius2 = max(sphere.radius2, r2);
+  return sphere;
+}
@@ -0,0 +1,276 @@
+#include <math/bvh.h>
+#include <math/intersection.h>
+#include <math/parallel.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace kx;
+
+namespace {
+
+/// Triangles per parallel chunk when preparing the build.
+const std::size_t kGrain = 1 << 14;
+
+/// Centroid bins per SAH split.
+const int kNumBins = 16;
+
+/// Leaves hold at most this many triangles.
+const std::size_t kMaxLeafSize = 8;
+
+/// Cost of visiting an inner node relative to testing one triangle.
+const R kTraversalCost = 1;
+
+/// From this depth on, nodes are split in half instead of with the SAH, which
+/// bounds the depth of the tree, and so the traversal stack, to 64.
+const int kMaxSahDepth = 32;
+const int kStackSize = 64;
+
+/// A triangle being sorted into the tree.
+struct Ref {
+  AABB3 box;
+  vec3 centroid;
+  std::uint32_t id;
+};
+
+/// Builds the node array over a range of refs, recursively.
+template <typename Node>
+class Builder {
+ public:
+  Builder(std::vector<Ref>& refs, std::vector<Node>& nodes)
+      : refs_(refs), nodes_(nodes) {}
+
+  void build(std::size_t begin, std::size_t end, int depth) {
+    const std::size_t index = nodes_.size();
+    nodes_.push_back(Node());
+
+    AABB3 box;
+    AABB3 centroids;
+    for (std::size_t i = begin; i < end; ++i) {
+      box.add(refs_[i].box);
+      centroids.add(refs_[i].centroid);
+    }
+    nodes_[index].box = box;
+
+    const std::size_t n = end - begin;
+    int axis = 0;
+    std::size_t mid =
+        n > 1 ? split(begin, end, box, centroids, depth, axis) : end;
+    if (mid == end) {
+      nodes_[index].offset = std::uint32_t(begin);
+      nodes_[index].count = std::uint16_t(n);
+      nodes_[index].axis = 0;
+      return;
+    }
+
+    build(begin, mid, depth + 1);
+    nodes_[index].offset = std::uint32_t(nodes_.size());
+    nodes_[index].count = 0;
+    nodes_[index].axis = std::uint16_t(axis);
+    build(mid, end, depth + 1);
+  }
+
+ private:
+  /// Partition [begin, end) and return the start of the second half, or
+  /// 'end' if the range should become a leaf. Set 'axis' to the axis split.
+  std::size_t split(std::size_t begin, std::size_t end, const AABB3& box,
+                    const AABB3& centroids, int depth, int& axis) {
+    const std::size_t n = end - begin;
+    vec3 extent = centroids.pmax - centroids.pmin;
+    axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2)
+                               : (extent.y > extent.z ? 1 : 2);
+
+    // All centroids coincide, or the tree is too deep: split at the median.
+    if (extent[axis] <= 0 || depth >= kMaxSahDepth) {
+      if (n <= kMaxLeafSize) return end;
+      std::size_t mid = begin + n / 2;
+      std::nth_element(refs_.begin() + begin, refs_.begin() + mid,
+                       refs_.begin() + end, [axis](const Ref& a, const Ref& b) {
+                         return a.centroid[axis] < b.centroid[axis];
+                       });
+      return mid;
+    }
+
+    // Bin the centroids.
+    struct Bin {
+      AABB3 box;
+      std::size_t count;
+    };
+    Bin bins[kNumBins];
+    for (Bin& b : bins) {
+      b.box = AABB3();
+      b.count = 0;
+    }
+    const R cmin = centroids.pmin[axis];
+    const R scale = R(kNumBins) / extent[axis];
+    auto bin_of = [&](const Ref& r) {
+      int b = int((r.centroid[axis] - cmin) * scale);
+      return std::min(b, kNumBins - 1);
+    };
+    for (std::size_t i = begin; i < end; ++i) {
+      Bin& b = bins[bin_of(refs_[i])];
+      b.box.add(refs_[i].box);
+      ++b.count;
+    }
+
+    // Sweep from the right to get the cost of each right half, then from the
+    // left to evaluate each split plane.
+    R right_cost[kNumBins];
+    AABB3 right;
+    std::size_t right_count = 0;
+    for (int i = kNumBins - 1; i > 0; --i) {
+      right.add(bins[i].box);
+      right_count += bins[i].count;
+      right_cost[i] = R(right_count) * right.surfaceArea();
+    }
+    AABB3 left;
+    std::size_t left_count = 0;
+    R best_cost = std::numeric_limits<R>::infinity();
+    int best_split = 0;
+    for (int i = 1; i < kNumBins; ++i) {
+      left.add(bins[i - 1].box);
+      left_count += bins[i - 1].count;
+      R cost = R(left_count) * left.surfaceArea() + right_cost[i];
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_split = i;
+      }
+    }
+
+    // Compare with the cost of a leaf, both relative to the node's area.
+    const R area = box.surfaceArea();
+    const R split_cost =
+        area > 0 ? kTraversalCost + best_cost / area : kTraversalCost;
+    if (n <= kMaxLeafSize && split_cost >= R(n)) return end;
+
+    auto it = std::partition(
+        refs_.begin() + begin, refs_.begin() + end,
+        [&](const Ref& r) { return bin_of(r) < best_split; });
+    std::size_t mid = std::size_t(it - refs_.begin());
+    if (mid == begin || mid == end) mid = begin + n / 2;
+    return mid;
+  }
+
+  std::vector<Ref>& refs_;
+  std::vector<Node>& nodes_;
+};
+
+}  // namespace
+
+BVH::BVH(const Triangle3* triangles, std::size_t n)
+    : triangles_(triangles, triangles + n) {
+  build();
+}
+
+BVH::BVH(const vec3* vertices, const std::uint32_t* indices,
+         std::size_t num_triangles)
+    : triangles_(mesh_triangles(vertices, indices, num_triangles)) {
+  build();
+}
+
+void BVH::build() {
+  const std::size_t n = triangles_.size();
+  if (n == 0) return;
+
+  std::vector<Ref> refs(n);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const Triangle3& t = triangles_[i];
+      Ref& r = refs[i];
+      r.box = AABB3(min(t.p0, min(t.p1, t.p2)), max(t.p0, max(t.p1, t.p2)));
+      r.centroid = r.box.centroid();
+      r.id = std::uint32_t(i);
+    }
+  });
+
+  nodes_.reserve(2 * n);
+  Builder<Node>(refs, nodes_).build(0, n, 0);
+  nodes_.shrink_to_fit();
+
+  // Store the triangles in leaf order, so that each leaf reads a contiguous
+  // run of them.
+  std::vector<Triangle3> sorted(n);
+  ids_.resize(n);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      sorted[i] = triangles_[refs[i].id];
+      ids_[i] = refs[i].id;
+    }
+  });
+  triangles_.swap(sorted);
+}
+
+bool BVH::intersect(const Ray3& ray, R tmin, R tmax, R& t,
+                    std::uint32_t& triangle) const {
+  if (nodes_.empty()) return false;
+  const vec3 inv_dir = vec3(1) / ray.dir;
+  bool found = false;
+
+  std::uint32_t stack[kStackSize];
+  int top = 0;
+  std::uint32_t index = 0;
+  for (;;) {
+    const Node& node = nodes_[index];
+    R t0 = tmin;
+    R t1 = tmax;
+    if (kx::intersect(ray.pos, inv_dir, node.box, t0, t1)) {
+      if (node.count == 0) {
+        // Visit the child on the ray's side of the split first, so that its
+        // hits shorten the ray before the other child is tested.
+        if (ray.dir[node.axis] < 0) {
+          stack[top++] = index + 1;
+          index = node.offset;
+        } else {
+          stack[top++] = node.offset;
+          index = index + 1;
+        }
+        continue;
+      }
+      for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+        R ti;
+        if (kx::intersect(ray, triangles_[i], ti, kMeshEdgeEps, 0) && ti >= tmin &&
+            ti <= tmax) {
+          tmax = ti;
+          t = ti;
+          triangle = ids_[i];
+          found = true;
+        }
+      }
+    }
+    if (top == 0) break;
+    index = stack[--top];
+  }
+  return found;
+}
+
+bool BVH::occluded(const Ray3& ray, R tmin, R tmax) const {
+  if (nodes_.empty()) return false;
+  const vec3 inv_dir = vec3(1) / ray.dir;
+
+  std::uint32_t stack[kStackSize];
+  int top = 0;
+  std::uint32_t index = 0;
+  for (;;) {
+    const Node& node = nodes_[index];
+    R t0 = tmin;
+    R t1 = tmax;
+    if (kx::intersect(ray.pos, inv_dir, node.box, t0, t1)) {
+      if (node.count == 0) {
+        stack[top++] = node.offset;
+        index = index + 1;
+        continue;
+      }
+      for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+        R t;
+        if (kx::intersect(ray, triangles_[i], t, kMeshEdgeEps, 0) && t >= tmin &&
+            t <= tmax)
+          return true;
+      }
+    }
+    if (top == 0) break;
+    index = stack[--top];
+  }
+  return false;
+}
+
+AABB3 BVH::bounds() const { return nodes_.empty() ? AABB3() : nodes_[0].box; }
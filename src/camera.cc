@@ -0,0 +1,58 @@
+#include <math/camera.h>
+
+#include <algorithm>
+
+using namespace kx;
+
+KX_MATH_API Camera::Camera()
+    : projection_valid_(false), view_valid_(false), view_version_(0) {
+  std::fill(params_, params_ + kMaxParameters, R(0));
+}
+
+void Camera::updateProjection() const {
+  R params[kMaxParameters] = {};
+  parameters(params);
+  if (projection_valid_ &&
+      std::equal(params, params + kMaxParameters, params_))
+    return;
+  std::copy(params, params + kMaxParameters, params_);
+  projection_ = computeProjection();
+  inverse_projection_ = computeInverseProjection();
+  projection_valid_ = true;
+  view_valid_ = false;
+}
+
+void Camera::updateView() const {
+  updateProjection();
+  if (view_valid_ && view_version_ == version()) return;
+  view_projection_ = projection_ * inverseTransform();
+  inverse_view_projection_ = transform() * inverse_projection_;
+  frustum_ = Frustum(view_projection_);
+  view_version_ = version();
+  view_valid_ = true;
+}
+
+KX_MATH_API const mat4& Camera::projection() const {
+  updateProjection();
+  return projection_;
+}
+
+KX_MATH_API const mat4& Camera::inverseProjection() const {
+  updateProjection();
+  return inverse_projection_;
+}
+
+KX_MATH_API const mat4& Camera::viewProjection() const {
+  updateView();
+  return view_projection_;
+}
+
+KX_MATH_API const mat4& Camera::inverseViewProjection() const {
+  updateView();
+  return inverse_view_projection_;
+}
+
+KX_MATH_API const Frustum& Camera::frustum() const {
+  updateView();
+  return frustum_;
+}
@@ -0,0 +1,176 @@
+#include <math/camera_rays.h>
+#include <math/parallel.h>
+#include <math/simd.h>
+#include <math/vec4.h>
+
+#include <cmath>
+
+using namespace kx;
+
+namespace {
+
+/// Rows per parallel chunk when generating a whole image.
+const std::size_t kGrain = 16;
+
+/// The affine coefficients of the six ray components: component k of the
+/// ray through (x, y) is c[k][0] + x * c[k][1] + y * c[k][2].
+struct Coefficients {
+  R c[6][3];
+};
+
+/// Return the coefficients of rays through the near point p + x p_dx + y p_dy
+/// with the direction d + x d_dx + y d_dy.
+Coefficients coefficients(const vec3& p, const vec3& p_dx, const vec3& p_dy,
+                          const vec3& d, const vec3& d_dx, const vec3& d_dy) {
+  Coefficients f;
+  for (int k = 0; k < 3; ++k) {
+    f.c[k][0] = p[k];
+    f.c[k][1] = p_dx[k];
+    f.c[k][2] = p_dy[k];
+    f.c[k + 3][0] = d[k];
+    f.c[k + 3][1] = d_dx[k];
+    f.c[k + 3][2] = d_dy[k];
+  }
+  return f;
+}
+
+/// Compute the rays through the image points (x, y), one per lane.
+template <typename V>
+void rays(const Coefficients& f, V x, V y, V out[6]) {
+  using std::sqrt;
+  for (int k = 0; k < 6; ++k)
+    out[k] = V(f.c[k][0]) + x * V(f.c[k][1]) + y * V(f.c[k][2]);
+  V inv_len = V(1) / sqrt(out[3] * out[3] + out[4] * out[4] + out[5] * out[5]);
+  out[3] = out[3] * inv_len;
+  out[4] = out[4] * inv_len;
+  out[5] = out[5] * inv_len;
+}
+
+/// Generate rows [row_begin, row_end) of the w pixel wide tile whose top-left
+/// pixel is (x0, y0).
+/// The offsets of ray i from its pixel's corner are (jx[i*stride],
+/// jy[i*stride]), or the pixel center if jx is null; jx and jy may alias the
+/// outputs.
+void generate_rows(const Coefficients& f, int x0, int y0, int w,
+                   std::size_t row_begin, std::size_t row_end, const R* jx,
+                   const R* jy, int stride, Ray3Batch& out) {
+  using simd::Rv;
+  R* dst[6] = {out.px.data(), out.py.data(), out.pz.data(),
+               out.dx.data(), out.dy.data(), out.dz.data()};
+  R lanes[Rv::N];
+  for (int l = 0; l < Rv::N; ++l) lanes[l] = R(l);
+  const Rv iota = simd::load(lanes);
+
+  for (std::size_t row = row_begin; row < row_end; ++row) {
+    const R y = R(y0) + R(row);
+    std::size_t i = row * std::size_t(w);
+    int col = 0;
+    for (; col + Rv::N <= w; col += Rv::N, i += Rv::N) {
+      Rv px = Rv(R(x0 + col)) + iota;
+      Rv py = Rv(y);
+      if (jx) {
+        px += simd::gather(jx + i * stride, stride);
+        py += simd::gather(jy + i * stride, stride);
+      } else {
+        px += Rv(R(0.5));
+        py += Rv(R(0.5));
+      }
+      Rv r[6];
+      rays(f, px, py, r);
+      for (int k = 0; k < 6; ++k) simd::store(dst[k] + i, r[k]);
+    }
+    for (; col < w; ++col, ++i) {
+      R px = R(x0 + col) + (jx ? jx[i * stride] : R(0.5));
+      R py = y + (jx ? jy[i * stride] : R(0.5));
+      R r[6];
+      rays(f, px, py, r);
+      for (int k = 0; k < 6; ++k) dst[k][i] = r[k];
+    }
+  }
+}
+
+}  // namespace
+
+CameraRays::CameraRays(const Camera& camera, int width, int height)
+    : width_(width), height_(height) {
+  const mat4& unproject = camera.inverseViewProjection();
+  const R w = R(width);
+  const R h = R(height);
+
+  // Unproject the image point (x, y) at normalised device depth z.
+  auto point = [&](R x, R y, R z) {
+    vec4 p = unproject * vec4(2 * x / w - 1, 1 - 2 * y / h, z, 1);
+    return vec3(p.x, p.y, p.z) / p.w;
+  };
+  vec3 near00 = point(0, 0, -1);
+  vec3 far00 = point(0, 0, 1);
+  vec3 near10 = point(w, 0, -1);
+  vec3 far10 = point(w, 0, 1);
+  vec3 near01 = point(0, h, -1);
+  vec3 far01 = point(0, h, 1);
+
+  p_ = near00;
+  p_dx_ = (near10 - near00) / w;
+  p_dy_ = (near01 - near00) / h;
+  d_ = far00 - near00;
+  d_dx_ = ((far10 - near10) - d_) / w;
+  d_dy_ = ((far01 - near01) - d_) / h;
+}
+
+Ray3 CameraRays::operator()(R x, R y) const {
+  return Ray3(p_ + x * p_dx_ + y * p_dy_,
+              normalise(d_ + x * d_dx_ + y * d_dy_));
+}
+
+void CameraRays::generate(int x0, int y0, int w, int h, Ray3Batch& out) const {
+  out.resize(std::size_t(w) * h);
+  generate_rows(coefficients(p_, p_dx_, p_dy_, d_, d_dx_, d_dy_), x0, y0, w, 0,
+                h, nullptr, nullptr, 1, out);
+}
+
+void CameraRays::generate(int x0, int y0, int w, int h, const vec2* jitter,
+                          Ray3Batch& out) const {
+  out.resize(std::size_t(w) * h);
+  generate_rows(coefficients(p_, p_dx_, p_dy_, d_, d_dx_, d_dy_), x0, y0, w, 0,
+                h, &jitter->x, &jitter->y, 2, out);
+}
+
+void CameraRays::generate(int x0, int y0, int w, int h, Philox4x32& gen,
+                          Ray3Batch& out) const {
+  // Draw the jitter into the direction arrays; each ray reads its offsets
+  // before writing its direction.
+  const std::size_t n = std::size_t(w) * h;
+  out.resize(n);
+  gen.generate_uniform(out.dx.data(), n);
+  gen.generate_uniform(out.dy.data(), n);
+  generate_rows(coefficients(p_, p_dx_, p_dy_, d_, d_dx_, d_dy_), x0, y0, w, 0,
+                h, out.dx.data(), out.dy.data(), 1, out);
+}
+
+void CameraRays::generate(Ray3Batch& out) const {
+  const Coefficients f = coefficients(p_, p_dx_, p_dy_, d_, d_dx_, d_dy_);
+  out.resize(std::size_t(width_) * height_);
+  parallel_for(height_, kGrain, [&](std::size_t begin, std::size_t end) {
+    generate_rows(f, 0, 0, width_, begin, end, nullptr, nullptr, 1, out);
+  });
+}
+
+void CameraRays::generate(const vec2* jitter, Ray3Batch& out) const {
+  const Coefficients f = coefficients(p_, p_dx_, p_dy_, d_, d_dx_, d_dy_);
+  out.resize(std::size_t(width_) * height_);
+  parallel_for(height_, kGrain, [&](std::size_t begin, std::size_t end) {
+    generate_rows(f, 0, 0, width_, begin, end, &jitter->x, &jitter->y, 2, out);
+  });
+}
+
+void CameraRays::generate(Philox4x32& gen, Ray3Batch& out) const {
+  const Coefficients f = coefficients(p_, p_dx_, p_dy_, d_, d_dx_, d_dy_);
+  const std::size_t n = std::size_t(width_) * height_;
+  out.resize(n);
+  gen.generate_uniform(out.dx.data(), n);
+  gen.generate_uniform(out.dy.data(), n);
+  parallel_for(height_, kGrain, [&](std::size_t begin, std::size_t end) {
+    generate_rows(f, 0, 0, width_, begin, end, out.dx.data(), out.dy.data(), 1,
+                  out);
+  });
+}
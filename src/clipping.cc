@@ -0,0 +1,159 @@
+#include <math/axis_plane.h>
+#include <math/clipping.h>
+#include <math/frustum.h>
+#include <math/intersection.h>
+
+#include <cassert>
+
+using namespace kx;
+
+namespace {
+
+/// Return the point where the edge ab crosses the plane, given the signed
+/// distances of a and b, of opposite signs.
+vec3 crossing(const vec3& a, const vec3& b, R da, R db) {
+  return a + (da / (da - db)) * (b - a);
+}
+
+/// Clip the polygon against the plane whose signed distances to its points
+/// are 'dist'.
+bool clip(const Polygon3& in, const R* dist, Polygon3& out) {
+  out.size = 0;
+  for (int i = 0; i < in.size; ++i) {
+    const int j = i + 1 == in.size ? 0 : i + 1;
+    const vec3& a = in.points[i];
+    const R da = dist[i];
+    const R db = dist[j];
+    if (da >= 0) out.points[out.size++] = a;
+    if ((da >= 0) != (db >= 0))
+      out.points[out.size++] = crossing(a, in.points[j], da, db);
+  }
+  assert(out.size <= Polygon3::kCapacity);
+  return out.size > 0;
+}
+
+/// Split the polygon along the plane whose signed distances to its points
+/// are 'dist'.
+void split(const Polygon3& in, const R* dist, Polygon3& front,
+           Polygon3& back) {
+  front.size = 0;
+  back.size = 0;
+  for (int i = 0; i < in.size; ++i) {
+    const int j = i + 1 == in.size ? 0 : i + 1;
+    const vec3& a = in.points[i];
+    const R da = dist[i];
+    const R db = dist[j];
+    if (da >= 0) front.points[front.size++] = a;
+    if (da <= 0) back.points[back.size++] = a;
+    if ((da > 0 && db < 0) || (da < 0 && db > 0)) {
+      vec3 p = crossing(a, in.points[j], da, db);
+      front.points[front.size++] = p;
+      back.points[back.size++] = p;
+    }
+  }
+  assert(front.size <= Polygon3::kCapacity);
+  assert(back.size <= Polygon3::kCapacity);
+}
+
+template <typename P>
+void distances(const Polygon3& in, const P& plane, R* dist) {
+  for (int i = 0; i < in.size; ++i) dist[i] = distanceTo(plane, in.points[i]);
+}
+
+/// Return the distance of the point inside the frustum plane, which faces
+/// out of the frustum.
+R inside_distance(const Plane& plane, const vec3& p) {
+  return -distanceTo(plane, p);
+}
+
+}  // namespace
+
+bool kx::clip(const Polygon3& in, const Plane& plane, Polygon3& out) {
+  R dist[Polygon3::kCapacity];
+  distances(in, plane, dist);
+  return ::clip(in, dist, out);
+}
+
+bool kx::clip(const Polygon3& in, const AxisPlane& plane, Polygon3& out) {
+  R dist[Polygon3::kCapacity];
+  distances(in, plane, dist);
+  return ::clip(in, dist, out);
+}
+
+bool kx::clip(const Polygon3& in, const Frustum& f, Polygon3& out) {
+  const Plane* planes[6] = {&f.left, &f.right, &f.bottom,
+                            &f.top,  &f.near,  &f.far};
+  Polygon3 tmp;
+  const Polygon3* src = &in;
+  Polygon3* dst = &tmp;
+  for (const Plane* plane : planes) {
+    R dist[Polygon3::kCapacity];
+    bool inside = true;
+    for (int i = 0; i < src->size; ++i) {
+      dist[i] = inside_distance(*plane, src->points[i]);
+      inside = inside && dist[i] >= 0;
+    }
+    if (inside) continue;  // the plane clips nothing
+    if (!::clip(*src, dist, *dst)) {
+      out.size = 0;
+      return false;
+    }
+    // Write the last clip to out, whichever buffer it started in.
+    src = dst;
+    dst = src == &tmp ? &out : &tmp;
+  }
+  if (src != &out) out = *src;
+  return out.size > 0;
+}
+
+void kx::split(const Polygon3& in, const Plane& plane, Polygon3& front,
+               Polygon3& back) {
+  R dist[Polygon3::kCapacity];
+  distances(in, plane, dist);
+  ::split(in, dist, front, back);
+}
+
+void kx::split(const Polygon3& in, const AxisPlane& plane, Polygon3& front,
+               Polygon3& back) {
+  R dist[Polygon3::kCapacity];
+  distances(in, plane, dist);
+  ::split(in, dist, front, back);
+}
+
+std::size_t kx::clip(const Triangle3* in, std::size_t n, const Frustum& f,
+                     Triangle3* out, std::uint32_t* source) {
+  const Plane* planes[6] = {&f.left, &f.right, &f.bottom,
+                            &f.top,  &f.near,  &f.far};
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const Triangle3& t = in[i];
+
+    // Classify the triangle against each plane before clipping anything.
+    bool outside = false;
+    bool inside = true;
+    for (const Plane* plane : planes) {
+      R d0 = inside_distance(*plane, t.p0);
+      R d1 = inside_distance(*plane, t.p1);
+      R d2 = inside_distance(*plane, t.p2);
+      if (d0 < 0 && d1 < 0 && d2 < 0) {
+        outside = true;
+        break;
+      }
+      inside = inside && d0 >= 0 && d1 >= 0 && d2 >= 0;
+    }
+    if (outside) continue;
+    if (inside) {
+      if (source) source[count] = std::uint32_t(i);
+      out[count++] = t;
+      continue;
+    }
+
+    Polygon3 p;
+    if (!clip(Polygon3(t), f, p)) continue;
+    for (int k = 1; k + 1 < p.size; ++k) {
+      if (source) source[count] = std::uint32_t(i);
+      out[count++] = Triangle3(p.points[0], p.points[k], p.points[k + 1]);
+    }
+  }
+  return count;
+}
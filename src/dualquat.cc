@@ -0,0 +1,40 @@
+#include <math/dualquat.h>
+
+using namespace kx;
+
+dualquat::dualquat(const quat& rotation, const vec3& t)
+    : real(rotation),
+      dual(quat(0, 0.5f * t.x, 0.5f * t.y, 0.5f * t.z) * rotation) {}
+
+dualquat kx::operator*(const dualquat& a, const dualquat& b) {
+  quat d1 = a.real * b.dual;
+  quat d2 = a.dual * b.real;
+  return dualquat(a.real * b.real,
+                  quat(d1.w + d2.w, d1.x + d2.x, d1.y + d2.y, d1.z + d2.z));
+}
+
+dualquat kx::conj(const dualquat& dq) {
+  return dualquat(conj(dq.real), conj(dq.dual));
+}
+
+dualquat kx::normalise(const dualquat& dq) {
+  R n = sqrt(dot(dq.real, dq.real));
+  n = n == 0.0f ? 1.0f : n;
+  const quat& r = dq.real;
+  const quat& d = dq.dual;
+  return dualquat(quat(r.w / n, r.x / n, r.y / n, r.z / n),
+                  quat(d.w / n, d.x / n, d.y / n, d.z / n));
+}
+
+// t = 2 * dual * conj(real)
+vec3 kx::translation(const dualquat& dq) {
+  const quat& r = dq.real;
+  const quat& d = dq.dual;
+  vec3 rv(r.x, r.y, r.z);
+  vec3 dv(d.x, d.y, d.z);
+  return 2 * (r.w * dv - d.w * rv + cross(rv, dv));
+}
+
+vec3 kx::transform(const dualquat& dq, const vec3& p) {
+  return rot(dq.real, p) + translation(dq);
+}
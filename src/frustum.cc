@@ -10,10 +10,11 @@ KX_MATH_API static Plane normalise_plane(R a, R b, R c, R d) {
   return Plane(-a / n, -b / n, -c / n, -d / n);
 }
 
+KX_MATH_API Frustum::Frustum(const Camera& cam) { *this = cam.frustum(); }
+
 // See:
 // http://gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
-KX_MATH_API Frustum::Frustum(const Camera& cam) {
-  mat4 M = cam.projection() * cam.inverseTransform();
+KX_MATH_API Frustum::Frustum(const mat4& M) {
   left = normalise_plane(M(3, 0) + M(0, 0), M(3, 1) + M(0, 1),
                          M(3, 2) + M(0, 2), M(3, 3) + M(0, 3));
   right = normalise_plane(M(3, 0) - M(0, 0), M(3, 1) - M(0, 1),
@@ -0,0 +1,214 @@
+#include <math/bounds.h>
+#include <math/frustum.h>
+#include <math/hash_grid.h>
+#include <math/intersection.h>
+#include <math/plane.h>
+#include <math/ray3.h>
+#include <math/sphere.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace kx;
+
+namespace {
+
+/// Marks the end of a list.
+const std::uint32_t kNone = 0xffffffff;
+
+/// Return the point where the three planes meet.
+vec3 corner(const Plane& p, const Plane& q, const Plane& r) {
+  const vec3 a(p.a, p.b, p.c);
+  const vec3 b(q.a, q.b, q.c);
+  const vec3 c(r.a, r.b, r.c);
+  const vec3 bc = cross(b, c);
+  return -(p.d * bc + q.d * cross(c, a) + r.d * cross(a, b)) / dot(a, bc);
+}
+
+/// Return the bounds of the frustum's corners.
+AABB3 box(const Frustum& f) {
+  AABB3 box;
+  for (int i = 0; i < 8; ++i)
+    box.add(corner((i & 1) ? f.right : f.left, (i & 2) ? f.top : f.bottom,
+                   (i & 4) ? f.far : f.near));
+  return box;
+}
+
+/// Return the cell coordinate of x, clamped to the range of int32.
+std::int32_t coordinate(R x) {
+  const R limit = R(1 << 30);
+  return std::int32_t(std::floor(std::min(std::max(x, -limit), limit)));
+}
+
+}  // namespace
+
+HashGrid::HashGrid(R cell_size, std::size_t num_buckets)
+    : inv_cell_size_(1 / cell_size) {
+  std::size_t n = 1;
+  while (n < num_buckets) n *= 2;
+  buckets_.resize(n);
+  clear();
+}
+
+void HashGrid::reserve(std::size_t n) { objects_.reserve(n); }
+
+std::uint32_t HashGrid::insert(const AABB3& bounds) {
+  std::uint32_t handle = free_object_;
+  if (handle == kNone) {
+    handle = std::uint32_t(objects_.size());
+    objects_.push_back(Object());
+  } else {
+    free_object_ = objects_[handle].next;
+  }
+  Object& o = objects_[handle];
+  o.bounds = bounds;
+  max_half_size_ = max(max_half_size_, (bounds.pmax - bounds.pmin) / R(2));
+  cell_of(bounds, o.cell);
+  link(handle);
+  ++size_;
+  return handle;
+}
+
+std::uint32_t HashGrid::insert(const Sphere& bounds) {
+  return insert(bounding_box(bounds));
+}
+
+void HashGrid::move(std::uint32_t handle, const AABB3& bounds) {
+  Object& o = objects_[handle];
+  o.bounds = bounds;
+  max_half_size_ = max(max_half_size_, (bounds.pmax - bounds.pmin) / R(2));
+  std::int32_t cell[3];
+  cell_of(bounds, cell);
+  if (cell[0] == o.cell[0] && cell[1] == o.cell[1] && cell[2] == o.cell[2])
+    return;
+  unlink(handle);
+  std::copy(cell, cell + 3, o.cell);
+  link(handle);
+}
+
+void HashGrid::move(std::uint32_t handle, const Sphere& bounds) {
+  move(handle, bounding_box(bounds));
+}
+
+void HashGrid::remove(std::uint32_t handle) {
+  unlink(handle);
+  objects_[handle].bucket = kNone;
+  objects_[handle].next = free_object_;
+  free_object_ = handle;
+  --size_;
+}
+
+void HashGrid::clear() {
+  std::fill(buckets_.begin(), buckets_.end(), kNone);
+  objects_.clear();
+  free_object_ = kNone;
+  max_half_size_ = vec3(0);
+  size_ = 0;
+}
+
+void HashGrid::cell_of(const AABB3& bounds, std::int32_t cell[3]) const {
+  const vec3 c = (bounds.pmin + bounds.pmax) / R(2) * inv_cell_size_;
+  cell[0] = coordinate(c.x);
+  cell[1] = coordinate(c.y);
+  cell[2] = coordinate(c.z);
+}
+
+std::uint32_t HashGrid::bucket(const std::int32_t cell[3]) const {
+  const std::uint32_t h = std::uint32_t(cell[0]) * 73856093u ^
+                          std::uint32_t(cell[1]) * 19349663u ^
+                          std::uint32_t(cell[2]) * 83492791u;
+  return h & std::uint32_t(buckets_.size() - 1);
+}
+
+void HashGrid::link(std::uint32_t handle) {
+  Object& o = objects_[handle];
+  o.bucket = bucket(o.cell);
+  o.prev = kNone;
+  o.next = buckets_[o.bucket];
+  if (o.next != kNone) objects_[o.next].prev = handle;
+  buckets_[o.bucket] = handle;
+}
+
+void HashGrid::unlink(std::uint32_t handle) {
+  const Object& o = objects_[handle];
+  if (o.prev != kNone)
+    objects_[o.prev].next = o.next;
+  else
+    buckets_[o.bucket] = o.next;
+  if (o.next != kNone) objects_[o.next].prev = o.prev;
+}
+
+template <typename Overlaps>
+void HashGrid::collect(const AABB3& range, Overlaps overlaps,
+                       std::vector<std::uint32_t>& out) const {
+  if (size_ == 0) return;
+
+  // The objects overlapping the range have their centers in the range
+  // widened by their half-size.
+  const vec3 lo = (range.pmin - max_half_size_) * inv_cell_size_;
+  const vec3 hi = (range.pmax + max_half_size_) * inv_cell_size_;
+  R num_cells = 1;
+  for (int d = 0; d < 3; ++d)
+    num_cells *= std::floor(hi[d]) - std::floor(lo[d]) + 1;
+
+  // Test every object if there are more cells than buckets, or the range is
+  // unbounded.
+  if (!(num_cells <= R(buckets_.size()))) {
+    for (std::uint32_t i = 0; i < objects_.size(); ++i)
+      if (objects_[i].bucket != kNone && overlaps(objects_[i].bounds))
+        out.push_back(i);
+    return;
+  }
+
+  const std::int32_t c0[3] = {coordinate(lo.x), coordinate(lo.y),
+                              coordinate(lo.z)};
+  const std::int32_t c1[3] = {coordinate(hi.x), coordinate(hi.y),
+                              coordinate(hi.z)};
+  std::int32_t c[3];
+  for (c[2] = c0[2]; c[2] <= c1[2]; ++c[2]) {
+    for (c[1] = c0[1]; c[1] <= c1[1]; ++c[1]) {
+      for (c[0] = c0[0]; c[0] <= c1[0]; ++c[0]) {
+        // Buckets are shared by cells; skip the objects of the others.
+        for (std::uint32_t i = buckets_[bucket(c)]; i != kNone;
+             i = objects_[i].next) {
+          const Object& o = objects_[i];
+          if (o.cell[0] == c[0] && o.cell[1] == c[1] && o.cell[2] == c[2] &&
+              overlaps(o.bounds))
+            out.push_back(i);
+        }
+      }
+    }
+  }
+}
+
+void HashGrid::query(const AABB3& box, std::vector<std::uint32_t>& out) const {
+  collect(box, [&](const AABB3& b) { return intersect(box, b); }, out);
+}
+
+void HashGrid::query(const Sphere& sphere,
+                     std::vector<std::uint32_t>& out) const {
+  collect(bounding_box(sphere),
+          [&](const AABB3& b) { return intersect(sphere, b); }, out);
+}
+
+void HashGrid::query(const Frustum& frustum,
+                     std::vector<std::uint32_t>& out) const {
+  collect(
+      box(frustum),
+      [&](const AABB3& b) {
+        return intersect(frustum, b) != VolumeIntersection::outside;
+      },
+      out);
+}
+
+void HashGrid::query(const Ray3& ray, R tmax,
+                     std::vector<std::uint32_t>& out) const {
+  const vec3 inv_dir = vec3(1) / ray.dir;
+  const vec3 end = ray.pos + tmax * ray.dir;
+  collect(AABB3(min(ray.pos, end), max(ray.pos, end)),
+          [&](const AABB3& b) {
+            R t0 = 0;
+            R t1 = tmax;
+            return intersect(ray.pos, inv_dir, b, t0, t1);
+          }, out);
+}
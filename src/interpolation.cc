@@ -1,9 +1,19 @@
 #include <math/determinant.h>
 #include <math/interpolation.h>
 #include <math/intersection.h>
+#include <math/vec_expr.h>
 
 using namespace kx;
 
+void kx::interpolate(const vec3* p0, const vec3* p1, const vec3* p2,
+                     const vec2* st, vec3* out, std::size_t n) {
+  VecArray<vec3> a = vec_array(p0, n);
+  VecArray<vec3> b = vec_array(p1, n);
+  VecArray<vec3> c = vec_array(p2, n);
+  VecArray<vec2> uv = vec_array(st, n);
+  evaluate(out, a + get_x(uv) * (b - a) + get_y(uv) * (c - a));
+}
+
 kx::vec2 kx::barycentric_coordinates(const Triangle2& triangle, const vec2& p) {
   return barycentric_coordinates(triangle.p0, triangle.p1, triangle.p2, p);
 }
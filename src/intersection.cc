@@ -11,6 +11,7 @@
 #include <math/triangle3.h>
 
 #include <limits>
+#include <utility>
 
 using namespace kx;
 using namespace std;
@@ -203,6 +204,18 @@ KX_MATH_API bool kx::intersect(const Ray3& r, const AABB3& a, R& tmin,
   return tmax >= 0 && tmin <= tmax;
 }
 
+KX_MATH_API bool kx::intersect(const vec3& pos, const vec3& inv_dir,
+                               const AABB3& a, R& tmin, R& tmax) {
+  for (int d = 0; d < 3; ++d) {
+    R t0 = (a.pmin[d] - pos[d]) * inv_dir[d];
+    R t1 = (a.pmax[d] - pos[d]) * inv_dir[d];
+    if (t0 > t1) std::swap(t0, t1);
+    tmin = t0 > tmin ? t0 : tmin;
+    tmax = t1 < tmax ? t1 : tmax;
+  }
+  return tmin <= tmax;
+}
+
 KX_MATH_API bool kx::intersect(const Ray3& r, const Sphere& s, R& tmin,
                                R& tmax) {
   vec3 l = s.center - r.pos;
@@ -279,6 +292,15 @@ KX_MATH_API bool kx::intersect(const Ray3& r, const Sphere& s) {
   return a2 < r2;
 }
 
+KX_MATH_API bool kx::intersect(const AABB3& a, const AABB3& b) {
+  return a.overlaps(b);
+}
+
+KX_MATH_API bool kx::intersect(const Sphere& s, const AABB3& box) {
+  vec3 p = kx::max(box.pmin, kx::min(s.center, box.pmax));
+  return norm2(p - s.center) <= s.radius2;
+}
+
 KX_MATH_API bool kx::contains(const Frustum& f, const vec3& p) {
   return classify(f.left, p) == Side::front &&
          classify(f.right, p) == Side::front &&
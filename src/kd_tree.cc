@@ -0,0 +1,419 @@
+#include <math/axis_plane.h>
+#include <math/clipping.h>
+#include <math/intersection.h>
+#include <math/kd_tree.h>
+#include <math/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace kx;
+
+namespace {
+
+/// Triangles per parallel chunk when preparing the build.
+const std::size_t kGrain = 1 << 14;
+
+/// Costs of visiting an inner node and of testing a triangle.
+const R kTraversalCost = 1;
+const R kIntersectionCost = R(1.5);
+
+/// Factor applied to the cost of splits that leave one side empty, which
+/// favours cutting off empty space.
+const R kEmptyBonus = R(0.8);
+
+/// The tree is at most 8 + 1.3 log2(n) deep, as deeper trees mostly cut
+/// empty space, and at most kStackSize deep, which bounds the traversal stack.
+const int kStackSize = 64;
+
+int max_depth(std::size_t n) {
+  int depth = 8 + int(R(1.3) * std::log2(R(n)));
+  return std::min(depth, kStackSize);
+}
+
+/// Return the bounds of the part of the triangle inside the voxel.
+AABB3 clipped_bounds(const Triangle3& t, const AABB3& voxel) {
+  AABB3 box;
+  Polygon3 p(t);
+  Polygon3 q;
+  Polygon3 unused;
+  for (int a = 0; a < 3 && !p.empty(); ++a) {
+    const AxisPlane::Axis axis = AxisPlane::Axis(a);
+    clip(p, AxisPlane(axis, voxel.pmin[a]), q);
+    split(q, AxisPlane(axis, voxel.pmax[a]), unused, p);
+  }
+  for (int i = 0; i < p.size; ++i) box.add(p.points[i]);
+
+  // Clipping a triangle that grazes the voxel may round it away; fall back to
+  // its bounds then. Either way, keep the box inside the voxel.
+  if (p.empty()) {
+    box.add(t.p0);
+    box.add(t.p1);
+    box.add(t.p2);
+  }
+  return intersection(box, voxel);
+}
+
+/// The start or end of a triangle's bounds along an axis, or both if the
+/// triangle lies in a plane perpendicular to the axis. Events sort by
+/// position, then ends first, so that a sweep sees the triangles ending at a
+/// plane before those starting there.
+struct Event {
+  enum Type { kEnd = 0, kPlanar = 1, kStart = 2 };
+
+  R pos;
+  std::uint32_t id;
+  std::uint32_t type;
+
+  bool operator<(const Event& e) const {
+    return pos < e.pos || (pos == e.pos && type < e.type);
+  }
+};
+
+using Events = std::vector<Event>;
+
+/// Add the events of the triangle's bounds to the per-axis lists.
+void add_events(const AABB3& box, std::uint32_t id, Events events[3]) {
+  for (int a = 0; a < 3; ++a) {
+    if (box.pmin[a] == box.pmax[a]) {
+      events[a].push_back({box.pmin[a], id, Event::kPlanar});
+    } else {
+      events[a].push_back({box.pmin[a], id, Event::kStart});
+      events[a].push_back({box.pmax[a], id, Event::kEnd});
+    }
+  }
+}
+
+/// Which children of a split reference a triangle.
+enum Side : std::uint8_t { kBoth, kLeftOnly, kRightOnly };
+
+/// A split plane and its cost.
+struct Split {
+  int axis;
+  R pos;
+  bool planar_left;  // whether the triangles in the plane go left
+  R cost;
+};
+
+/// Return the SAH cost of splitting a voxel into children with the given
+/// areas relative to it and triangle counts.
+R split_cost(R pl, R pr, std::size_t nl, std::size_t nr) {
+  R cost = kTraversalCost + kIntersectionCost * (pl * R(nl) + pr * R(nr));
+  return nl == 0 || nr == 0 ? kEmptyBonus * cost : cost;
+}
+
+/// Builds the node array from sorted event lists, recursively.
+template <typename Node>
+class Builder {
+ public:
+  Builder(const std::vector<Triangle3>& triangles, std::vector<Node>& nodes,
+          std::vector<std::uint32_t>& ids)
+      : triangles_(triangles),
+        nodes_(nodes),
+        ids_(ids),
+        sides_(triangles.size()),
+        max_depth_(max_depth(triangles.size())) {}
+
+  /// Build the subtree over the voxel, taking the events of its triangles.
+  void build(const AABB3& voxel, Events events[3], int depth) {
+    const std::size_t index = nodes_.size();
+    nodes_.push_back(Node());
+
+    // Each triangle has a start or a planar event along each axis.
+    std::size_t n = 0;
+    for (const Event& e : events[0]) n += e.type != Event::kEnd;
+
+    Split best = {0, 0, true, 0};
+    if (n <= 1 || depth >= max_depth_ || !find_split(voxel, events, n, best) ||
+        best.cost >= kIntersectionCost * R(n)) {
+      nodes_[index].first = std::uint32_t(ids_.size());
+      nodes_[index].flags = 3 | std::uint32_t(n) << 2;
+      for (const Event& e : events[0])
+        if (e.type != Event::kEnd) ids_.push_back(e.id);
+      return;
+    }
+
+    // The plane is stored in single precision; split at the stored value so
+    // that the traversal agrees with the build.
+    const float split = float(best.pos);
+    const R pos = std::min(std::max(R(split), voxel.pmin[best.axis]),
+                           voxel.pmax[best.axis]);
+    AABB3 left_voxel = voxel;
+    AABB3 right_voxel = voxel;
+    left_voxel.pmax[best.axis] = pos;
+    right_voxel.pmin[best.axis] = pos;
+
+    Events left[3];
+    Events right[3];
+    partition(events, best.axis, pos, best.planar_left, left_voxel,
+              right_voxel, left, right);
+
+    build(left_voxel, left, depth + 1);
+    nodes_[index].split = split;
+    nodes_[index].flags =
+        std::uint32_t(best.axis) | std::uint32_t(nodes_.size()) << 2;
+    for (Events& e : left) Events().swap(e);
+    build(right_voxel, right, depth + 1);
+  }
+
+ private:
+  /// Sweep the events of each axis to find the split with the lowest cost.
+  /// Return false if the voxel cannot be split.
+  bool find_split(const AABB3& voxel, const Events events[3], std::size_t n,
+                  Split& best) const {
+    const R area = voxel.surfaceArea();
+    if (!(area > 0)) return false;
+    best.cost = std::numeric_limits<R>::infinity();
+    for (int a = 0; a < 3; ++a) {
+      const Events& ev = events[a];
+      const R lo = voxel.pmin[a];
+      const R hi = voxel.pmax[a];
+      std::size_t nl = 0;
+      std::size_t nr = n;
+      for (std::size_t i = 0; i < ev.size();) {
+        // Count the triangles ending in, lying in and starting at the plane.
+        const R pos = ev[i].pos;
+        std::size_t ending = 0;
+        std::size_t planar = 0;
+        std::size_t starting = 0;
+        for (; i < ev.size() && ev[i].pos == pos; ++i) {
+          if (ev[i].type == Event::kEnd) ++ending;
+          if (ev[i].type == Event::kPlanar) ++planar;
+          if (ev[i].type == Event::kStart) ++starting;
+        }
+        nr -= planar + ending;
+
+        // Planes on the voxel's faces would leave a child empty and flat.
+        if (pos > lo && pos < hi) {
+          AABB3 l = voxel;
+          AABB3 r = voxel;
+          l.pmax[a] = pos;
+          r.pmin[a] = pos;
+          const R pl = l.surfaceArea() / area;
+          const R pr = r.surfaceArea() / area;
+          const R cost_left = split_cost(pl, pr, nl + planar, nr);
+          const R cost_right = split_cost(pl, pr, nl, nr + planar);
+          const R cost = std::min(cost_left, cost_right);
+          if (cost < best.cost) {
+            best.axis = a;
+            best.pos = pos;
+            best.planar_left = cost_left <= cost_right;
+            best.cost = cost;
+          }
+        }
+        nl += starting + planar;
+      }
+    }
+    return best.cost < std::numeric_limits<R>::infinity();
+  }
+
+  /// Distribute the events between the children. Triangles on one side
+  /// keep their events, which stay sorted; triangles straddling the plane
+  /// are clipped to each child and get new events, which are sorted and
+  /// merged in.
+  void partition(Events events[3], int axis, R pos, bool planar_left,
+                 const AABB3& left_voxel, const AABB3& right_voxel,
+                 Events left[3], Events right[3]) {
+    for (const Event& e : events[axis]) sides_[e.id] = kBoth;
+    for (const Event& e : events[axis]) {
+      if (e.type == Event::kEnd && e.pos <= pos)
+        sides_[e.id] = kLeftOnly;
+      else if (e.type == Event::kStart && e.pos >= pos)
+        sides_[e.id] = kRightOnly;
+      else if (e.type == Event::kPlanar)
+        sides_[e.id] = e.pos < pos || (e.pos == pos && planar_left)
+                           ? kLeftOnly
+                           : kRightOnly;
+    }
+
+    for (int a = 0; a < 3; ++a) {
+      for (const Event& e : events[a]) {
+        if (sides_[e.id] == kLeftOnly) left[a].push_back(e);
+        if (sides_[e.id] == kRightOnly) right[a].push_back(e);
+      }
+    }
+
+    Events new_left[3];
+    Events new_right[3];
+    for (const Event& e : events[axis]) {
+      if (e.type != Event::kStart || sides_[e.id] != kBoth) continue;
+      const Triangle3& t = triangles_[e.id];
+      add_events(clipped_bounds(t, left_voxel), e.id, new_left);
+      add_events(clipped_bounds(t, right_voxel), e.id, new_right);
+    }
+    for (int a = 0; a < 3; ++a) {
+      Events().swap(events[a]);
+      merge(left[a], new_left[a]);
+      merge(right[a], new_right[a]);
+    }
+  }
+
+  static void merge(Events& events, Events& added) {
+    if (added.empty()) return;
+    std::sort(added.begin(), added.end());
+    const std::size_t n = events.size();
+    events.insert(events.end(), added.begin(), added.end());
+    std::inplace_merge(events.begin(), events.begin() + n, events.end());
+  }
+
+  const std::vector<Triangle3>& triangles_;
+  std::vector<Node>& nodes_;
+  std::vector<std::uint32_t>& ids_;
+  std::vector<std::uint8_t> sides_;
+  const int max_depth_;
+};
+
+}  // namespace
+
+KdTree::KdTree(const Triangle3* triangles, std::size_t n)
+    : triangles_(triangles, triangles + n) {
+  build();
+}
+
+KdTree::KdTree(const vec3* vertices, const std::uint32_t* indices,
+               std::size_t num_triangles)
+    : triangles_(mesh_triangles(vertices, indices, num_triangles)) {
+  build();
+}
+
+void KdTree::build() {
+  const std::size_t n = triangles_.size();
+  if (n == 0) return;
+
+  std::vector<AABB3> boxes(n);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const Triangle3& t = triangles_[i];
+      boxes[i] = AABB3(min(t.p0, min(t.p1, t.p2)), max(t.p0, max(t.p1, t.p2)));
+    }
+  });
+  bounds_ = AABB3();
+  for (const AABB3& b : boxes) bounds_.add(b);
+
+  // Sort the events once; splitting keeps them sorted.
+  Events events[3];
+  for (std::uint32_t i = 0; i < n; ++i) add_events(boxes[i], i, events);
+  parallel_for(3, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t a = begin; a < end; ++a)
+      std::sort(events[a].begin(), events[a].end());
+  });
+
+  Builder<Node>(triangles_, nodes_, ids_).build(bounds_, events, 0);
+  nodes_.shrink_to_fit();
+  ids_.shrink_to_fit();
+}
+
+bool KdTree::intersect(const Ray3& ray, R tmin, R tmax, R& t,
+                       std::uint32_t& triangle) const {
+  if (nodes_.empty()) return false;
+  const vec3 inv_dir = vec3(1) / ray.dir;
+  R t0 = tmin;
+  R t1 = tmax;
+  if (!kx::intersect(ray.pos, inv_dir, bounds_, t0, t1)) return false;
+  bool found = false;
+
+  struct Entry {
+    std::uint32_t index;
+    R t0, t1;
+  };
+  Entry stack[kStackSize];
+  int top = 0;
+  std::uint32_t index = 0;
+  for (;;) {
+    // Stop once a hit lies before the nodes left to visit.
+    if (tmax < t0) break;
+    const Node& node = nodes_[index];
+    if (!node.leaf()) {
+      // Visit the child on the ray origin's side of the plane first, and the
+      // other one if the ray crosses the plane within [t0, t1].
+      const int a = node.axis();
+      const R split = R(node.split);
+      const R t_plane = (split - ray.pos[a]) * inv_dir[a];
+      const bool below_first =
+          ray.pos[a] < split || (ray.pos[a] == split && ray.dir[a] <= 0);
+      const std::uint32_t first = below_first ? index + 1 : node.above();
+      const std::uint32_t second = below_first ? node.above() : index + 1;
+      if (!(t_plane <= t1) || t_plane <= 0) {
+        index = first;
+      } else if (t_plane < t0) {
+        index = second;
+      } else {
+        stack[top++] = {second, t_plane, t1};
+        index = first;
+        t1 = t_plane;
+      }
+      continue;
+    }
+
+    const std::uint32_t* ids = ids_.data() + node.first;
+    for (std::uint32_t i = 0; i < node.count(); ++i) {
+      R ti;
+      if (kx::intersect(ray, triangles_[ids[i]], ti, kMeshEdgeEps, 0) &&
+          ti >= tmin && ti <= tmax) {
+        tmax = ti;
+        t = ti;
+        triangle = ids[i];
+        found = true;
+      }
+    }
+    if (top == 0) break;
+    --top;
+    index = stack[top].index;
+    t0 = stack[top].t0;
+    t1 = stack[top].t1;
+  }
+  return found;
+}
+
+bool KdTree::occluded(const Ray3& ray, R tmin, R tmax) const {
+  if (nodes_.empty()) return false;
+  const vec3 inv_dir = vec3(1) / ray.dir;
+  R t0 = tmin;
+  R t1 = tmax;
+  if (!kx::intersect(ray.pos, inv_dir, bounds_, t0, t1)) return false;
+
+  struct Entry {
+    std::uint32_t index;
+    R t0, t1;
+  };
+  Entry stack[kStackSize];
+  int top = 0;
+  std::uint32_t index = 0;
+  for (;;) {
+    const Node& node = nodes_[index];
+    if (!node.leaf()) {
+      const int a = node.axis();
+      const R split = R(node.split);
+      const R t_plane = (split - ray.pos[a]) * inv_dir[a];
+      const bool below_first =
+          ray.pos[a] < split || (ray.pos[a] == split && ray.dir[a] <= 0);
+      const std::uint32_t first = below_first ? index + 1 : node.above();
+      const std::uint32_t second = below_first ? node.above() : index + 1;
+      if (!(t_plane <= t1) || t_plane <= 0) {
+        index = first;
+      } else if (t_plane < t0) {
+        index = second;
+      } else {
+        stack[top++] = {second, t_plane, t1};
+        index = first;
+        t1 = t_plane;
+      }
+      continue;
+    }
+
+    const std::uint32_t* ids = ids_.data() + node.first;
+    for (std::uint32_t i = 0; i < node.count(); ++i) {
+      R t;
+      if (kx::intersect(ray, triangles_[ids[i]], t, kMeshEdgeEps, 0) &&
+          t >= tmin && t <= tmax)
+        return true;
+    }
+    if (top == 0) break;
+    --top;
+    index = stack[top].index;
+    t0 = stack[top].t0;
+    t1 = stack[top].t1;
+  }
+  return false;
+}
@@ -0,0 +1,237 @@
+#include <math/bounds.h>
+#include <math/frustum.h>
+#include <math/intersection.h>
+#include <math/loose_octree.h>
+#include <math/ray3.h>
+#include <math/sphere.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace kx;
+
+namespace {
+
+/// Marks the end of a list and missing children.
+const std::uint32_t kNone = 0xffffffff;
+
+}  // namespace
+
+const int LooseOctree::kMaxDepth;
+
+LooseOctree::LooseOctree(const AABB3& world, int max_depth)
+    : origin_(world.pmin),
+      extent_(std::max(world.pmax.x - world.pmin.x,
+                       std::max(world.pmax.y - world.pmin.y,
+                                world.pmax.z - world.pmin.z))),
+      max_depth_(std::min(std::max(max_depth, 0), kMaxDepth)) {
+  clear();
+}
+
+void LooseOctree::reserve(std::size_t n) { objects_.reserve(n); }
+
+std::uint32_t LooseOctree::insert(const AABB3& bounds) {
+  std::uint32_t handle = free_object_;
+  if (handle == kNone) {
+    handle = std::uint32_t(objects_.size());
+    objects_.push_back(Object());
+  } else {
+    free_object_ = objects_[handle].next;
+  }
+  objects_[handle].bounds = bounds;
+  link(handle, cell(bounds));
+  ++size_;
+  return handle;
+}
+
+std::uint32_t LooseOctree::insert(const Sphere& bounds) {
+  return insert(bounding_box(bounds));
+}
+
+void LooseOctree::move(std::uint32_t handle, const AABB3& bounds) {
+  Object& o = objects_[handle];
+  o.bounds = bounds;
+  if (fits(bounds, o.node)) return;
+  unlink(handle);
+  link(handle, cell(bounds));
+}
+
+void LooseOctree::move(std::uint32_t handle, const Sphere& bounds) {
+  move(handle, bounding_box(bounds));
+}
+
+void LooseOctree::remove(std::uint32_t handle) {
+  unlink(handle);
+  objects_[handle].next = free_object_;
+  free_object_ = handle;
+  --size_;
+}
+
+void LooseOctree::clear() {
+  const vec3 center = origin_ + vec3(extent_ / 2);
+  Node root;
+  root.loose = AABB3(center - vec3(extent_), center + vec3(extent_));
+  std::fill(root.children, root.children + 8, kNone);
+  root.parent = kNone;
+  root.first = kNone;
+  root.count = 0;
+  root.depth = 0;
+  root.slot = 0;
+  nodes_.assign(1, root);
+  objects_.clear();
+  free_node_ = kNone;
+  free_object_ = kNone;
+  size_ = 0;
+}
+
+/// Return the depth of the cells that fit the bounds: the deepest whose size
+/// is at least that of the bounds, or 0 if they are centered outside the
+/// world.
+int LooseOctree::depth(const AABB3& bounds) const {
+  const vec3 c = (bounds.pmin + bounds.pmax) / R(2) - origin_;
+  if (!(c.x >= 0 && c.y >= 0 && c.z >= 0 && c.x <= extent_ &&
+        c.y <= extent_ && c.z <= extent_))
+    return 0;
+  const vec3 d = bounds.pmax - bounds.pmin;
+  const R size = std::max(d.x, std::max(d.y, d.z));
+  int depth = 0;
+  for (R s = extent_ / 2; depth < max_depth_ && size <= s; s /= 2) ++depth;
+  return depth;
+}
+
+/// Return true if the node is the cell of the bounds.
+bool LooseOctree::fits(const AABB3& bounds, std::uint32_t node) const {
+  const Node& n = nodes_[node];
+  if (depth(bounds) != n.depth) return false;
+  const vec3 c = (bounds.pmin + bounds.pmax) / R(2);
+  const vec3 d = c - (n.loose.pmin + n.loose.pmax) / R(2);
+  const R half = (n.loose.pmax.x - n.loose.pmin.x) / 4;
+  return std::abs(d.x) <= half && std::abs(d.y) <= half &&
+         std::abs(d.z) <= half;
+}
+
+/// Return the cell of the bounds, creating it and its parents if needed.
+std::uint32_t LooseOctree::cell(const AABB3& bounds) {
+  const vec3 c = (bounds.pmin + bounds.pmax) / R(2);
+  std::uint32_t node = 0;
+  for (int d = depth(bounds); d > 0; --d) {
+    const AABB3& loose = nodes_[node].loose;
+    const vec3 mid = (loose.pmin + loose.pmax) / R(2);
+    const int slot = (c.x >= mid.x) | (c.y >= mid.y) << 1 | (c.z >= mid.z) << 2;
+    node = child(node, slot);
+  }
+  return node;
+}
+
+std::uint32_t LooseOctree::child(std::uint32_t node, int slot) {
+  if (nodes_[node].children[slot] != kNone) return nodes_[node].children[slot];
+
+  std::uint32_t index = free_node_;
+  if (index == kNone) {
+    index = std::uint32_t(nodes_.size());
+    nodes_.push_back(Node());
+  } else {
+    free_node_ = nodes_[index].first;
+  }
+
+  // The child's cell is an eighth of its parent's, and its loose bounds
+  // extend its cell by half its size on each side.
+  Node& parent = nodes_[node];
+  const vec3 mid = (parent.loose.pmin + parent.loose.pmax) / R(2);
+  const R quarter = (parent.loose.pmax.x - parent.loose.pmin.x) / 8;
+  const vec3 center(mid.x + ((slot & 1) ? quarter : -quarter),
+                    mid.y + ((slot & 2) ? quarter : -quarter),
+                    mid.z + ((slot & 4) ? quarter : -quarter));
+  Node& n = nodes_[index];
+  n.loose = AABB3(center - vec3(2 * quarter), center + vec3(2 * quarter));
+  std::fill(n.children, n.children + 8, kNone);
+  n.parent = node;
+  n.first = kNone;
+  n.count = 0;
+  n.depth = std::uint8_t(parent.depth + 1);
+  n.slot = std::uint8_t(slot);
+  parent.children[slot] = index;
+  return index;
+}
+
+void LooseOctree::link(std::uint32_t handle, std::uint32_t node) {
+  Object& o = objects_[handle];
+  Node& n = nodes_[node];
+  o.node = node;
+  o.prev = kNone;
+  o.next = n.first;
+  if (n.first != kNone) objects_[n.first].prev = handle;
+  n.first = handle;
+  for (std::uint32_t i = node; i != kNone; i = nodes_[i].parent)
+    ++nodes_[i].count;
+}
+
+void LooseOctree::unlink(std::uint32_t handle) {
+  const Object& o = objects_[handle];
+  if (o.prev != kNone)
+    objects_[o.prev].next = o.next;
+  else
+    nodes_[o.node].first = o.next;
+  if (o.next != kNone) objects_[o.next].prev = o.prev;
+
+  // Free the cells left empty; their children are already free.
+  for (std::uint32_t i = o.node; i != kNone;) {
+    Node& n = nodes_[i];
+    const std::uint32_t parent = n.parent;
+    if (--n.count == 0 && parent != kNone) {
+      nodes_[parent].children[n.slot] = kNone;
+      n.first = free_node_;
+      free_node_ = i;
+    }
+    i = parent;
+  }
+}
+
+template <typename Overlaps>
+void LooseOctree::collect(Overlaps overlaps,
+                          std::vector<std::uint32_t>& out) const {
+  if (size_ == 0) return;
+
+  // The root also holds the objects outside the world, so it is always
+  // visited.
+  std::uint32_t stack[8 * kMaxDepth + 1];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0) {
+    const Node& n = nodes_[stack[--top]];
+    for (std::uint32_t i = n.first; i != kNone; i = objects_[i].next)
+      if (overlaps(objects_[i].bounds)) out.push_back(i);
+    for (std::uint32_t c : n.children)
+      if (c != kNone && overlaps(nodes_[c].loose)) stack[top++] = c;
+  }
+}
+
+void LooseOctree::query(const AABB3& box,
+                        std::vector<std::uint32_t>& out) const {
+  collect([&](const AABB3& b) { return intersect(box, b); }, out);
+}
+
+void LooseOctree::query(const Sphere& sphere,
+                        std::vector<std::uint32_t>& out) const {
+  collect([&](const AABB3& b) { return intersect(sphere, b); }, out);
+}
+
+void LooseOctree::query(const Frustum& frustum,
+                        std::vector<std::uint32_t>& out) const {
+  collect(
+      [&](const AABB3& b) {
+        return intersect(frustum, b) != VolumeIntersection::outside;
+      },
+      out);
+}
+
+void LooseOctree::query(const Ray3& ray, R tmax,
+                        std::vector<std::uint32_t>& out) const {
+  const vec3 inv_dir = vec3(1) / ray.dir;
+  collect([&](const AABB3& b) {
+            R t0 = 0;
+            R t1 = tmax;
+            return intersect(ray.pos, inv_dir, b, t0, t1);
+          },
+          out);
+}
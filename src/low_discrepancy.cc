@@ -0,0 +1,366 @@
+#include <math/low_discrepancy.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace kx;
+
+namespace {
+
+/// The largest real below 1.
+const R kOneMinusEpsilon = R(1) - std::numeric_limits<R>::epsilon() / 2;
+
+/// Return the number of base-b digits that fit in 64 bits, and b to that
+/// power in 'scale'.
+int max_digits(unsigned base, std::uint64_t& scale) {
+  int n = 0;
+  scale = 1;
+  while (scale <= std::numeric_limits<std::uint64_t>::max() / base) {
+    scale *= base;
+    ++n;
+  }
+  return n;
+}
+
+/// Map an integer numerator over 'scale' to [0,1).
+R fraction(std::uint64_t numerator, std::uint64_t scale) {
+  return std::min(R(numerator) / R(scale), kOneMinusEpsilon);
+}
+
+//
+// Sobol
+//
+
+/// Direction numbers of the two dimensions.
+struct Directions {
+  std::uint32_t v[2][32];
+
+  Directions() {
+    for (int k = 0; k < 32; ++k) v[0][k] = 1u << (31 - k);
+    v[1][0] = 1u << 31;
+    for (int k = 1; k < 32; ++k) v[1][k] = v[1][k - 1] ^ (v[1][k - 1] >> 1);
+  }
+};
+
+const Directions kDirections;
+
+/// Return the number of trailing zero bits of a non-zero integer.
+int trailing_zeros(std::uint32_t x) {
+  int n = 0;
+  while (!(x & 1)) {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+}
+
+std::uint32_t reverse_bits(std::uint32_t x) {
+  x = (x << 16) | (x >> 16);
+  x = ((x & 0x00ff00ff) << 8) | ((x & 0xff00ff00) >> 8);
+  x = ((x & 0x0f0f0f0f) << 4) | ((x & 0xf0f0f0f0) >> 4);
+  x = ((x & 0x33333333) << 2) | ((x & 0xcccccccc) >> 2);
+  x = ((x & 0x55555555) << 1) | ((x & 0xaaaaaaaa) >> 1);
+  return x;
+}
+
+/// Owen-scramble a 32-bit fixed point coordinate.
+/// Each step only propagates bits upwards, so in the bit-reversed value each
+/// digit is permuted depending on the digits above it, as in Owen's nested
+/// uniform scrambling. This is the Laine-Karras hash in Burley's form.
+std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed) {
+  x = reverse_bits(x);
+  x += seed;
+  x ^= x * 0x6c50b47c;
+  x ^= x * 0xb82f1e52;
+  x ^= x * 0xc7afe638;
+  x ^= x * 0x8d22f6e6;
+  return reverse_bits(x);
+}
+
+/// Mix the bits of a seed (the "lowbias32" integer hash).
+std::uint32_t hash(std::uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+/// Map a 32-bit fixed point coordinate to [0,1).
+R to_unit(std::uint32_t x) {
+#ifdef KX_MATH_FLOAT
+  return R(x >> 8) * (R(1) / R(16777216));
+#else
+  return R(x) * (R(1) / R(4294967296.0));
+#endif
+}
+
+//
+// Stratified sets
+//
+
+/// Return a random real in [0,1) for index i of pattern p (Kensler's
+/// randfloat()).
+R jitter(std::uint32_t i, std::uint32_t p) {
+  i ^= p;
+  i ^= i >> 17;
+  i ^= i >> 10;
+  i *= 0xb36534e5;
+  i ^= i >> 12;
+  i ^= i >> 21;
+  i *= 0x93fc4795;
+  i ^= 0xdf6e307f;
+  i ^= i >> 17;
+  i *= 1 | p >> 18;
+  return to_unit(i);
+}
+
+}  // namespace
+
+R kx::radical_inverse(unsigned base, std::uint64_t i) {
+  std::uint64_t scale;
+  max_digits(base, scale);
+  std::uint64_t reversed = 0;
+  for (std::uint64_t place = scale / base; i > 0 && place > 0;
+       place /= base, i /= base)
+    reversed += (i % base) * place;
+  return fraction(reversed, scale);
+}
+
+//
+// Sobol
+//
+
+Sobol::Sobol() : scramble_(false), index_(0) {
+  seed_[0] = seed_[1] = 0;
+  x_[0] = x_[1] = 0;
+}
+
+Sobol::Sobol(std::uint32_t seed) : scramble_(true), index_(0) {
+  seed_[0] = hash(seed);
+  seed_[1] = hash(seed_[0] ^ 0x9e3779b9);
+  x_[0] = x_[1] = 0;
+}
+
+vec2 Sobol::next() {
+  std::uint32_t x = x_[0];
+  std::uint32_t y = x_[1];
+  if (scramble_) {
+    x = owen_scramble(x, seed_[0]);
+    y = owen_scramble(y, seed_[1]);
+  }
+
+  // Gray code update: successive Gray codes differ in the bit that flips
+  // to 1 when incrementing the index.
+  ++index_;
+  if (index_ != 0) {
+    int k = trailing_zeros(index_);
+    x_[0] ^= kDirections.v[0][k];
+    x_[1] ^= kDirections.v[1][k];
+  } else {
+    x_[0] = x_[1] = 0;
+  }
+
+  return vec2(to_unit(x), to_unit(y));
+}
+
+void Sobol::seek(std::uint32_t i) {
+  index_ = i;
+  x_[0] = x_[1] = 0;
+  std::uint32_t gray = i ^ (i >> 1);
+  for (int k = 0; gray; ++k, gray >>= 1) {
+    if (gray & 1) {
+      x_[0] ^= kDirections.v[0][k];
+      x_[1] ^= kDirections.v[1][k];
+    }
+  }
+}
+
+//
+// Halton
+//
+
+void Halton::Counter::init(unsigned b) {
+  base = b;
+  num_digits = max_digits(base, scale);
+  std::uint64_t p = scale;
+  for (int k = 0; k < num_digits; ++k) {
+    p /= base;
+    place[k] = p;
+  }
+  seek(0);
+}
+
+void Halton::Counter::seek(std::uint64_t i) {
+  reversed = 0;
+  for (int k = 0; k < num_digits; ++k, i /= base) {
+    digits[k] = (unsigned char)(i % base);
+    reversed += digits[k] * place[k];
+  }
+}
+
+void Halton::Counter::increment() {
+  int k = 0;
+  for (; k < num_digits && digits[k] == base - 1; ++k) {
+    digits[k] = 0;
+    reversed -= (base - 1) * place[k];
+  }
+  if (k < num_digits) {
+    ++digits[k];
+    reversed += place[k];
+  }
+}
+
+Halton::Halton(unsigned base0, unsigned base1) : index_(0) {
+  counter_[0].init(base0);
+  counter_[1].init(base1);
+}
+
+vec2 Halton::next() {
+  vec2 p(fraction(counter_[0].reversed, counter_[0].scale),
+         fraction(counter_[1].reversed, counter_[1].scale));
+  ++index_;
+  counter_[0].increment();
+  counter_[1].increment();
+  return p;
+}
+
+void Halton::seek(std::uint64_t i) {
+  index_ = i;
+  counter_[0].seek(i);
+  counter_[1].seek(i);
+}
+
+//
+// Sample sets
+//
+
+std::vector<vec2> kx::sample_sobol(int num_samples) {
+  Sobol sobol;
+  std::vector<vec2> samples(num_samples);
+  for (vec2& sample : samples) sample = sobol.next();
+  return samples;
+}
+
+std::vector<vec2> kx::sample_sobol(int num_samples, std::uint32_t seed) {
+  Sobol sobol(seed);
+  std::vector<vec2> samples(num_samples);
+  for (vec2& sample : samples) sample = sobol.next();
+  return samples;
+}
+
+std::vector<vec2> kx::sample_halton(int num_samples) {
+  Halton halton;
+  std::vector<vec2> samples(num_samples);
+  for (vec2& sample : samples) sample = halton.next();
+  return samples;
+}
+
+//
+// Stratified sets
+//
+
+std::uint32_t kx::permute(std::uint32_t i, std::uint32_t n,
+                          std::uint32_t pattern) {
+  // Hash i within the smallest power of two above n and retry until the
+  // result falls in [0,n); each hash is a bijection of the power of two, so
+  // this walks the cycle of i and ends after 2 rounds on average.
+  const std::uint32_t p = pattern;
+  std::uint32_t w = n - 1;
+  w |= w >> 1;
+  w |= w >> 2;
+  w |= w >> 4;
+  w |= w >> 8;
+  w |= w >> 16;
+  do {
+    i ^= p;
+    i *= 0xe170893d;
+    i ^= p >> 16;
+    i ^= (i & w) >> 4;
+    i ^= p >> 8;
+    i *= 0x0929eb3f;
+    i ^= p >> 23;
+    i ^= (i & w) >> 1;
+    i *= 1 | p >> 27;
+    i *= 0x6935fa69;
+    i ^= (i & w) >> 11;
+    i *= 0x74dcb303;
+    i ^= (i & w) >> 2;
+    i *= 0x9e501cc3;
+    i ^= (i & w) >> 2;
+    i *= 0xc860a3df;
+    i &= w;
+    i ^= i >> 5;
+  } while (i >= n);
+  return (i + p) % n;
+}
+
+StratifiedSet::StratifiedSet(std::uint32_t nx, std::uint32_t ny,
+                             std::uint32_t pattern)
+    : nx_(nx), ny_(ny), pattern_(pattern) {}
+
+vec2 StratifiedSet::operator[](std::uint32_t i) const {
+  const std::uint32_t p = pattern_;
+  i = permute(i, size(), p * 0x51633e2d);
+  R jx = jitter(i, p * 0xa399d265);
+  R jy = jitter(i, p * 0x711ad6a5);
+  return vec2((i % nx_ + jx) / nx_, (i / nx_ + jy) / ny_);
+}
+
+NRooksSet::NRooksSet(std::uint32_t n, std::uint32_t pattern)
+    : n_(n), pattern_(pattern) {}
+
+vec2 NRooksSet::operator[](std::uint32_t i) const {
+  const std::uint32_t p = pattern_;
+  i = permute(i, n_, p * 0x51633e2d);
+  std::uint32_t row = permute(i, n_, p * 0x63d83595);
+  R jx = jitter(i, p * 0xa399d265);
+  R jy = jitter(i, p * 0x711ad6a5);
+  return vec2((i + jx) / n_, (row + jy) / n_);
+}
+
+CMJSet::CMJSet(std::uint32_t num_samples, std::uint32_t pattern)
+    : size_(num_samples), pattern_(pattern) {
+  m_ = 1;
+  while (m_ * m_ < num_samples) ++m_;
+  n_ = num_samples > 0 ? (num_samples + m_ - 1) / m_ : 1;
+}
+
+CMJSet::CMJSet(std::uint32_t m, std::uint32_t n, std::uint32_t pattern)
+    : m_(m), n_(n), size_(m * n), pattern_(pattern) {}
+
+vec2 CMJSet::operator[](std::uint32_t i) const {
+  const std::uint32_t p = pattern_;
+  // Permute over all the cells, so that when the set is smaller than the
+  // grid, each pattern drops a different random subset of them.
+  i = permute(i, m_ * n_, p * 0x51633e2d);
+  // The cell is (i % m, i / m); sx shuffles the columns of the fine grid
+  // within a column of cells and sy the rows within a row of cells.
+  std::uint32_t sx = permute(i % m_, m_, p * 0xa511e9b3);
+  std::uint32_t sy = permute(i / m_, n_, p * 0x63d83595);
+  R jx = jitter(i, p * 0xa399d265);
+  R jy = jitter(i, p * 0x711ad6a5);
+  return vec2((i % m_ + (sy + jx) / n_) / m_, (i / m_ + (sx + jy) / m_) / n_);
+}
+
+std::vector<vec2> kx::sample_stratified(int nx, int ny, std::uint32_t pattern) {
+  StratifiedSet set(nx, ny, pattern);
+  std::vector<vec2> samples(set.size());
+  for (std::uint32_t i = 0; i < set.size(); ++i) samples[i] = set[i];
+  return samples;
+}
+
+std::vector<vec2> kx::sample_n_rooks(int num_samples, std::uint32_t pattern) {
+  NRooksSet set(num_samples, pattern);
+  std::vector<vec2> samples(set.size());
+  for (std::uint32_t i = 0; i < set.size(); ++i) samples[i] = set[i];
+  return samples;
+}
+
+std::vector<vec2> kx::sample_cmj(int num_samples, std::uint32_t pattern) {
+  CMJSet set(num_samples, pattern);
+  std::vector<vec2> samples(set.size());
+  for (std::uint32_t i = 0; i < set.size(); ++i) samples[i] = set[i];
+  return samples;
+}
@@ -0,0 +1,76 @@
+#include <math/area.h>
+#include <math/interpolation.h>
+#include <math/mesh_sampler.h>
+#include <math/parallel.h>
+
+using namespace kx;
+
+namespace {
+
+/// Triangles per parallel chunk when computing the areas.
+const std::size_t kGrain = 1 << 14;
+
+/// Return a uniformly distributed real in [0,1).
+R uniform(RandGen& gen) { return std::uniform_real_distribution<R>()(gen); }
+
+/// Return a uniformly distributed real in [0,1).
+R uniform(Philox4x32& gen) { return gen.uniform(); }
+
+template <typename Gen>
+SurfacePoint draw(const MeshSampler& sampler, Gen& gen) {
+  R u = uniform(gen);
+  R s = uniform(gen);
+  R t = uniform(gen);
+  return sampler.sample(u, vec2(s, t));
+}
+
+}  // namespace
+
+MeshSampler::MeshSampler(const Triangle3* triangles, std::size_t n)
+    : triangles_(triangles, triangles + n) {
+  build();
+}
+
+MeshSampler::MeshSampler(const vec3* vertices, const std::uint32_t* indices,
+                         std::size_t num_triangles)
+    : triangles_(mesh_triangles(vertices, indices, num_triangles)) {
+  build();
+}
+
+void MeshSampler::build() {
+  std::vector<R> areas(triangles_.size());
+  parallel_for(areas.size(), kGrain, [&](std::size_t begin, std::size_t end) {
+    kx::area(triangles_.data() + begin, areas.data() + begin, end - begin);
+  });
+  table_ = AliasTable(areas);
+}
+
+SurfacePoint MeshSampler::sample(R u, const vec2& st) const {
+  SurfacePoint sp;
+  sp.triangle = table_.sample(u);
+
+  // Fold the square onto the triangle along the square root of the first
+  // coordinate; this keeps nearby samples nearby, unlike reflecting the
+  // upper half of the square.
+  R r = sqrt(st.x);
+  sp.st = vec2(r * (1 - st.y), r * st.y);
+  sp.p = interpolate(triangles_[sp.triangle], sp.st);
+  return sp;
+}
+
+void MeshSampler::sample(RandGen& gen, SurfacePoint* out, std::size_t n) const {
+  for (std::size_t i = 0; i < n; ++i) out[i] = draw(*this, gen);
+}
+
+void MeshSampler::sample(Philox4x32& gen, SurfacePoint* out,
+                         std::size_t n) const {
+  for (std::size_t i = 0; i < n; ++i) out[i] = draw(*this, gen);
+}
+
+void MeshSampler::sample(RandGen& gen, vec3* out, std::size_t n) const {
+  for (std::size_t i = 0; i < n; ++i) out[i] = draw(*this, gen).p;
+}
+
+void MeshSampler::sample(Philox4x32& gen, vec3* out, std::size_t n) const {
+  for (std::size_t i = 0; i < n; ++i) out[i] = draw(*this, gen).p;
+}
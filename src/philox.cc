@@ -0,0 +1,335 @@
+#include <math/philox.h>
+
+#include <algorithm>
+
+using namespace kx;
+
+namespace {
+
+const std::uint32_t kMul0 = 0xD2511F53;
+const std::uint32_t kMul1 = 0xCD9E8D57;
+const std::uint32_t kWeyl0 = 0x9E3779B9;
+const std::uint32_t kWeyl1 = 0xBB67AE85;
+const int kRounds = 10;
+
+void mulhilo(std::uint32_t a, std::uint32_t b, std::uint32_t& hi,
+             std::uint32_t& lo) {
+  std::uint64_t p = std::uint64_t(a) * b;
+  hi = std::uint32_t(p >> 32);
+  lo = std::uint32_t(p);
+}
+
+/// Encrypt one counter.
+void philox(const std::uint32_t key[2], std::uint32_t c[4]) {
+  std::uint32_t k0 = key[0];
+  std::uint32_t k1 = key[1];
+  for (int r = 0; r < kRounds; ++r) {
+    std::uint32_t hi0, lo0, hi1, lo1;
+    mulhilo(kMul0, c[0], hi0, lo0);
+    mulhilo(kMul1, c[2], hi1, lo1);
+    std::uint32_t c1 = c[1];
+    std::uint32_t c3 = c[3];
+    c[0] = hi1 ^ c1 ^ k0;
+    c[1] = lo1;
+    c[2] = hi0 ^ c3 ^ k1;
+    c[3] = lo0;
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+}
+
+void philox_block(const std::uint32_t key[2], std::uint64_t stream,
+                  std::uint64_t index, std::uint32_t* out) {
+  out[0] = std::uint32_t(index);
+  out[1] = std::uint32_t(index >> 32);
+  out[2] = std::uint32_t(stream);
+  out[3] = std::uint32_t(stream >> 32);
+  philox(key, out);
+}
+
+//
+// SIMD kernels. Each lane of a register holds the same word of a different
+// block, so W blocks are encrypted at once: 4 with SSE2 and 8 with AVX2.
+// The 32x32->64 bit multiplies (mul_epu32) only use the even lanes, so the
+// odd lanes are shifted down and multiplied separately.
+//
+
+#if defined(__AVX2__) && !defined(KX_MATH_NO_SIMD)
+
+using Iv = __m256i;
+const int kSimdBlocks = 8;
+
+inline Iv set1(std::uint32_t x) { return _mm256_set1_epi32(int(x)); }
+inline Iv add(Iv a, Iv b) { return _mm256_add_epi32(a, b); }
+inline Iv bxor(Iv a, Iv b) { return _mm256_xor_si256(a, b); }
+
+inline void mulhilo(Iv a, Iv b, Iv& hi, Iv& lo) {
+  Iv p02 = _mm256_mul_epu32(a, b);
+  Iv p13 = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  // [lo0 hi0 lo2 hi2] -> [lo0 lo2 hi0 hi2], per 128-bit lane.
+  p02 = _mm256_shuffle_epi32(p02, _MM_SHUFFLE(3, 1, 2, 0));
+  p13 = _mm256_shuffle_epi32(p13, _MM_SHUFFLE(3, 1, 2, 0));
+  lo = _mm256_unpacklo_epi32(p02, p13);
+  hi = _mm256_unpackhi_epi32(p02, p13);
+}
+
+inline void store_blocks(std::uint32_t* out, Iv x0, Iv x1, Iv x2, Iv x3) {
+  // Transpose per 128-bit lane; r_i then holds blocks i and i+4.
+  Iv t0 = _mm256_unpacklo_epi32(x0, x1);
+  Iv t1 = _mm256_unpacklo_epi32(x2, x3);
+  Iv t2 = _mm256_unpackhi_epi32(x0, x1);
+  Iv t3 = _mm256_unpackhi_epi32(x2, x3);
+  Iv r0 = _mm256_unpacklo_epi64(t0, t1);
+  Iv r1 = _mm256_unpackhi_epi64(t0, t1);
+  Iv r2 = _mm256_unpacklo_epi64(t2, t3);
+  Iv r3 = _mm256_unpackhi_epi64(t2, t3);
+  Iv* p = (Iv*)out;
+  _mm256_storeu_si256(p + 0, _mm256_permute2x128_si256(r0, r1, 0x20));
+  _mm256_storeu_si256(p + 1, _mm256_permute2x128_si256(r2, r3, 0x20));
+  _mm256_storeu_si256(p + 2, _mm256_permute2x128_si256(r0, r1, 0x31));
+  _mm256_storeu_si256(p + 3, _mm256_permute2x128_si256(r2, r3, 0x31));
+}
+
+inline Iv load_words(const std::uint32_t* p) {
+  return _mm256_loadu_si256((const Iv*)p);
+}
+
+#define KX_PHILOX_SIMD
+
+#elif (defined(KX_MATH_SSE2) || defined(KX_MATH_AVX))
+
+using Iv = __m128i;
+const int kSimdBlocks = 4;
+
+inline Iv set1(std::uint32_t x) { return _mm_set1_epi32(int(x)); }
+inline Iv add(Iv a, Iv b) { return _mm_add_epi32(a, b); }
+inline Iv bxor(Iv a, Iv b) { return _mm_xor_si128(a, b); }
+
+inline void mulhilo(Iv a, Iv b, Iv& hi, Iv& lo) {
+  Iv p02 = _mm_mul_epu32(a, b);
+  Iv p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+  // [lo0 hi0 lo2 hi2] -> [lo0 lo2 hi0 hi2]
+  p02 = _mm_shuffle_epi32(p02, _MM_SHUFFLE(3, 1, 2, 0));
+  p13 = _mm_shuffle_epi32(p13, _MM_SHUFFLE(3, 1, 2, 0));
+  lo = _mm_unpacklo_epi32(p02, p13);
+  hi = _mm_unpackhi_epi32(p02, p13);
+}
+
+inline void store_blocks(std::uint32_t* out, Iv x0, Iv x1, Iv x2, Iv x3) {
+  Iv t0 = _mm_unpacklo_epi32(x0, x1);
+  Iv t1 = _mm_unpacklo_epi32(x2, x3);
+  Iv t2 = _mm_unpackhi_epi32(x0, x1);
+  Iv t3 = _mm_unpackhi_epi32(x2, x3);
+  Iv* p = (Iv*)out;
+  _mm_storeu_si128(p + 0, _mm_unpacklo_epi64(t0, t1));
+  _mm_storeu_si128(p + 1, _mm_unpackhi_epi64(t0, t1));
+  _mm_storeu_si128(p + 2, _mm_unpacklo_epi64(t2, t3));
+  _mm_storeu_si128(p + 3, _mm_unpackhi_epi64(t2, t3));
+}
+
+inline Iv load_words(const std::uint32_t* p) {
+  return _mm_loadu_si128((const Iv*)p);
+}
+
+#define KX_PHILOX_SIMD
+
+#endif
+
+#ifdef KX_PHILOX_SIMD
+
+/// Encrypt kSimdBlocks consecutive counters.
+void philox_simd(const std::uint32_t key[2], std::uint64_t stream,
+                 std::uint64_t index, std::uint32_t* out) {
+  std::uint32_t lo[kSimdBlocks];
+  std::uint32_t hi[kSimdBlocks];
+  for (int i = 0; i < kSimdBlocks; ++i) {
+    lo[i] = std::uint32_t(index + i);
+    hi[i] = std::uint32_t((index + i) >> 32);
+  }
+  Iv c0 = load_words(lo);
+  Iv c1 = load_words(hi);
+  Iv c2 = set1(std::uint32_t(stream));
+  Iv c3 = set1(std::uint32_t(stream >> 32));
+  Iv k0 = set1(key[0]);
+  Iv k1 = set1(key[1]);
+  const Iv m0 = set1(kMul0);
+  const Iv m1 = set1(kMul1);
+  const Iv w0 = set1(kWeyl0);
+  const Iv w1 = set1(kWeyl1);
+  for (int r = 0; r < kRounds; ++r) {
+    Iv hi0, lo0, hi1, lo1;
+    mulhilo(c0, m0, hi0, lo0);
+    mulhilo(c2, m1, hi1, lo1);
+    c0 = bxor(bxor(hi1, c1), k0);
+    c1 = lo1;
+    c2 = bxor(bxor(hi0, c3), k1);
+    c3 = lo0;
+    k0 = add(k0, w0);
+    k1 = add(k1, w1);
+  }
+  store_blocks(out, c0, c1, c2, c3);
+}
+
+#endif  // KX_PHILOX_SIMD
+
+/// Encrypt n consecutive counters starting at 'index'.
+void philox_blocks(const std::uint32_t key[2], std::uint64_t stream,
+                   std::uint64_t index, std::size_t n, std::uint32_t* out) {
+  std::size_t i = 0;
+#ifdef KX_PHILOX_SIMD
+  for (; i + kSimdBlocks <= n; i += kSimdBlocks)
+    philox_simd(key, stream, index + i, out + 4 * i);
+#endif
+  for (; i < n; ++i) philox_block(key, stream, index + i, out + 4 * i);
+}
+
+/// Return the uniform real in [0,1) made of the words at w, as uniform() does.
+inline R to_uniform(const std::uint32_t* w) {
+#ifdef KX_MATH_FLOAT
+  return R(w[0] >> 8) * (R(1) / R(16777216));
+#else
+  std::uint64_t hi = w[0];
+  std::uint64_t lo = w[1];
+  return R(hi << 21 | lo >> 11) * (R(1) / R(9007199254740992.0));
+#endif
+}
+
+//
+// SIMD conversion of words to reals. Float builds convert the top 24 bits of
+// each word. Double builds take 32 bits from the first word of a pair and 21
+// from the second; each part is converted exactly by placing it in the
+// mantissa of 2^52 and subtracting 2^52, and their scaled sum is exact, so
+// the results equal those of to_uniform().
+//
+
+#if defined(__AVX2__) && !defined(KX_MATH_NO_SIMD)
+
+#ifdef KX_MATH_FLOAT
+const int kUniformsPerVector = 8;
+
+inline void to_uniform_simd(const std::uint32_t* w, R* out) {
+  __m256i x = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i*)w), 8);
+  _mm256_storeu_ps(out, _mm256_mul_ps(_mm256_cvtepi32_ps(x),
+                                      _mm256_set1_ps(1.0f / 16777216)));
+}
+#else
+const int kUniformsPerVector = 4;
+
+inline void to_uniform_simd(const std::uint32_t* w, R* out) {
+  const __m256i magic = _mm256_set1_epi64x(0x4330000000000000);
+  const __m256d two52 = _mm256_set1_pd(4503599627370496.0);
+  __m256i x = _mm256_loadu_si256((const __m256i*)w);
+  __m256i hi = _mm256_and_si256(x, _mm256_set1_epi64x(0xffffffff));
+  __m256i lo = _mm256_srli_epi64(x, 32 + 11);
+  __m256d h = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(hi, magic)),
+                            two52);
+  __m256d l = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(lo, magic)),
+                            two52);
+  const __m256d scale_h = _mm256_set1_pd(1.0 / 4294967296.0);
+  const __m256d scale_l = _mm256_set1_pd(1.0 / 9007199254740992.0);
+  _mm256_storeu_pd(out, _mm256_add_pd(_mm256_mul_pd(h, scale_h),
+                                      _mm256_mul_pd(l, scale_l)));
+}
+#endif
+
+#define KX_PHILOX_SIMD_UNIFORM
+
+#elif (defined(KX_MATH_SSE2) || defined(KX_MATH_AVX))
+
+#ifdef KX_MATH_FLOAT
+const int kUniformsPerVector = 4;
+
+inline void to_uniform_simd(const std::uint32_t* w, R* out) {
+  __m128i x = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)w), 8);
+  _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(x),
+                                _mm_set1_ps(1.0f / 16777216)));
+}
+#else
+const int kUniformsPerVector = 2;
+
+inline void to_uniform_simd(const std::uint32_t* w, R* out) {
+  const __m128i magic = _mm_set1_epi64x(0x4330000000000000);
+  const __m128d two52 = _mm_set1_pd(4503599627370496.0);
+  __m128i x = _mm_loadu_si128((const __m128i*)w);
+  __m128i hi = _mm_and_si128(x, _mm_set1_epi64x(0xffffffff));
+  __m128i lo = _mm_srli_epi64(x, 32 + 11);
+  __m128d h = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(hi, magic)), two52);
+  __m128d l = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(lo, magic)), two52);
+  const __m128d scale_h = _mm_set1_pd(1.0 / 4294967296.0);
+  const __m128d scale_l = _mm_set1_pd(1.0 / 9007199254740992.0);
+  _mm_storeu_pd(out,
+                _mm_add_pd(_mm_mul_pd(h, scale_h), _mm_mul_pd(l, scale_l)));
+}
+#endif
+
+#define KX_PHILOX_SIMD_UNIFORM
+
+#endif
+
+#ifdef KX_MATH_FLOAT
+const std::size_t kWordsPerReal = 1;
+#else
+const std::size_t kWordsPerReal = 2;
+#endif
+
+/// Convert n * kWordsPerReal words to n uniform reals in [0,1).
+void to_uniform(const std::uint32_t* words, R* out, std::size_t n) {
+  std::size_t i = 0;
+#ifdef KX_PHILOX_SIMD_UNIFORM
+  for (; i + kUniformsPerVector <= n; i += kUniformsPerVector)
+    to_uniform_simd(words + kWordsPerReal * i, out + i);
+#endif
+  for (; i < n; ++i) out[i] = to_uniform(words + kWordsPerReal * i);
+}
+
+}  // namespace
+
+Philox4x32::Philox4x32(std::uint64_t seed, std::uint64_t stream)
+    : stream_(stream), next_(0), buffer_begin_(0 - kBufferSize) {
+  key_[0] = std::uint32_t(seed);
+  key_[1] = std::uint32_t(seed >> 32);
+}
+
+void Philox4x32::block(std::uint64_t seed, std::uint64_t stream,
+                       std::uint64_t index, std::uint32_t out[4]) {
+  const std::uint32_t key[2] = {std::uint32_t(seed),
+                                std::uint32_t(seed >> 32)};
+  philox_block(key, stream, index, out);
+}
+
+void Philox4x32::refill() {
+  buffer_begin_ = next_ & ~std::uint64_t(3);
+  philox_blocks(key_, stream_, buffer_begin_ / 4, kBufferSize / 4, buffer_);
+}
+
+void Philox4x32::generate(std::uint32_t* out, std::size_t n) {
+  // Use up the buffer, then encrypt whole blocks straight into the output.
+  while (n > 0 && next_ % 4 != 0) {
+    *out++ = (*this)();
+    --n;
+  }
+  const std::size_t num_blocks = n / 4;
+  philox_blocks(key_, stream_, next_ / 4, num_blocks, out);
+  next_ += 4 * num_blocks;
+  out += 4 * num_blocks;
+  for (std::size_t i = 0; i < n % 4; ++i) *out++ = (*this)();
+}
+
+simd::Rv Philox4x32::uniform_pack() {
+  const std::uint64_t num_words = kWordsPerReal * simd::Rv::N;
+  if (next_ - buffer_begin_ > kBufferSize - num_words) refill();
+  R tmp[simd::Rv::N];
+  to_uniform(buffer_ + (next_ - buffer_begin_), tmp, simd::Rv::N);
+  next_ += num_words;
+  return simd::load(tmp);
+}
+
+void Philox4x32::generate_uniform(R* out, std::size_t n) {
+  const std::size_t chunk = 256;
+  std::uint32_t words[chunk * kWordsPerReal];
+  for (std::size_t i = 0; i < n; i += chunk) {
+    const std::size_t m = std::min(chunk, n - i);
+    generate(words, m * kWordsPerReal);
+    to_uniform(words, out + i, m);
+  }
+}
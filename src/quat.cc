@@ -1,49 +1,284 @@
 #include <math/quat.h>
+#include <math/simd.h>
 
 using namespace kx;
+using namespace simd;
 using namespace std;
 
-quat kx::operator*(quat q1, quat q2) {
-  R w, x, y, z;
+// Below this angle slerp degenerates into nlerp to avoid dividing by sin(0).
+static const R slerp_threshold = 1.0f - 1e-6f;
+
+template <typename T>
+quatT<T> kx::operator*(quatT<T> q1, quatT<T> q2) {
+  T w, x, y, z;
   w = q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z;
   x = q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y;
   y = q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x;
   z = q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w;
-  return quat(w, x, y, z);
+  return quatT<T>(w, x, y, z);
 }
 
-quat kx::qrot(R angle, R x, R y, R z) {
-  R a = angle * TO_RAD * 0.5f;
-  R sa = sin(a);
-  R w = cos(a);
-  R mag = sqrt(x * x + y * y + z * z);
-  mag = mag == 0.0f ? 1.0f : mag;
+template <typename T>
+quatT<T> kx::qrot(NoDeduce<T> angle, NoDeduce<T> x, NoDeduce<T> y,
+                  NoDeduce<T> z) {
+  T a = angle * TO_RAD * 0.5f;
+  T sa = sin(a);
+  T w = cos(a);
+  T mag = sqrt(x * x + y * y + z * z);
+  mag = mag == T(0) ? T(1) : mag;
   x = x * sa;
   y = y * sa;
   z = z * sa;
-  return quat(w, x / mag, y / mag, z / mag);
+  return quatT<T>(w, x / mag, y / mag, z / mag);
+}
+
+template <typename T>
+quatT<T> kx::inv(quatT<T> q) {
+  T magsq = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
+  magsq = magsq == T(0) ? T(1) : magsq;
+  return quatT<T>(q.w / magsq, -q.x / magsq, -q.y / magsq, -q.z / magsq);
+}
+
+template <typename T>
+quatT<T> kx::conj(quatT<T> q) { return quatT<T>(q.w, -q.x, -q.y, -q.z); }
+
+template <typename T>
+T kx::dot(const quatT<T>& a, const quatT<T>& b) {
+  return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <typename T>
+quatT<T> kx::normalise(quatT<T> q) {
+  T n = sqrt(dot(q, q));
+  n = n == T(0) ? T(1) : n;
+  return quatT<T>(q.w / n, q.x / n, q.y / n, q.z / n);
+}
+
+// v' = v + w*t + u x t, where u = (x,y,z) and t = 2 u x v.
+// This is equivalent to q * v * conj(q) but takes 2 cross products instead of
+// 2 quaternion products.
+template <typename T>
+vec3T<T> kx::rot(const quatT<T>& q, const vec3T<T>& v) {
+  vec3T<T> u(q.x, q.y, q.z);
+  vec3T<T> t = 2 * cross(u, v);
+  return v + q.w * t + cross(u, t);
+}
+
+template <typename T>
+void kx::rot(const quatT<T>& q, vec3T<T>& v) {
+  vec3T<T> u(q.x, q.y, q.z);
+  vec3T<T> t = 2 * cross(u, v);
+  v += q.w * t + cross(u, t);
+}
+
+template <typename T>
+quatT<T> kx::nlerp(const quatT<T>& a, const quatT<T>& b, NoDeduce<T> t) {
+  T s = dot(a, b) < 0 ? -t : t;
+  T r = 1 - t;
+  return normalise(quatT<T>(r * a.w + s * b.w, r * a.x + s * b.x,
+                            r * a.y + s * b.y, r * a.z + s * b.z));
+}
+
+template <typename T>
+quatT<T> kx::slerp(const quatT<T>& a, const quatT<T>& b, NoDeduce<T> t) {
+  T d = dot(a, b);
+  T sign = d < 0 ? -1 : 1;
+  d *= sign;
+  if (d > slerp_threshold) return nlerp(a, b, t);
+  T theta = acos(d);
+  T st = sin(theta);
+  T wa = sin((1 - t) * theta) / st;
+  T wb = sign * sin(t * theta) / st;
+  return normalise(quatT<T>(wa * a.w + wb * b.w, wa * a.x + wb * b.x,
+                            wa * a.y + wb * b.y, wa * a.z + wb * b.z));
+}
+
+#define KX_MATH_INSTANTIATE(T)                                            \
+  template quatT<T> kx::operator*(quatT<T>, quatT<T>);                    \
+  template quatT<T> kx::qrot<T>(T, T, T, T);                              \
+  template quatT<T> kx::inv(quatT<T>);                                    \
+  template quatT<T> kx::conj(quatT<T>);                                   \
+  template T kx::dot(const quatT<T>&, const quatT<T>&);                   \
+  template quatT<T> kx::normalise(quatT<T>);                              \
+  template vec3T<T> kx::rot(const quatT<T>&, const vec3T<T>&);            \
+  template void kx::rot(const quatT<T>&, vec3T<T>&);                      \
+  template quatT<T> kx::nlerp(const quatT<T>&, const quatT<T>&, T);       \
+  template quatT<T> kx::slerp(const quatT<T>&, const quatT<T>&, T);
+
+KX_MATH_INSTANTIATE(float)
+KX_MATH_INSTANTIATE(double)
+
+//
+// Batch functions
+//
+// Quaternions and vectors are stored as arrays of structures. The kernels
+// transpose Rv::N elements at a time into packs (one pack per component),
+// operate on the packs, and transpose the results back.
+//
+
+namespace {
+
+struct quatv {
+  Rv w, x, y, z;
+};
+
+struct vec3v {
+  Rv x, y, z;
+};
+
+quatv load_quats(const quat* q) {
+  const R* p = &q->w;
+  quatv r;
+  r.w = gather(p, 4);
+  r.x = gather(p + 1, 4);
+  r.y = gather(p + 2, 4);
+  r.z = gather(p + 3, 4);
+  return r;
+}
+
+void store_quats(quat* q, const quatv& v) {
+  R* p = &q->w;
+  scatter(p, 4, v.w);
+  scatter(p + 1, 4, v.x);
+  scatter(p + 2, 4, v.y);
+  scatter(p + 3, 4, v.z);
+}
+
+vec3v load_vecs(const vec3* v) {
+  const R* p = &v->x;
+  vec3v r;
+  r.x = gather(p, 3);
+  r.y = gather(p + 1, 3);
+  r.z = gather(p + 2, 3);
+  return r;
+}
+
+void store_vecs(vec3* v, const vec3v& a) {
+  R* p = &v->x;
+  scatter(p, 3, a.x);
+  scatter(p + 1, 3, a.y);
+  scatter(p + 2, 3, a.z);
+}
+
+quatv mul(const quatv& a, const quatv& b) {
+  quatv r;
+  r.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+  r.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+  r.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+  r.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+  return r;
+}
+
+vec3v rot(const quatv& q, const vec3v& v) {
+  // t = 2 u x v
+  Rv tx = Rv(2) * (q.y * v.z - q.z * v.y);
+  Rv ty = Rv(2) * (q.z * v.x - q.x * v.z);
+  Rv tz = Rv(2) * (q.x * v.y - q.y * v.x);
+  // v' = v + w*t + u x t
+  vec3v r;
+  r.x = v.x + q.w * tx + (q.y * tz - q.z * ty);
+  r.y = v.y + q.w * ty + (q.z * tx - q.x * tz);
+  r.z = v.z + q.w * tz + (q.x * ty - q.y * tx);
+  return r;
+}
+
+Rv dot(const quatv& a, const quatv& b) {
+  return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+quatv normalise(const quatv& q) {
+  Rv n = sqrt(dot(q, q));
+  Rv inv = Rv(1) / select(n > Rv(0), n, Rv(1));
+  quatv r;
+  r.w = q.w * inv;
+  r.x = q.x * inv;
+  r.y = q.y * inv;
+  r.z = q.z * inv;
+  return r;
 }
 
-quat kx::inv(quat q) {
-  R magsq = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
-  magsq = magsq == 0.0f ? 1.0f : magsq;
-  return quat(q.w / magsq, -q.x / magsq, -q.y / magsq, -q.z / magsq);
+quatv blend(const quatv& a, Rv wa, const quatv& b, Rv wb) {
+  quatv r;
+  r.w = wa * a.w + wb * b.w;
+  r.x = wa * a.x + wb * b.x;
+  r.y = wa * a.y + wb * b.y;
+  r.z = wa * a.z + wb * b.z;
+  return r;
 }
 
-quat kx::conj(quat q) { return quat(q.w, -q.x, -q.y, -q.z); }
+}  // namespace
 
-vec3 kx::rot(const quat& q, const vec3& v) {
-  quat p = conj(q);
-  quat qv(0, v.x, v.y, v.z);
-  qv = q * qv * p;
-  return vec3(qv.x, qv.y, qv.z);
+void kx::mul(const quat* q1, const quat* q2, quat* out, size_t n) {
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N)
+    store_quats(out + i, ::mul(load_quats(q1 + i), load_quats(q2 + i)));
+  for (; i < n; ++i) out[i] = q1[i] * q2[i];
 }
 
-void rot(const quat& q, vec3& v) {
-  quat p = conj(q);
-  quat qv(0, v.x, v.y, v.z);
-  qv = q * qv * p;
-  v.x = qv.x;
-  v.y = qv.y;
-  v.z = qv.z;
+void kx::rot(const quat* q, const vec3* v, vec3* out, size_t n) {
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N)
+    store_vecs(out + i, ::rot(load_quats(q + i), load_vecs(v + i)));
+  for (; i < n; ++i) out[i] = rot(q[i], v[i]);
+}
+
+void kx::rot(const quat& q, const vec3* v, vec3* out, size_t n) {
+  quatv qv;
+  qv.w = q.w;
+  qv.x = q.x;
+  qv.y = q.y;
+  qv.z = q.z;
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N)
+    store_vecs(out + i, ::rot(qv, load_vecs(v + i)));
+  for (; i < n; ++i) out[i] = rot(q, v[i]);
+}
+
+void kx::normalise(const quat* q, quat* out, size_t n) {
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N)
+    store_quats(out + i, ::normalise(load_quats(q + i)));
+  for (; i < n; ++i) out[i] = normalise(q[i]);
+}
+
+void kx::nlerp(const quat* a, const quat* b, R t, quat* out, size_t n) {
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N) {
+    quatv qa = load_quats(a + i);
+    quatv qb = load_quats(b + i);
+    Rv wb = select(::dot(qa, qb) < Rv(0), Rv(-t), Rv(t));
+    store_quats(out + i, ::normalise(blend(qa, Rv(1 - t), qb, wb)));
+  }
+  for (; i < n; ++i) out[i] = nlerp(a[i], b[i], t);
+}
+
+void kx::slerp(const quat* a, const quat* b, R t, quat* out, size_t n) {
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N) {
+    quatv qa = load_quats(a + i);
+    quatv qb = load_quats(b + i);
+
+    // Take the shortest arc.
+    Rv d = ::dot(qa, qb);
+    Mask flip = d < Rv(0);
+    Rv sign = select(flip, Rv(-1), Rv(1));
+    d = abs(d);
+
+    // theta = acos(d) = atan(sin(theta) / d), with d >= 0.
+    Rv st = sqrt(max(Rv(0), Rv(1) - d * d));
+    Rv theta = atan(st / d);
+
+    Rv sa, ca, sb, cb;
+    sin_cos(Rv(1 - t) * theta, sa, ca);
+    sin_cos(Rv(t) * theta, sb, cb);
+
+    // Fall back to nlerp weights where the quaternions are nearly parallel;
+    // the final normalisation makes both branches agree.
+    Mask parallel = d > Rv(slerp_threshold);
+    Rv ist = Rv(1) / select(parallel, Rv(1), st);
+    Rv wa = select(parallel, Rv(1 - t), sa * ist);
+    Rv wb = sign * select(parallel, Rv(t), sb * ist);
+    store_quats(out + i, ::normalise(blend(qa, wa, qb, wb)));
+  }
+  for (; i < n; ++i) out[i] = slerp(a[i], b[i], t);
 }
@@ -1,230 +1,884 @@
-#include <math/sampling.h>
-#include <algorithm>
-
-using namespace kx;
-
-using Rand = std::uniform_real_distribution<R>;
-
-//
-// Functions relying on the client for random number generation
-//
-
-vec3 kx::sample_hemisphere(R u, R v, R e) {
-  R cos_theta = ::pow(1.f - v, 1.0f / (e + 1.0f));
-  R sin_theta = sqrt(1.f - cos_theta * cos_theta);
-  R phi = 2.0f * PI * u;
-  R pu = sin_theta * cos(phi);
-  R pv = sin_theta * sin(phi);
-  R pw = cos_theta;
-  return vec3(pu, pv, pw);
-}
-
-vec3 kx::sample_hemisphere(const vec3& n, R u, R v, R e) {
-  vec3 w = sample_hemisphere(u, v, e);
-
-  // Compute TBN
-  vec3 t = normalise(cross(vec3(0.0034f, 1.f, 0.0071f), n));
-  vec3 b = normalise(cross(n, t));
-
-  // Map to object space
-  return w.x * t + w.y * b + w.z * n;
-}
-
-std::vector<vec3> kx::sample_hemisphere(const std::vector<vec2>& square_samples,
-                                        R e) {
-  std::vector<vec3> samples;
-  samples.reserve(square_samples.size());
-  for (const vec2& p : square_samples)
-    samples.push_back(sample_hemisphere(p.x, p.y, e));
-  return samples;
-}
-
-vec3 kx::sample_sphere(R u, R v) {
-  R theta = 2 * PI * u;
-  R phi = acos(2 * v - 1);
-  return vec3(cos(theta) * sin(phi), sin(theta) * sin(phi), cos(phi));
-}
-
-//
-// Functions using a random number generator
-//
-
-vec3 kx::sample_hemisphere(RandGen& gen, R e) {
-  Rand rand;
-  R u = rand(gen);
-  R v = rand(gen);
-  return sample_hemisphere(u, v, e);
-}
-
-vec3 kx::sample_sphere(RandGen& gen) {
-  Rand rand;
-  R u = rand(gen);
-  R v = rand(gen);
-  return sample_sphere(u, v);
-}
-
-vec2 kx::sample_disk(RandGen& gen) {
-  // Using rejection sampling
-  Rand rand(-1, 1);
-  vec2 p(rand(gen), rand(gen));
-  while (norm2(p) > 1)  // p not in unit circle
-    p = vec2(rand(gen), rand(gen));
-  return p;
-}
-
-vec2 kx::sample_circle(RandGen& gen) {
-  Rand rand(0, 2 * PI);
-  R angle = rand(gen);
-  return vec2(cos(angle), sin(angle));
-}
-
-vec2 kx::sample_semicircle(RandGen& gen) {
-  Rand rand(0, PI);
-  R angle = rand(gen);
-  return vec2(cos(angle), sin(angle));
-}
-
-vec2 kx::sample_square(RandGen& gen) {
-  Rand rand;
-  return vec2(rand(gen), rand(gen));
-}
-
-//
-// Functions using a random number generator, vector version
-//
-
-std::vector<vec3> kx::sample_hemisphere(RandGen& gen, int num_samples, R e) {
-  std::vector<vec2> square_samples = sample_square(gen, num_samples);
-  return sample_hemisphere(square_samples, e);
-}
-
-std::vector<vec3> kx::sample_sphere(RandGen& gen, int num_samples) {
-  std::vector<vec3> samples(num_samples);
-  for (vec3& sample : samples) sample = sample_sphere(gen);
-  return samples;
-}
-
-std::vector<vec2> kx::sample_disk(RandGen& gen, int num_samples) {
-  std::vector<vec2> samples(num_samples);
-  for (vec2& sample : samples) sample = sample_disk(gen);
-  return samples;
-}
-
-std::vector<vec2> kx::sample_circle(int num_samples) {
-  // Walk around the circle taking steps of a fixed size
-  std::vector<vec2> samples(num_samples);
-  R step = 2 * PI / (R)num_samples;
-  R a = 0.0f;
-  for (int i = 0; i < num_samples; ++i, a += step) {
-    samples[i].x = cos(a);
-    samples[i].y = sin(a);
-  }
-  return samples;
-}
-
-std::vector<vec2> kx::sample_circle(RandGen& gen, int num_samples) {
-  std::vector<vec2> samples = kx::sample_circle(num_samples);
-  // Compute a random permutation to break the angular
-  // correlation between the samples
-  std::shuffle(samples.begin(), samples.end(), gen);
-  return samples;
-}
-
-std::vector<vec2> kx::sample_semicircle(int num_samples) {
-  // Walk around the semicircle taking steps of a fixed size
-  std::vector<vec2> samples(num_samples);
-  R step = PI / (R)num_samples;
-  R a = 0.0f;
-  for (int i = 0; i < num_samples; ++i, a += step) {
-    samples[i].x = cos(a);
-    samples[i].y = sin(a);
-  }
-  return samples;
-}
-
-std::vector<vec2> kx::sample_semicircle(RandGen& gen, int num_samples) {
-  std::vector<vec2> samples = sample_semicircle(num_samples);
-  // Compute a random permutation to break the angular
-  // correlation between the samples
-  std::shuffle(samples.begin(), samples.end(), gen);
-  return samples;
-}
-
-std::vector<vec2> kx::sample_square(RandGen& gen, int num_samples) {
-  std::vector<vec2> samples(num_samples);
-  for (int i = 0; i < num_samples; ++i) samples[i] = sample_square(gen);
-  return samples;
-}
-
-const vec2 kx::poisson_disk_64[] = {
-    vec2(-0.9513874f, -0.2572531f),  vec2(-0.7081226f, -0.2925284f),
-    vec2(-0.8436754f, 0.07265603f),  vec2(-0.7361445f, -0.5300386f),
-    vec2(-0.4641706f, -0.4989096f),  vec2(-0.5525125f, -0.8051156f),
-    vec2(-0.5275754f, -0.3107731f),  vec2(-0.7102888f, -0.1115531f),
-    vec2(-0.3507241f, -0.2749718f),  vec2(-0.4596497f, -0.06777957f),
-    vec2(-0.2592802f, -0.09303893f), vec2(-0.3269215f, -0.7370512f),
-    vec2(-0.1967628f, -0.4045115f),  vec2(-0.1576745f, -0.602447f),
-    vec2(-0.05255998f, -0.8059599f), vec2(-0.2237102f, 0.1269211f),
-    vec2(0.05620234f, 0.04552704f),  vec2(-0.01783457f, -0.3361599f),
-    vec2(-0.01791586f, -0.1374219f), vec2(-0.6377217f, 0.2153173f),
-    vec2(-0.8682323f, 0.3331691f),   vec2(-0.4682668f, 0.406311f),
-    vec2(-0.7424924f, 0.5168823f),   vec2(-0.4310941f, 0.1879879f),
-    vec2(0.004823341f, -0.5199288f), vec2(-0.2881597f, 0.5322707f),
-    vec2(-0.216368f, 0.337567f),     vec2(-0.5569553f, 0.580784f),
-    vec2(-0.5138384f, 0.7612493f),   vec2(-0.2905928f, 0.7876921f),
-    vec2(0.1856931f, -0.3646466f),   vec2(0.2537658f, -0.5409983f),
-    vec2(0.2522059f, -0.1557814f),   vec2(0.01755813f, 0.3362328f),
-    vec2(-0.0237584f, 0.6334502f),   vec2(-0.3621303f, -0.9163787f),
-    vec2(0.5234978f, -0.5937616f),   vec2(0.2064808f, -0.7797251f),
-    vec2(0.4788987f, -0.7712453f),   vec2(0.4289224f, -0.2565495f),
-    vec2(-0.07641014f, -0.9843845f), vec2(0.03121825f, 0.8384359f),
-    vec2(-0.1270284f, 0.9283417f),   vec2(0.1492546f, 0.5786615f),
-    vec2(0.2709966f, 0.7643254f),    vec2(0.2346445f, 0.2978307f),
-    vec2(0.3416433f, 0.443035f),     vec2(0.4972726f, 0.7187986f),
-    vec2(0.3893609f, 0.9035504f),    vec2(0.3319246f, 0.02210116f),
-    vec2(0.6055115f, -0.3545263f),   vec2(0.6794177f, -0.1226148f),
-    vec2(0.3164409f, -0.9227439f),   vec2(0.736238f, -0.5313706f),
-    vec2(0.4185115f, 0.2695309f),    vec2(0.8704509f, -0.2409606f),
-    vec2(0.5223626f, -0.02931137f),  vec2(0.6194539f, 0.3270517f),
-    vec2(0.5733821f, 0.5036592f),    vec2(0.8006178f, 0.1628258f),
-    vec2(0.9085125f, -0.02186077f),  vec2(0.4075871f, -0.447026f),
-    vec2(0.9100426f, 0.340688f),     vec2(0.7329741f, 0.6350853f),
-};
-
-const vec2 kx::poisson_disk_32[] = {
-    vec2(-0.2619089f, 0.5490727f),   vec2(-0.4559077f, 0.05460965f),
-    vec2(-0.1364069f, 0.1247343f),   vec2(-0.6564749f, 0.7305732f),
-    vec2(0.1114105f, 0.3608207f),    vec2(-0.04955356f, 0.9398816f),
-    vec2(0.1126182f, 0.6443138f),    vec2(0.2464153f, 0.9610599f),
-    vec2(-0.3416013f, 0.9145091f),   vec2(0.4016598f, 0.7243099f),
-    vec2(-0.5291048f, 0.3880215f),   vec2(0.3829289f, 0.2302893f),
-    vec2(0.3434067f, -0.0842148f),   vec2(-0.002778768f, -0.3043965f),
-    vec2(-0.2444881f, -0.1361146f),  vec2(0.5450797f, 0.4763397f),
-    vec2(-0.852717f, 0.211937f),     vec2(-0.6877054f, -0.1175301f),
-    vec2(-0.4309482f, -0.4658188f),  vec2(-0.1307276f, -0.5704473f),
-    vec2(0.2784778f, -0.527334f),    vec2(-0.9684337f, -0.187813f),
-    vec2(-0.7409888f, -0.4390397f),  vec2(-0.3486479f, -0.8564078f),
-    vec2(-0.05303789f, -0.9629612f), vec2(0.866951f, 0.004832779f),
-    vec2(0.8629471f, 0.460784f),     vec2(0.3551344f, -0.8735148f),
-    vec2(0.777998f, -0.6073249f),    vec2(0.6032057f, -0.236872f),
-    vec2(0.6681956f, 0.2039291f),    vec2(0.9084376f, -0.3247856f)};
-
-const vec2 kx::poisson_disk_16[] = {
-    vec2(-0.9347774f, 0.1912229f),  vec2(-0.5724283f, 0.4960014f),
-    vec2(-0.7785025f, -0.445543f),  vec2(-0.4788606f, 0.08546659f),
-    vec2(-0.2924632f, -0.4198908f), vec2(-0.06280077f, 0.00913774f),
-    vec2(-0.1057879f, 0.462665f),   vec2(-0.3630854f, 0.8242339f),
-    vec2(-0.1966231f, -0.793602f),  vec2(0.4165555f, -0.6832738f),
-    vec2(0.1373055f, -0.3643214f),  vec2(0.3036709f, 0.3064243f),
-    vec2(0.6994917f, 0.05268941f),  vec2(0.8555422f, -0.4490918f),
-    vec2(0.1510768f, 0.8342344f),   vec2(0.7667124f, 0.6416653f)};
-
-const vec2 kx::poisson_disk_8[] = {
-    vec2(-0.181375f, 0.06780703f),  vec2(-0.7135639f, -0.2347054f),
-    vec2(0.7305085f, -0.01602699f), vec2(-0.5122069f, 0.5700766f),
-    vec2(0.05539552f, 0.6230494f),  vec2(-0.2359187f, -0.7726508f),
-    vec2(0.5458851f, -0.59454f),    vec2(0.6381865f, 0.6441305f)};
-
-const vec2 kx::poisson_disk_4[] = {
-    vec2(-0.8548036f, 0.1176181f), vec2(0.0141604f, -0.6810168f),
-    vec2(0.1922343f, 0.5596046f), vec2(0.804924f, -0.2298881f)};
+#include <math/sampling.h>
+#include <math/simd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+using namespace kx;
+
+using Rand = std::uniform_real_distribution<R>;
+
+namespace {
+
+//
+// Batch kernels. Each mapping takes packs of (u,v) and computes the
+// components of simd::Rv::N samples with the polynomial functions of simd.h.
+//
+
+using simd::Rv;
+
+/// Map n (u,v) pairs to out, reading u[i*stride] and v[i*stride].
+/// Map computes the D components of a pack of samples. The last, partial
+/// pack is padded with zeros, so every sample takes the same path.
+template <int D, typename V, typename Map>
+void map_batch(const R* u, const R* v, int stride, V* out, std::size_t n,
+               const Map& map) {
+  R tu[Rv::N], tv[Rv::N], tc[D][Rv::N];
+  Rv c[D];
+  std::size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N) {
+    map(simd::gather(u + i * stride, stride),
+        simd::gather(v + i * stride, stride), c);
+    for (int d = 0; d < D; ++d) simd::scatter(&out[i].x + d, D, c[d]);
+  }
+  if (i == n) return;
+  const int m = int(n - i);
+  for (int j = 0; j < Rv::N; ++j) {
+    tu[j] = j < m ? u[(i + j) * stride] : 0;
+    tv[j] = j < m ? v[(i + j) * stride] : 0;
+  }
+  map(simd::load(tu), simd::load(tv), c);
+  for (int d = 0; d < D; ++d) simd::store(tc[d], c[d]);
+  for (int j = 0; j < m; ++j)
+    for (int d = 0; d < D; ++d) (&out[i + j].x)[d] = tc[d][j];
+}
+
+/// See sample_hemisphere(u, v, e).
+/// The common skews avoid pow(), and compute sin(theta) without the
+/// cancellation in 1 - cos^2(theta) near the pole: for e = 1, cos^2(theta) =
+/// 1 - v, and for e = 0, 1 - cos^2(theta) = v (2 - v).
+struct HemisphereMap {
+  R e;
+
+  void operator()(Rv u, Rv v, Rv* c) const {
+    const Rv w = Rv(1) - v;
+    Rv cos_theta, sin_theta;
+    if (e == 1) {
+      cos_theta = simd::sqrt(w);
+      sin_theta = simd::sqrt(v);
+    } else if (e == 0) {
+      cos_theta = w;
+      sin_theta = simd::sqrt(v * (Rv(2) - v));
+    } else {
+      cos_theta = simd::pow(w, Rv(1 / (e + 1)));
+      sin_theta = simd::sqrt(simd::max(Rv(0), Rv(1) - cos_theta * cos_theta));
+    }
+    Rv s, co;
+    simd::sin_cos(Rv(2 * PI) * u, s, co);
+    c[0] = sin_theta * co;
+    c[1] = sin_theta * s;
+    c[2] = cos_theta;
+  }
+};
+
+/// See sample_sphere(u, v). The cosine and sine of acos(2v - 1) are computed
+/// directly: z = 2v - 1 and r = sqrt(1 - z^2) = 2 sqrt(v (1 - v)).
+struct SphereMap {
+  void operator()(Rv u, Rv v, Rv* c) const {
+    const Rv z = Rv(2) * v - Rv(1);
+    const Rv r = Rv(2) * simd::sqrt(v * (Rv(1) - v));
+    Rv s, co;
+    simd::sin_cos(Rv(2 * PI) * u, s, co);
+    c[0] = r * co;
+    c[1] = r * s;
+    c[2] = z;
+  }
+};
+
+/// See sample_disk(u, v).
+struct DiskMap {
+  void operator()(Rv u, Rv v, Rv* c) const {
+    const Rv r = simd::sqrt(u);
+    Rv s, co;
+    simd::sin_cos(Rv(2 * PI) * v, s, co);
+    c[0] = r * co;
+    c[1] = r * s;
+  }
+};
+
+/// Compute the signed radius and the angle of the concentric mapping of
+/// (u,v); see concentric() below. Both wedges are computed and the lanes
+/// pick theirs with a mask.
+void concentric(Rv u, Rv v, Rv& r, Rv& phi) {
+  const Rv a = Rv(2) * u - Rv(1);
+  const Rv b = Rv(2) * v - Rv(1);
+  const simd::Mask ab = simd::abs(a) > simd::abs(b);
+  r = select(ab, a, b);
+  // r = 0 only at the centre, where the angle does not matter.
+  const Rv q = select(ab, b, a) / select(simd::abs(r) > Rv(0), r, Rv(1));
+  phi = select(ab, Rv(PI / 4) * q, Rv(PI / 2) - Rv(PI / 4) * q);
+}
+
+/// See sample_concentric_disk(u, v).
+struct ConcentricDiskMap {
+  void operator()(Rv u, Rv v, Rv* c) const {
+    Rv r, phi, s, co;
+    concentric(u, v, r, phi);
+    simd::sin_cos(phi, s, co);
+    c[0] = r * co;
+    c[1] = r * s;
+  }
+};
+
+/// See sample_cosine_hemisphere(u, v).
+struct CosineHemisphereMap {
+  void operator()(Rv u, Rv v, Rv* c) const {
+    Rv r, phi, s, co;
+    concentric(u, v, r, phi);
+    simd::sin_cos(phi, s, co);
+    c[0] = r * co;
+    c[1] = r * s;
+    r = simd::abs(r);
+    c[2] = simd::sqrt((Rv(1) - r) * (Rv(1) + r));
+  }
+};
+
+/// Compute the signed radius and the angle of the concentric mapping of
+/// (u,v): map to [-1,1]^2, then each of the four wedges between the
+/// diagonals to a quarter of the disk, so that squares centred on the origin
+/// become circles.
+void concentric(R u, R v, R& r, R& phi) {
+  R a = 2 * u - 1;
+  R b = 2 * v - 1;
+  if (a == 0 && b == 0) {
+    r = phi = 0;
+  } else if (std::abs(a) > std::abs(b)) {
+    r = a;
+    phi = PI / 4 * (b / a);
+  } else {
+    r = b;
+    phi = PI / 2 - PI / 4 * (a / b);
+  }
+}
+
+}  // namespace
+
+//
+// Functions relying on the client for random number generation
+//
+
+vec3 kx::sample_hemisphere(R u, R v, R e) {
+  R cos_theta = ::pow(1.f - v, 1.0f / (e + 1.0f));
+  R sin_theta = sqrt(1.f - cos_theta * cos_theta);
+  R phi = 2.0f * PI * u;
+  R pu = sin_theta * cos(phi);
+  R pv = sin_theta * sin(phi);
+  R pw = cos_theta;
+  return vec3(pu, pv, pw);
+}
+
+vec3 kx::sample_hemisphere(const vec3& n, R u, R v, R e) {
+  vec3 w = sample_hemisphere(u, v, e);
+
+  // Compute TBN
+  vec3 t = normalise(cross(vec3(0.0034f, 1.f, 0.0071f), n));
+  vec3 b = normalise(cross(n, t));
+
+  // Map to object space
+  return w.x * t + w.y * b + w.z * n;
+}
+
+void kx::sample_hemisphere(const vec2* square_samples, vec3* out,
+                           std::size_t n, R e) {
+  const R* p = &square_samples->x;
+  map_batch<3>(p, p + 1, 2, out, n, HemisphereMap{e});
+}
+
+void kx::sample_hemisphere(const R* u, const R* v, vec3* out, std::size_t n,
+                           R e) {
+  map_batch<3>(u, v, 1, out, n, HemisphereMap{e});
+}
+
+std::vector<vec3> kx::sample_hemisphere(const std::vector<vec2>& square_samples,
+                                        R e) {
+  std::vector<vec3> samples(square_samples.size());
+  sample_hemisphere(square_samples.data(), samples.data(), samples.size(), e);
+  return samples;
+}
+
+vec3 kx::sample_sphere(R u, R v) {
+  R theta = 2 * PI * u;
+  R phi = acos(2 * v - 1);
+  return vec3(cos(theta) * sin(phi), sin(theta) * sin(phi), cos(phi));
+}
+
+void kx::sample_sphere(const vec2* square_samples, vec3* out, std::size_t n) {
+  const R* p = &square_samples->x;
+  map_batch<3>(p, p + 1, 2, out, n, SphereMap());
+}
+
+void kx::sample_sphere(const R* u, const R* v, vec3* out, std::size_t n) {
+  map_batch<3>(u, v, 1, out, n, SphereMap());
+}
+
+std::vector<vec3> kx::sample_sphere(const std::vector<vec2>& square_samples) {
+  std::vector<vec3> samples(square_samples.size());
+  sample_sphere(square_samples.data(), samples.data(), samples.size());
+  return samples;
+}
+
+vec2 kx::sample_disk(R u, R v) {
+  R r = sqrt(u);
+  R phi = 2 * PI * v;
+  return vec2(r * cos(phi), r * sin(phi));
+}
+
+void kx::sample_disk(const vec2* square_samples, vec2* out, std::size_t n) {
+  const R* p = &square_samples->x;
+  map_batch<2>(p, p + 1, 2, out, n, DiskMap());
+}
+
+void kx::sample_disk(const R* u, const R* v, vec2* out, std::size_t n) {
+  map_batch<2>(u, v, 1, out, n, DiskMap());
+}
+
+std::vector<vec2> kx::sample_disk(const std::vector<vec2>& square_samples) {
+  std::vector<vec2> samples(square_samples.size());
+  sample_disk(square_samples.data(), samples.data(), samples.size());
+  return samples;
+}
+
+vec2 kx::sample_concentric_disk(R u, R v) {
+  R r, phi;
+  concentric(u, v, r, phi);
+  return vec2(r * cos(phi), r * sin(phi));
+}
+
+void kx::sample_concentric_disk(const vec2* square_samples, vec2* out,
+                                std::size_t n) {
+  const R* p = &square_samples->x;
+  map_batch<2>(p, p + 1, 2, out, n, ConcentricDiskMap());
+}
+
+void kx::sample_concentric_disk(const R* u, const R* v, vec2* out,
+                                std::size_t n) {
+  map_batch<2>(u, v, 1, out, n, ConcentricDiskMap());
+}
+
+std::vector<vec2> kx::sample_concentric_disk(
+    const std::vector<vec2>& square_samples) {
+  std::vector<vec2> samples(square_samples.size());
+  sample_concentric_disk(square_samples.data(), samples.data(),
+                         samples.size());
+  return samples;
+}
+
+vec3 kx::sample_cosine_hemisphere(R u, R v) {
+  // Project the disk sample up to the hemisphere (Malley's method). 1 - r^2
+  // is factored to keep its precision near the rim.
+  R r, phi;
+  concentric(u, v, r, phi);
+  R z = sqrt((1 - std::abs(r)) * (1 + std::abs(r)));
+  return vec3(r * cos(phi), r * sin(phi), z);
+}
+
+void kx::sample_cosine_hemisphere(const vec2* square_samples, vec3* out,
+                                  std::size_t n) {
+  const R* p = &square_samples->x;
+  map_batch<3>(p, p + 1, 2, out, n, CosineHemisphereMap());
+}
+
+void kx::sample_cosine_hemisphere(const R* u, const R* v, vec3* out,
+                                  std::size_t n) {
+  map_batch<3>(u, v, 1, out, n, CosineHemisphereMap());
+}
+
+std::vector<vec3> kx::sample_cosine_hemisphere(
+    const std::vector<vec2>& square_samples) {
+  std::vector<vec3> samples(square_samples.size());
+  sample_cosine_hemisphere(square_samples.data(), samples.data(),
+                           samples.size());
+  return samples;
+}
+
+//
+// Functions using a random number generator
+//
+// The functions are written once as templates over the generator and
+// instantiated for each of the generator types declared in the header.
+//
+
+namespace {
+
+/// Return a uniformly distributed real in [a,b).
+R uniform(RandGen& gen, R a = 0, R b = 1) { return Rand(a, b)(gen); }
+
+/// Return a uniformly distributed real in [a,b).
+R uniform(Philox4x32& gen, R a = 0, R b = 1) {
+  return gen.uniform() * (b - a) + a;
+}
+
+template <typename Gen>
+vec3 hemisphere(Gen& gen, R e) {
+  R u = uniform(gen);
+  R v = uniform(gen);
+  return sample_hemisphere(u, v, e);
+}
+
+template <typename Gen>
+vec3 sphere(Gen& gen) {
+  R u = uniform(gen);
+  R v = uniform(gen);
+  return sample_sphere(u, v);
+}
+
+template <typename Gen>
+vec2 disk(Gen& gen) {
+  R u = uniform(gen);
+  R v = uniform(gen);
+  return sample_concentric_disk(u, v);
+}
+
+template <typename Gen>
+vec2 circle(Gen& gen) {
+  R angle = uniform(gen, 0, 2 * PI);
+  return vec2(cos(angle), sin(angle));
+}
+
+template <typename Gen>
+vec2 semicircle(Gen& gen) {
+  R angle = uniform(gen, 0, PI);
+  return vec2(cos(angle), sin(angle));
+}
+
+template <typename Gen>
+vec2 square(Gen& gen) {
+  return vec2(uniform(gen), uniform(gen));
+}
+
+//
+// Array versions. Each sample is generated and mapped in one step, straight
+// into the caller's array; the vector versions wrap them.
+//
+
+template <typename Gen>
+void hemisphere(Gen& gen, vec3* out, std::size_t n, R e) {
+  for (std::size_t i = 0; i < n; ++i) {
+    vec2 p = square(gen);
+    out[i] = sample_hemisphere(p.x, p.y, e);
+  }
+}
+
+template <typename Gen>
+void sphere(Gen& gen, vec3* out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) out[i] = sphere(gen);
+}
+
+template <typename Gen>
+void disk(Gen& gen, vec2* out, std::size_t n) {
+  // Draw all the square samples into the output, then map them in place
+  // with the batch version.
+  for (std::size_t i = 0; i < n; ++i) {
+    R u = uniform(gen);
+    R v = uniform(gen);
+    out[i] = vec2(u, v);
+  }
+  sample_concentric_disk(out, out, n);
+}
+
+template <typename Gen>
+void circle(Gen& gen, vec2* out, std::size_t n) {
+  sample_circle(out, n);
+  // Compute a random permutation to break the angular
+  // correlation between the samples
+  std::shuffle(out, out + n, gen);
+}
+
+template <typename Gen>
+void semicircle(Gen& gen, vec2* out, std::size_t n) {
+  sample_semicircle(out, n);
+  // Compute a random permutation to break the angular
+  // correlation between the samples
+  std::shuffle(out, out + n, gen);
+}
+
+template <typename Gen>
+void square(Gen& gen, vec2* out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) out[i] = square(gen);
+}
+
+template <typename Gen>
+std::vector<vec3> hemisphere(Gen& gen, int num_samples, R e) {
+  std::vector<vec3> samples(num_samples);
+  hemisphere(gen, samples.data(), samples.size(), e);
+  return samples;
+}
+
+template <typename Gen>
+std::vector<vec3> sphere(Gen& gen, int num_samples) {
+  std::vector<vec3> samples(num_samples);
+  sphere(gen, samples.data(), samples.size());
+  return samples;
+}
+
+template <typename Gen>
+std::vector<vec2> disk(Gen& gen, int num_samples) {
+  std::vector<vec2> samples(num_samples);
+  disk(gen, samples.data(), samples.size());
+  return samples;
+}
+
+template <typename Gen>
+std::vector<vec2> circle(Gen& gen, int num_samples) {
+  std::vector<vec2> samples(num_samples);
+  circle(gen, samples.data(), samples.size());
+  return samples;
+}
+
+template <typename Gen>
+std::vector<vec2> semicircle(Gen& gen, int num_samples) {
+  std::vector<vec2> samples(num_samples);
+  semicircle(gen, samples.data(), samples.size());
+  return samples;
+}
+
+template <typename Gen>
+std::vector<vec2> square(Gen& gen, int num_samples) {
+  std::vector<vec2> samples(num_samples);
+  square(gen, samples.data(), samples.size());
+  return samples;
+}
+
+//
+// Poisson disk sampling
+//
+// Bridson, "Fast Poisson Disk Sampling in Arbitrary Dimensions", SIGGRAPH
+// 2007 sketches. Starting from one random point, candidates are drawn in the
+// annulus [r,2r] around a random active point and accepted if no sample lies
+// within r; a point that yields no candidate in max_attempts tries becomes
+// inactive. A background grid finds the neighbouring samples in constant
+// time, so the algorithm runs in O(N).
+//
+
+enum class PlaneDomain { Square, Torus, Disk };
+
+/// Return a uniformly distributed point in the annulus between radii 1 and 2.
+/// Rejection sampling is cheaper here than sin and cos.
+template <typename Gen>
+vec2 annulus(Gen& gen) {
+  for (;;) {
+    vec2 p(uniform(gen, -2, 2), uniform(gen, -2, 2));
+    R d = norm2(p);
+    if (d >= 1 && d <= 4) return p;
+  }
+}
+
+template <typename Gen>
+std::vector<vec2> poisson_plane(Gen& gen, R r, int max_attempts,
+                                PlaneDomain domain) {
+  // The square and the torus are [0,1)^2, the disk lies in [-1,1]^2. Cells
+  // are at most r/sqrt(2) wide so that each holds at most one sample, which
+  // the grid stores directly; empty cells hold a point far away.
+  const R lo = domain == PlaneDomain::Disk ? -1 : 0;
+  const R extent = domain == PlaneDomain::Disk ? 2 : 1;
+  const int n = std::max(1, (int)std::ceil(extent * (R)M_SQRT2 / r));
+  const R inv_cell = n / extent;
+  const bool wrap = domain == PlaneDomain::Torus;
+  const vec2 empty(R(-1e6));
+
+  std::vector<vec2> grid(n * n, empty);
+  std::vector<vec2> samples;
+  std::vector<int> active;
+
+  auto inside = [&](vec2 p) {
+    if (domain == PlaneDomain::Disk) return norm2(p) <= 1;
+    return p.x >= 0 && p.x < 1 && p.y >= 0 && p.y < 1;
+  };
+  auto cell_of = [&](R x) {
+    return std::min(n - 1, std::max(0, (int)((x - lo) * inv_cell)));
+  };
+  auto far_enough = [&](vec2 p) {
+    const int cx = cell_of(p.x);
+    const int cy = cell_of(p.y);
+    // The corner cells of the neighbourhood come within sqrt(2) cell widths,
+    // which is at most r, so they are tested too.
+    for (int y = cy - 2; y <= cy + 2; ++y) {
+      for (int x = cx - 2; x <= cx + 2; ++x) {
+        int gx = x, gy = y;
+        vec2 shift;
+        if (wrap) {
+          // Compare with the copy of the sample across the edges, which a
+          // grid narrower than the neighbourhood crosses more than once.
+          gx = (x % n + n) % n;
+          gy = (y % n + n) % n;
+          shift = vec2(R((x - gx) / n), R((y - gy) / n));
+        } else if (gx < 0 || gx >= n || gy < 0 || gy >= n) {
+          continue;
+        }
+        if (dist2(p, grid[gy * n + gx] + shift) < r * r) return false;
+      }
+    }
+    return true;
+  };
+  auto add = [&](vec2 p) {
+    grid[cell_of(p.y) * n + cell_of(p.x)] = p;
+    active.push_back((int)samples.size());
+    samples.push_back(p);
+  };
+
+  vec2 first;
+  do
+    first = vec2(uniform(gen, lo, lo + extent), uniform(gen, lo, lo + extent));
+  while (!inside(first));
+  add(first);
+
+  while (!active.empty()) {
+    const int i = std::min((int)active.size() - 1,
+                           (int)(uniform(gen) * (R)active.size()));
+    const vec2 p = samples[active[i]];
+    bool found = false;
+    for (int attempt = 0; attempt < max_attempts && !found; ++attempt) {
+      vec2 q = p + r * annulus(gen);
+      if (wrap) {
+        q.x -= q.x < 0 ? -1 : (q.x >= 1 ? 1 : 0);
+        q.y -= q.y < 0 ? -1 : (q.y >= 1 ? 1 : 0);
+      }
+      if (inside(q) && far_enough(q)) {
+        add(q);
+        found = true;
+      }
+    }
+    if (!found) {
+      active[i] = active.back();
+      active.pop_back();
+    }
+  }
+  return samples;
+}
+
+/// A hash table from grid cells to the first sample in the cell, with open
+/// addressing. Only the cells crossing the sphere are ever used, so a dense
+/// grid would be mostly empty.
+class CellTable {
+  std::vector<std::uint64_t> keys_;
+  std::vector<int> heads_;
+  std::size_t size_;
+  int shift_;
+
+  static const std::uint64_t kEmpty = ~std::uint64_t(0);
+
+  std::size_t slot(std::uint64_t key) const {
+    std::size_t mask = keys_.size() - 1;
+    std::size_t i = (key * 0x9E3779B97F4A7C15ull) >> shift_;
+    while (keys_[i] != key && keys_[i] != kEmpty) i = (i + 1) & mask;
+    return i;
+  }
+
+  void resize(int log2_capacity) {
+    std::vector<std::uint64_t> keys(std::size_t(1) << log2_capacity,
+                                     std::uint64_t(kEmpty));
+    std::vector<int> heads(keys.size(), -1);
+    keys.swap(keys_);
+    heads.swap(heads_);
+    shift_ = 64 - log2_capacity;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] == kEmpty) continue;
+      std::size_t j = slot(keys[i]);
+      keys_[j] = keys[i];
+      heads_[j] = heads[i];
+    }
+  }
+
+ public:
+  CellTable() : size_(0) { resize(10); }
+
+  /// Return the first sample in the cell, or -1.
+  int find(std::uint64_t key) const { return heads_[slot(key)]; }
+
+  /// Make 'head' the first sample of the cell and return the previous one.
+  int push(std::uint64_t key, int head) {
+    if (2 * (size_ + 1) > keys_.size()) resize(65 - shift_);
+    std::size_t i = slot(key);
+    if (keys_[i] == kEmpty) {
+      keys_[i] = key;
+      ++size_;
+    }
+    int previous = heads_[i];
+    heads_[i] = head;
+    return previous;
+  }
+};
+
+template <typename Gen>
+std::vector<vec3> poisson_sphere(Gen& gen, R r, int max_attempts,
+                                 bool hemisphere) {
+  // r is the chord length; candidates lie at chord lengths [r,2r] from their
+  // parent, i.e. at angles [2 asin(r/2), 2 asin(r)] on the sphere.
+  const R cos_min = 1 - r * r / 2;
+  const R cos_max = r >= 1 ? -1 : 1 - 2 * r * r;
+
+  // Cells are r wide, so the neighbours of a point are in the 27 cells
+  // around it. The samples of a cell are chained through 'next'.
+  const std::uint64_t n = (std::uint64_t)std::ceil(2 / r) + 1;
+  const R inv_cell = 1 / r;
+  CellTable cells;
+  std::vector<int> next;
+  std::vector<vec3> samples;
+  std::vector<int> active;
+
+  auto key = [&](std::uint64_t x, std::uint64_t y, std::uint64_t z) {
+    return (x * n + y) * n + z;
+  };
+  // Most candidates are rejected, usually because of a sample in their own
+  // cell or a face neighbour, so the cells are visited nearest first.
+  static const int kOffsets[27][3] = {
+      {0, 0, 0},    {-1, 0, 0},  {1, 0, 0},   {0, -1, 0},  {0, 1, 0},
+      {0, 0, -1},   {0, 0, 1},   {-1, -1, 0}, {-1, 1, 0},  {1, -1, 0},
+      {1, 1, 0},    {-1, 0, -1}, {-1, 0, 1},  {1, 0, -1},  {1, 0, 1},
+      {0, -1, -1},  {0, -1, 1},  {0, 1, -1},  {0, 1, 1},   {-1, -1, -1},
+      {-1, -1, 1},  {-1, 1, -1}, {-1, 1, 1},  {1, -1, -1}, {1, -1, 1},
+      {1, 1, -1},   {1, 1, 1}};
+  auto far_enough = [&](vec3 p) {
+    const std::uint64_t cx = (std::uint64_t)((p.x + 1) * inv_cell) + 1;
+    const std::uint64_t cy = (std::uint64_t)((p.y + 1) * inv_cell) + 1;
+    const std::uint64_t cz = (std::uint64_t)((p.z + 1) * inv_cell) + 1;
+    for (const int* o : kOffsets) {
+      const std::uint64_t k = key(cx + o[0], cy + o[1], cz + o[2]);
+      for (int j = cells.find(k); j >= 0; j = next[j])
+        if (dist2(p, samples[j]) < r * r) return false;
+    }
+    return true;
+  };
+  auto add = [&](vec3 p) {
+    const int i = (int)samples.size();
+    next.push_back(cells.push(key((std::uint64_t)((p.x + 1) * inv_cell) + 1,
+                                  (std::uint64_t)((p.y + 1) * inv_cell) + 1,
+                                  (std::uint64_t)((p.z + 1) * inv_cell) + 1),
+                              i));
+    active.push_back(i);
+    samples.push_back(p);
+  };
+
+  vec3 first = sample_sphere(uniform(gen), uniform(gen));
+  if (hemisphere) first.z = std::abs(first.z);
+  add(first);
+
+  while (!active.empty()) {
+    const int i = std::min((int)active.size() - 1,
+                           (int)(uniform(gen) * (R)active.size()));
+    const vec3 p = samples[active[i]];
+    const vec3 t = normalise(cross(p, std::abs(p.x) < 0.9f ? right3() : up3()));
+    const vec3 b = cross(p, t);
+    bool found = false;
+    for (int attempt = 0; attempt < max_attempts && !found; ++attempt) {
+      // Uniform in the area of the spherical annulus.
+      const R ca = uniform(gen, cos_max, cos_min);
+      const R sa = sqrt(std::max(R(0), 1 - ca * ca));
+      const vec2 d = normalise(annulus(gen));
+      const vec3 q = normalise(ca * p + sa * (d.x * t + d.y * b));
+      if ((!hemisphere || q.z >= 0) && far_enough(q)) {
+        add(q);
+        found = true;
+      }
+    }
+    if (!found) {
+      active[i] = active.back();
+      active.pop_back();
+    }
+  }
+  return samples;
+}
+
+}  // namespace
+
+#define KX_SAMPLING_INSTANTIATE(Gen)                                          \
+  vec3 kx::sample_hemisphere(Gen& gen, R e) { return hemisphere(gen, e); }   \
+  vec3 kx::sample_sphere(Gen& gen) { return sphere(gen); }                   \
+  vec2 kx::sample_disk(Gen& gen) { return disk(gen); }                       \
+  vec2 kx::sample_circle(Gen& gen) { return circle(gen); }                   \
+  vec2 kx::sample_semicircle(Gen& gen) { return semicircle(gen); }           \
+  vec2 kx::sample_square(Gen& gen) { return square(gen); }                   \
+  std::vector<vec3> kx::sample_hemisphere(Gen& gen, int num_samples, R e) {  \
+    return hemisphere(gen, num_samples, e);                                  \
+  }                                                                          \
+  std::vector<vec3> kx::sample_sphere(Gen& gen, int num_samples) {           \
+    return sphere(gen, num_samples);                                         \
+  }                                                                          \
+  std::vector<vec2> kx::sample_disk(Gen& gen, int num_samples) {             \
+    return disk(gen, num_samples);                                           \
+  }                                                                          \
+  std::vector<vec2> kx::sample_circle(Gen& gen, int num_samples) {           \
+    return circle(gen, num_samples);                                         \
+  }                                                                          \
+  std::vector<vec2> kx::sample_semicircle(Gen& gen, int num_samples) {       \
+    return semicircle(gen, num_samples);                                     \
+  }                                                                          \
+  std::vector<vec2> kx::sample_square(Gen& gen, int num_samples) {           \
+    return square(gen, num_samples);                                         \
+  }                                                                          \
+  void kx::sample_hemisphere(Gen& gen, vec3* out, std::size_t n, R e) {     \
+    hemisphere(gen, out, n, e);                                              \
+  }                                                                          \
+  void kx::sample_sphere(Gen& gen, vec3* out, std::size_t n) {               \
+    sphere(gen, out, n);                                                     \
+  }                                                                          \
+  void kx::sample_disk(Gen& gen, vec2* out, std::size_t n) {                 \
+    disk(gen, out, n);                                                       \
+  }                                                                          \
+  void kx::sample_circle(Gen& gen, vec2* out, std::size_t n) {               \
+    circle(gen, out, n);                                                     \
+  }                                                                          \
+  void kx::sample_semicircle(Gen& gen, vec2* out, std::size_t n) {           \
+    semicircle(gen, out, n);                                                 \
+  }                                                                          \
+  void kx::sample_square(Gen& gen, vec2* out, std::size_t n) {               \
+    square(gen, out, n);                                                     \
+  }                                                                          \
+  std::vector<vec2> kx::sample_poisson_square(Gen& gen, R min_dist,          \
+                                              int max_attempts) {            \
+    return poisson_plane(gen, min_dist, max_attempts, PlaneDomain::Square);  \
+  }                                                                          \
+  std::vector<vec2> kx::sample_poisson_tile(Gen& gen, R min_dist,            \
+                                            int max_attempts) {              \
+    return poisson_plane(gen, min_dist, max_attempts, PlaneDomain::Torus);   \
+  }                                                                          \
+  std::vector<vec2> kx::sample_poisson_disk(Gen& gen, R min_dist,            \
+                                            int max_attempts) {              \
+    return poisson_plane(gen, min_dist, max_attempts, PlaneDomain::Disk);    \
+  }                                                                          \
+  std::vector<vec3> kx::sample_poisson_sphere(Gen& gen, R min_dist,          \
+                                              int max_attempts) {            \
+    return poisson_sphere(gen, min_dist, max_attempts, false);               \
+  }                                                                          \
+  std::vector<vec3> kx::sample_poisson_hemisphere(Gen& gen, R min_dist,      \
+                                                  int max_attempts) {        \
+    return poisson_sphere(gen, min_dist, max_attempts, true);                \
+  }
+
+KX_SAMPLING_INSTANTIATE(RandGen)
+KX_SAMPLING_INSTANTIATE(Philox4x32)
+
+//
+// Blue noise
+//
+
+const std::vector<vec2>& kx::blue_noise_tile(int num_samples) {
+  const int kMinLevel = 4;
+  const int kMaxLevel = 16;
+  static std::mutex mutex;
+  static std::unique_ptr<std::vector<vec2>> tiles[kMaxLevel - kMinLevel + 1];
+
+  int level = kMinLevel;
+  while (level < kMaxLevel && (1 << level) < num_samples) ++level;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<std::vector<vec2>>& tile = tiles[level - kMinLevel];
+  if (!tile) {
+    // Bridson's algorithm places about 0.615/r^2 samples in the unit square.
+    Philox4x32 gen(level);
+    R min_dist = sqrt(R(0.615) / R(1 << level));
+    tile.reset(new std::vector<vec2>(sample_poisson_tile(gen, min_dist)));
+  }
+  return *tile;
+}
+
+//
+// Deterministic sampling
+//
+
+void kx::sample_circle(vec2* out, std::size_t n) {
+  // Walk around the circle taking steps of a fixed size
+  R step = 2 * PI / (R)n;
+  R a = 0.0f;
+  for (std::size_t i = 0; i < n; ++i, a += step) {
+    out[i].x = cos(a);
+    out[i].y = sin(a);
+  }
+}
+
+std::vector<vec2> kx::sample_circle(int num_samples) {
+  std::vector<vec2> samples(num_samples);
+  sample_circle(samples.data(), samples.size());
+  return samples;
+}
+
+void kx::sample_semicircle(vec2* out, std::size_t n) {
+  // Walk around the semicircle taking steps of a fixed size
+  R step = PI / (R)n;
+  R a = 0.0f;
+  for (std::size_t i = 0; i < n; ++i, a += step) {
+    out[i].x = cos(a);
+    out[i].y = sin(a);
+  }
+}
+
+std::vector<vec2> kx::sample_semicircle(int num_samples) {
+  std::vector<vec2> samples(num_samples);
+  sample_semicircle(samples.data(), samples.size());
+  return samples;
+}
+
+constexpr vec2 kx::poisson_disk_64[] = {
+    vec2(-0.9513874f, -0.2572531f),  vec2(-0.7081226f, -0.2925284f),
+    vec2(-0.8436754f, 0.07265603f),  vec2(-0.7361445f, -0.5300386f),
+    vec2(-0.4641706f, -0.4989096f),  vec2(-0.5525125f, -0.8051156f),
+    vec2(-0.5275754f, -0.3107731f),  vec2(-0.7102888f, -0.1115531f),
+    vec2(-0.3507241f, -0.2749718f),  vec2(-0.4596497f, -0.06777957f),
+    vec2(-0.2592802f, -0.09303893f), vec2(-0.3269215f, -0.7370512f),
+    vec2(-0.1967628f, -0.4045115f),  vec2(-0.1576745f, -0.602447f),
+    vec2(-0.05255998f, -0.8059599f), vec2(-0.2237102f, 0.1269211f),
+    vec2(0.05620234f, 0.04552704f),  vec2(-0.01783457f, -0.3361599f),
+    vec2(-0.01791586f, -0.1374219f), vec2(-0.6377217f, 0.2153173f),
+    vec2(-0.8682323f, 0.3331691f),   vec2(-0.4682668f, 0.406311f),
+    vec2(-0.7424924f, 0.5168823f),   vec2(-0.4310941f, 0.1879879f),
+    vec2(0.004823341f, -0.5199288f), vec2(-0.2881597f, 0.5322707f),
+    vec2(-0.216368f, 0.337567f),     vec2(-0.5569553f, 0.580784f),
+    vec2(-0.5138384f, 0.7612493f),   vec2(-0.2905928f, 0.7876921f),
+    vec2(0.1856931f, -0.3646466f),   vec2(0.2537658f, -0.5409983f),
+    vec2(0.2522059f, -0.1557814f),   vec2(0.01755813f, 0.3362328f),
+    vec2(-0.0237584f, 0.6334502f),   vec2(-0.3621303f, -0.9163787f),
+    vec2(0.5234978f, -0.5937616f),   vec2(0.2064808f, -0.7797251f),
+    vec2(0.4788987f, -0.7712453f),   vec2(0.4289224f, -0.2565495f),
+    vec2(-0.07641014f, -0.9843845f), vec2(0.03121825f, 0.8384359f),
+    vec2(-0.1270284f, 0.9283417f),   vec2(0.1492546f, 0.5786615f),
+    vec2(0.2709966f, 0.7643254f),    vec2(0.2346445f, 0.2978307f),
+    vec2(0.3416433f, 0.443035f),     vec2(0.4972726f, 0.7187986f),
+    vec2(0.3893609f, 0.9035504f),    vec2(0.3319246f, 0.02210116f),
+    vec2(0.6055115f, -0.3545263f),   vec2(0.6794177f, -0.1226148f),
+    vec2(0.3164409f, -0.9227439f),   vec2(0.736238f, -0.5313706f),
+    vec2(0.4185115f, 0.2695309f),    vec2(0.8704509f, -0.2409606f),
+    vec2(0.5223626f, -0.02931137f),  vec2(0.6194539f, 0.3270517f),
+    vec2(0.5733821f, 0.5036592f),    vec2(0.8006178f, 0.1628258f),
+    vec2(0.9085125f, -0.02186077f),  vec2(0.4075871f, -0.447026f),
+    vec2(0.9100426f, 0.340688f),     vec2(0.7329741f, 0.6350853f),
+};
+
+constexpr vec2 kx::poisson_disk_32[] = {
+    vec2(-0.2619089f, 0.5490727f),   vec2(-0.4559077f, 0.05460965f),
+    vec2(-0.1364069f, 0.1247343f),   vec2(-0.6564749f, 0.7305732f),
+    vec2(0.1114105f, 0.3608207f),    vec2(-0.04955356f, 0.9398816f),
+    vec2(0.1126182f, 0.6443138f),    vec2(0.2464153f, 0.9610599f),
+    vec2(-0.3416013f, 0.9145091f),   vec2(0.4016598f, 0.7243099f),
+    vec2(-0.5291048f, 0.3880215f),   vec2(0.3829289f, 0.2302893f),
+    vec2(0.3434067f, -0.0842148f),   vec2(-0.002778768f, -0.3043965f),
+    vec2(-0.2444881f, -0.1361146f),  vec2(0.5450797f, 0.4763397f),
+    vec2(-0.852717f, 0.211937f),     vec2(-0.6877054f, -0.1175301f),
+    vec2(-0.4309482f, -0.4658188f),  vec2(-0.1307276f, -0.5704473f),
+    vec2(0.2784778f, -0.527334f),    vec2(-0.9684337f, -0.187813f),
+    vec2(-0.7409888f, -0.4390397f),  vec2(-0.3486479f, -0.8564078f),
+    vec2(-0.05303789f, -0.9629612f), vec2(0.866951f, 0.004832779f),
+    vec2(0.8629471f, 0.460784f),     vec2(0.3551344f, -0.8735148f),
+    vec2(0.777998f, -0.6073249f),    vec2(0.6032057f, -0.236872f),
+    vec2(0.6681956f, 0.2039291f),    vec2(0.9084376f, -0.3247856f)};
+
+constexpr vec2 kx::poisson_disk_16[] = {
+    vec2(-0.9347774f, 0.1912229f),  vec2(-0.5724283f, 0.4960014f),
+    vec2(-0.7785025f, -0.445543f),  vec2(-0.4788606f, 0.08546659f),
+    vec2(-0.2924632f, -0.4198908f), vec2(-0.06280077f, 0.00913774f),
+    vec2(-0.1057879f, 0.462665f),   vec2(-0.3630854f, 0.8242339f),
+    vec2(-0.1966231f, -0.793602f),  vec2(0.4165555f, -0.6832738f),
+    vec2(0.1373055f, -0.3643214f),  vec2(0.3036709f, 0.3064243f),
+    vec2(0.6994917f, 0.05268941f),  vec2(0.8555422f, -0.4490918f),
+    vec2(0.1510768f, 0.8342344f),   vec2(0.7667124f, 0.6416653f)};
+
+constexpr vec2 kx::poisson_disk_8[] = {
+    vec2(-0.181375f, 0.06780703f),  vec2(-0.7135639f, -0.2347054f),
+    vec2(0.7305085f, -0.01602699f), vec2(-0.5122069f, 0.5700766f),
+    vec2(0.05539552f, 0.6230494f),  vec2(-0.2359187f, -0.7726508f),
+    vec2(0.5458851f, -0.59454f),    vec2(0.6381865f, 0.6441305f)};
+
+constexpr vec2 kx::poisson_disk_4[] = {
+    vec2(-0.8548036f, 0.1176181f), vec2(0.0141604f, -0.6810168f),
+    vec2(0.1922343f, 0.5596046f), vec2(0.804924f, -0.2298881f)};
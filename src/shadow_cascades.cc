@@ -0,0 +1,136 @@
+#include <math/shadow_cascades.h>
+#include <math/vec4.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace kx;
+
+namespace {
+
+/// Return the distance of face i of n cascades over [near, far].
+R split(R near, R far, int n, R lambda, int i) {
+  if (i == 0) return near;
+  if (i == n) return far;
+  R s = R(i) / R(n);
+  R log_split = near * std::pow(far / near, s);
+  R uniform_split = near + (far - near) * s;
+  return lambda * log_split + (1 - lambda) * uniform_split;
+}
+
+/// Round the radius up to 5 significant bits, so that the rounding errors
+/// of turning the slice do not change it.
+R quantise(R radius) {
+  int e;
+  std::frexp(radius, &e);
+  R quantum = std::ldexp(R(1), e - 5);
+  return std::ceil(radius / quantum) * quantum;
+}
+
+}  // namespace
+
+void kx::cascade_splits(R near, R far, int n, R lambda, R* out) {
+  for (int i = 0; i <= n; ++i) out[i] = split(near, far, n, lambda, i);
+}
+
+void kx::split_cascades(const Camera& camera, const vec3& light_dir,
+                        const CascadeSettings& settings, ShadowCascade* out) {
+  // Unproject the corners of the view frustum.
+  const mat4& unproject = camera.inverseViewProjection();
+  vec3 near_corners[4];
+  vec3 far_corners[4];
+  for (int i = 0; i < 4; ++i) {
+    R x = (i & 1) ? 1 : -1;
+    R y = (i & 2) ? 1 : -1;
+    vec4 a = unproject * vec4(x, y, -1, 1);
+    vec4 b = unproject * vec4(x, y, 1, 1);
+    near_corners[i] = vec3(a.x, a.y, a.z) / a.w;
+    far_corners[i] = vec3(b.x, b.y, b.z) / b.w;
+  }
+
+  // The light's basis, shared by the cascades' cameras.
+  Spatial light;
+  light.setForward(light_dir);
+  const vec3 r = light.right();
+  const vec3 u = light.up();
+  const vec3 f = light.fwd();
+
+  // The depth of the casters closest to the light, along its direction.
+  const AABB3& casters = settings.casters;
+  const bool have_casters = !casters.empty();
+  R casters_depth = std::numeric_limits<R>::infinity();
+  if (have_casters) {
+    for (int i = 0; i < 8; ++i) {
+      vec3 p((i & 1) ? casters.pmax.x : casters.pmin.x,
+             (i & 2) ? casters.pmax.y : casters.pmin.y,
+             (i & 4) ? casters.pmax.z : casters.pmin.z);
+      casters_depth = std::min(casters_depth, dot(p, f));
+    }
+  }
+
+  const int n = settings.num_cascades;
+  const R near = camera.getNear();
+  const R far = camera.getFar();
+  for (int c = 0; c < n; ++c) {
+    ShadowCascade& cascade = out[c];
+    cascade.near = split(near, far, n, settings.lambda, c);
+    cascade.far = split(near, far, n, settings.lambda, c + 1);
+
+    // View depth is linear along the frustum's edges.
+    const R t0 = (cascade.near - near) / (far - near);
+    const R t1 = (cascade.far - near) / (far - near);
+    vec3 center(0);
+    for (int i = 0; i < 4; ++i) {
+      vec3 edge = far_corners[i] - near_corners[i];
+      cascade.corners[i] = near_corners[i] + t0 * edge;
+      cascade.corners[i + 4] = near_corners[i] + t1 * edge;
+      center += cascade.corners[i] + cascade.corners[i + 4];
+    }
+    center = center / R(8);
+
+    // Place the light camera at the center, or in stabilised mode at the
+    // center snapped to the texel grid of the light's basis.
+    R radius = 0;
+    vec3 pos = center;
+    if (settings.stabilise) {
+      for (const vec3& p : cascade.corners)
+        radius = std::max(radius, norm(p - center));
+      // Snapping moves the camera by up to half a texel, so widen the
+      // sphere by that much: half a texel is radius / resolution.
+      const R res = R(settings.resolution);
+      radius = quantise(radius * res / (res - 1));
+      const R texel = 2 * radius / res;
+      R x = std::round(dot(center, r) / texel) * texel;
+      R y = std::round(dot(center, u) / texel) * texel;
+      pos = x * r + y * u + dot(center, f) * f;
+    }
+
+    AABB3& bounds = cascade.bounds;
+    bounds = AABB3();
+    for (const vec3& p : cascade.corners) {
+      vec3 q = p - pos;
+      bounds.add(vec3(dot(q, r), dot(q, u), -dot(q, f)));
+    }
+
+    OrthoCamera& cam = cascade.camera;
+    cam.setForward(light_dir);
+    cam.setPosition(pos);
+    if (settings.stabilise) {
+      cam.left = -radius;
+      cam.right = radius;
+      cam.bottom = -radius;
+      cam.top = radius;
+    } else {
+      cam.left = bounds.pmin.x;
+      cam.right = bounds.pmax.x;
+      cam.bottom = bounds.pmin.y;
+      cam.top = bounds.pmax.y;
+    }
+    cam.near = -bounds.pmax.z;
+    cam.far = -bounds.pmin.z;
+    if (have_casters)
+      cam.near = std::min(cam.near, casters_depth - dot(pos, f));
+    cascade.view_projection = cam.viewProjection();
+  }
+}
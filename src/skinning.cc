@@ -0,0 +1,236 @@
+#include <math/parallel.h>
+#include <math/simd.h>
+#include <math/skinning.h>
+
+using namespace kx;
+using namespace simd;
+
+namespace {
+
+// Number of vertices handed to a thread at a time.
+const std::size_t chunk_size = 1024;
+
+const int K = SkinWeights::max_influences;
+
+struct vec3v {
+  Rv x, y, z;
+};
+
+vec3v load_vecs(const vec3* v) {
+  const R* p = &v->x;
+  vec3v r;
+  r.x = gather(p, 3);
+  r.y = gather(p + 1, 3);
+  r.z = gather(p + 2, 3);
+  return r;
+}
+
+void store_vecs(vec3* v, const vec3v& a) {
+  R* p = &v->x;
+  scatter(p, 3, a.x);
+  scatter(p + 1, 3, a.y);
+  scatter(p + 2, 3, a.z);
+}
+
+vec3v normalise(const vec3v& v) {
+  Rv n = sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+  Rv inv = Rv(1) / select(n > Rv(0), n, Rv(1));
+  vec3v r;
+  r.x = v.x * inv;
+  r.y = v.y * inv;
+  r.z = v.z * inv;
+  return r;
+}
+
+//
+// Linear blend skinning
+//
+
+// Blend the influences of Rv::N consecutive vertices, one vertex per lane.
+// m[col*4 + row] holds entry (row, col) of the blended matrices; the bottom
+// row is never read.
+void blend_matrices(const mat4* palette, const SkinWeights* w, Rv m[16]) {
+  for (int e = 0; e < 16; ++e) m[e] = Rv(0);
+  for (int k = 0; k < K; ++k) {
+    R buf[16][Rv::N];
+    R weight[Rv::N];
+    for (int lane = 0; lane < Rv::N; ++lane) {
+      const R* M = palette[w[lane].joints[k]];
+      for (int e = 0; e < 16; ++e) buf[e][lane] = M[e];
+      weight[lane] = w[lane].weights[k];
+    }
+    Rv wk = load(weight);
+    for (int col = 0; col < 4; ++col)
+      for (int row = 0; row < 3; ++row) {
+        int e = col * 4 + row;
+        m[e] += wk * load(buf[e]);
+      }
+  }
+}
+
+vec3v transform(const Rv m[16], const vec3v& p, bool point) {
+  vec3v r;
+  r.x = m[0] * p.x + m[4] * p.y + m[8] * p.z;
+  r.y = m[1] * p.x + m[5] * p.y + m[9] * p.z;
+  r.z = m[2] * p.x + m[6] * p.y + m[10] * p.z;
+  if (point) {
+    r.x += m[12];
+    r.y += m[13];
+    r.z += m[14];
+  }
+  return r;
+}
+
+mat4 blend_matrix(const mat4* palette, const SkinWeights& w) {
+  R m[16] = {0};
+  for (int k = 0; k < K; ++k) {
+    const R* M = palette[w.joints[k]];
+    for (int e = 0; e < 16; ++e) m[e] += w.weights[k] * M[e];
+  }
+  return mat4(m[0], m[4], m[8], m[12], m[1], m[5], m[9], m[13], m[2], m[6],
+              m[10], m[14], m[3], m[7], m[11], m[15]);
+}
+
+void skin_linear_range(const mat4* palette, const SkinWeights* weights,
+                       const vec3* positions, const vec3* normals,
+                       std::size_t begin, std::size_t end,
+                       vec3* out_positions, vec3* out_normals) {
+  std::size_t i = begin;
+  for (; i + Rv::N <= end; i += Rv::N) {
+    Rv m[16];
+    blend_matrices(palette, weights + i, m);
+    store_vecs(out_positions + i, transform(m, load_vecs(positions + i), true));
+    if (normals)
+      store_vecs(out_normals + i,
+                 normalise(transform(m, load_vecs(normals + i), false)));
+  }
+  for (; i < end; ++i) {
+    mat4 m = blend_matrix(palette, weights[i]);
+    out_positions[i] = transform(m, positions[i], 1);
+    if (normals) out_normals[i] = normalise(transform(m, normals[i], 0));
+  }
+}
+
+//
+// Dual quaternion skinning
+//
+
+struct dualquatv {
+  Rv rw, rx, ry, rz;  // real part
+  Rv dw, dx, dy, dz;  // dual part
+};
+
+// Blend the influences of Rv::N consecutive vertices, one vertex per lane.
+// Dual quaternions whose real part lies in the opposite hemisphere of the
+// first influence's are negated so that the blend takes the shortest path.
+dualquatv blend_dualquats(const dualquat* palette, const SkinWeights* w) {
+  R buf[K][8][Rv::N];
+  R weight[K][Rv::N];
+  for (int lane = 0; lane < Rv::N; ++lane) {
+    const quat& pivot = palette[w[lane].joints[0]].real;
+    for (int k = 0; k < K; ++k) {
+      const dualquat& dq = palette[w[lane].joints[k]];
+      const R* p = &dq.real.w;
+      for (int e = 0; e < 4; ++e) buf[k][e][lane] = p[e];
+      p = &dq.dual.w;
+      for (int e = 0; e < 4; ++e) buf[k][4 + e][lane] = p[e];
+      R wk = w[lane].weights[k];
+      weight[k][lane] = dot(pivot, dq.real) < 0 ? -wk : wk;
+    }
+  }
+
+  Rv b[8];
+  for (int e = 0; e < 8; ++e) b[e] = Rv(0);
+  for (int k = 0; k < K; ++k) {
+    Rv wk = load(weight[k]);
+    for (int e = 0; e < 8; ++e) b[e] += wk * load(buf[k][e]);
+  }
+
+  Rv n = sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+  Rv inv = Rv(1) / select(n > Rv(0), n, Rv(1));
+  dualquatv r;
+  r.rw = b[0] * inv;
+  r.rx = b[1] * inv;
+  r.ry = b[2] * inv;
+  r.rz = b[3] * inv;
+  r.dw = b[4] * inv;
+  r.dx = b[5] * inv;
+  r.dy = b[6] * inv;
+  r.dz = b[7] * inv;
+  return r;
+}
+
+// Rotate the vector by the real part: v' = v + w*t + u x t, t = 2 u x v.
+vec3v rotate(const dualquatv& q, const vec3v& v) {
+  Rv tx = Rv(2) * (q.ry * v.z - q.rz * v.y);
+  Rv ty = Rv(2) * (q.rz * v.x - q.rx * v.z);
+  Rv tz = Rv(2) * (q.rx * v.y - q.ry * v.x);
+  vec3v r;
+  r.x = v.x + q.rw * tx + (q.ry * tz - q.rz * ty);
+  r.y = v.y + q.rw * ty + (q.rz * tx - q.rx * tz);
+  r.z = v.z + q.rw * tz + (q.rx * ty - q.ry * tx);
+  return r;
+}
+
+// Rotate the point and add the translation 2 * dual * conj(real).
+vec3v transform(const dualquatv& q, const vec3v& p) {
+  vec3v r = rotate(q, p);
+  r.x += Rv(2) * (q.rw * q.dx - q.dw * q.rx + (q.ry * q.dz - q.rz * q.dy));
+  r.y += Rv(2) * (q.rw * q.dy - q.dw * q.ry + (q.rz * q.dx - q.rx * q.dz));
+  r.z += Rv(2) * (q.rw * q.dz - q.dw * q.rz + (q.rx * q.dy - q.ry * q.dx));
+  return r;
+}
+
+dualquat blend_dualquat(const dualquat* palette, const SkinWeights& w) {
+  const quat& pivot = palette[w.joints[0]].real;
+  quat r(0, 0, 0, 0);
+  quat d(0, 0, 0, 0);
+  for (int k = 0; k < K; ++k) {
+    const dualquat& dq = palette[w.joints[k]];
+    R wk = dot(pivot, dq.real) < 0 ? -w.weights[k] : w.weights[k];
+    r = quat(r.w + wk * dq.real.w, r.x + wk * dq.real.x, r.y + wk * dq.real.y,
+             r.z + wk * dq.real.z);
+    d = quat(d.w + wk * dq.dual.w, d.x + wk * dq.dual.x, d.y + wk * dq.dual.y,
+             d.z + wk * dq.dual.z);
+  }
+  return normalise(dualquat(r, d));
+}
+
+void skin_dual_quat_range(const dualquat* palette, const SkinWeights* weights,
+                          const vec3* positions, const vec3* normals,
+                          std::size_t begin, std::size_t end,
+                          vec3* out_positions, vec3* out_normals) {
+  std::size_t i = begin;
+  for (; i + Rv::N <= end; i += Rv::N) {
+    dualquatv dq = blend_dualquats(palette, weights + i);
+    store_vecs(out_positions + i, transform(dq, load_vecs(positions + i)));
+    if (normals)
+      store_vecs(out_normals + i, rotate(dq, load_vecs(normals + i)));
+  }
+  for (; i < end; ++i) {
+    dualquat dq = blend_dualquat(palette, weights[i]);
+    out_positions[i] = transform(dq, positions[i]);
+    if (normals) out_normals[i] = rot(dq.real, normals[i]);
+  }
+}
+
+}  // namespace
+
+void kx::skin_linear(const mat4* palette, const SkinWeights* weights,
+                     const vec3* positions, const vec3* normals, std::size_t n,
+                     vec3* out_positions, vec3* out_normals) {
+  parallel_for(n, chunk_size, [=](std::size_t begin, std::size_t end) {
+    skin_linear_range(palette, weights, positions, normals, begin, end,
+                      out_positions, out_normals);
+  });
+}
+
+void kx::skin_dual_quat(const dualquat* palette, const SkinWeights* weights,
+                        const vec3* positions, const vec3* normals,
+                        std::size_t n, vec3* out_positions,
+                        vec3* out_normals) {
+  parallel_for(n, chunk_size, [=](std::size_t begin, std::size_t end) {
+    skin_dual_quat_range(palette, weights, positions, normals, begin, end,
+                         out_positions, out_normals);
+  });
+}
@@ -1,21 +1,43 @@
 #include <math/spatial.h>
 
+#include <atomic>
+
 using namespace kx;
 using namespace std;
 
-KX_MATH_API Spatial::Spatial() : r(right3()), u(up3()), f(forward3()) {}
+namespace {
+
+/// The next version handed out to a spatial; versions start at 1, so that 0
+/// can mark an empty cache.
+std::atomic<std::uint64_t> next_version(1);
+
+}  // namespace
+
+void Spatial::touch() { version_ = next_version++; }
 
-KX_MATH_API Spatial::Spatial(const vec3& pos, const vec3& target) {
+KX_MATH_API Spatial::Spatial()
+    : r(right3()),
+      u(up3()),
+      f(forward3()),
+      version_(next_version++),
+      cached_version_(0) {}
+
+KX_MATH_API Spatial::Spatial(const vec3& pos, const vec3& target)
+    : version_(next_version++), cached_version_(0) {
   setPosition(pos);
   lookAt(target);
 }
 
-KX_MATH_API void Spatial::move(const vec3& direction) { p += direction; }
+KX_MATH_API void Spatial::move(const vec3& direction) {
+  p += direction;
+  touch();
+}
 
 KX_MATH_API void Spatial::move(R dx, R dy, R dz) {
   p.x += dx;
   p.y += dy;
   p.z += dz;
+  touch();
 }
 
 KX_MATH_API void Spatial::moveForwards(R speed) { move(fwd() * speed); }
@@ -38,6 +60,7 @@ KX_MATH_API void Spatial::rotate(R angle, R x, R y, R z) {
   r = normalise(transf.v0());
   u = normalise(transf.v1());
   f = normalise(-transf.v2());
+  touch();
 }
 
 KX_MATH_API void Spatial::yaw(const R angle) {
@@ -48,6 +71,7 @@ KX_MATH_API void Spatial::yaw(const R angle) {
   f.normalise();
   r = cross(f, u);
   r.normalise();
+  touch();
 }
 
 KX_MATH_API void Spatial::pitch(const R angle) {
@@ -58,6 +82,7 @@ KX_MATH_API void Spatial::pitch(const R angle) {
   f.normalise();
   u = cross(r, f);
   u.normalise();
+  touch();
 }
 
 KX_MATH_API void Spatial::roll(const R angle) {
@@ -67,21 +92,35 @@ KX_MATH_API void Spatial::roll(const R angle) {
   u = u * ca - r * sa;
   u.normalise();
   r = cross(f, u);
+  touch();
 }
 
-KX_MATH_API void Spatial::setx(R x) { p.x = x; }
+KX_MATH_API void Spatial::setx(R x) {
+  p.x = x;
+  touch();
+}
 
-KX_MATH_API void Spatial::sety(R y) { p.y = y; }
+KX_MATH_API void Spatial::sety(R y) {
+  p.y = y;
+  touch();
+}
 
-KX_MATH_API void Spatial::setz(R z) { p.z = z; }
+KX_MATH_API void Spatial::setz(R z) {
+  p.z = z;
+  touch();
+}
 
 KX_MATH_API void Spatial::setPosition(R x, R y, R z) {
   p.x = x;
   p.y = y;
   p.z = z;
+  touch();
 }
 
-KX_MATH_API void Spatial::setPosition(const vec3& v) { p = v; }
+KX_MATH_API void Spatial::setPosition(const vec3& v) {
+  p = v;
+  touch();
+}
 
 KX_MATH_API void Spatial::setForward(R x, R y, R z) {
   setForward(vec3(x, y, z));
@@ -98,6 +137,7 @@ KX_MATH_API void Spatial::setForward(const vec3& forward) {
   u = cross(r, f);
   r.normalise();
   u.normalise();
+  touch();
 }
 
 KX_MATH_API void Spatial::setTransform(const mat4& transform) {
@@ -105,6 +145,7 @@ KX_MATH_API void Spatial::setTransform(const mat4& transform) {
   u = transform.v1();
   f = -transform.v2();
   p = transform.v3();
+  touch();
 }
 
 KX_MATH_API void Spatial::lookAt(R x, R y, R z) {
@@ -146,11 +187,17 @@ KX_MATH_API const vec3& Spatial::right() const { return r; }
 
 KX_MATH_API const vec3& Spatial::up() const { return u; }
 
-KX_MATH_API mat4 Spatial::transform() const {
-  return mat4(r.x, u.x, -f.x, p.x, r.y, u.y, -f.y, p.y, r.z, u.z, -f.z, p.z,
-              0.0f, 0.0f, 0.0f, 1.0f);
+KX_MATH_API const mat4& Spatial::transform() const {
+  if (cached_version_ != version_) {
+    transform_ = mat4(r.x, u.x, -f.x, p.x, r.y, u.y, -f.y, p.y, r.z, u.z, -f.z,
+                      p.z, 0.0f, 0.0f, 0.0f, 1.0f);
+    inverse_transform_ = inverse_transform(transform_);
+    cached_version_ = version_;
+  }
+  return transform_;
 }
 
-KX_MATH_API mat4 Spatial::inverseTransform() const {
-  return inverse_transform(transform());
+KX_MATH_API const mat4& Spatial::inverseTransform() const {
+  transform();
+  return inverse_transform_;
 }
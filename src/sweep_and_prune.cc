@@ -0,0 +1,253 @@
+#include <math/intersection.h>
+#include <math/parallel.h>
+#include <math/simd.h>
+#include <math/sweep_and_prune.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace kx;
+
+namespace {
+
+/// Boxes per parallel chunk of the sweep.
+const std::size_t kGrain = 1024;
+
+/// Marks the empty slots of a PairSet.
+const std::uint64_t kEmpty = ~std::uint64_t(0);
+
+std::uint64_t key(std::uint32_t a, std::uint32_t b) {
+  return a < b ? std::uint64_t(a) << 32 | b : std::uint64_t(b) << 32 | a;
+}
+
+/// The order of endpoints: by value, then minima first, so that boxes that
+/// touch overlap.
+template <typename Endpoint>
+bool less(const Endpoint& e, const Endpoint& f) {
+  return e.value < f.value || (e.value == f.value && (e.id & 1) < (f.id & 1));
+}
+
+}  // namespace
+
+SweepAndPrune::SweepAndPrune(Axes axes) : axes_(axes) { clear(); }
+
+void SweepAndPrune::clear() {
+  n_ = 0;
+  axis_ = 0;
+  for (int a = 0; a < 3; ++a) sorted_[a].clear();
+  set_.clear(0);
+  pairs_.clear();
+}
+
+void SweepAndPrune::update(const AABB3* boxes, std::size_t n) {
+  if (n != n_) {
+    start(boxes, n);
+  } else if (axes_ == Axes::one) {
+    sort(boxes, axis_);
+    sweep(boxes);
+  } else {
+    for (int a = 0; a < 3; ++a) sort(boxes, a);
+    set_.get(pairs_);
+  }
+}
+
+/// Sort the endpoints from scratch and find the overlapping pairs with a
+/// sweep.
+void SweepAndPrune::start(const AABB3* boxes, std::size_t n) {
+  n_ = n;
+
+  // Sweep along the axis the boxes' centers spread most along, where the
+  // fewest of them overlap.
+  vec3 sum(0);
+  vec3 sum2(0);
+  for (std::size_t i = 0; i < n; ++i) {
+    vec3 c = boxes[i].pmin + boxes[i].pmax;
+    sum += c;
+    sum2 += c * c;
+  }
+  vec3 var = sum2 * R(n) - sum * sum;
+  axis_ = var.x > var.y ? (var.x > var.z ? 0 : 2) : (var.y > var.z ? 1 : 2);
+
+  for (int a = 0; a < 3; ++a) {
+    std::vector<Endpoint>& v = sorted_[a];
+    v.clear();
+    if (axes_ == Axes::one && a != axis_) continue;
+    for (std::uint32_t i = 0; i < n; ++i) {
+      v.push_back({boxes[i].pmin[a], i << 1});
+      if (axes_ == Axes::three) v.push_back({boxes[i].pmax[a], i << 1 | 1});
+    }
+    std::sort(v.begin(), v.end(), less<Endpoint>);
+  }
+  sweep(boxes);
+
+  if (axes_ == Axes::three) {
+    set_.clear(pairs_.size());
+    for (const BoxPair& p : pairs_) set_.insert(key(p.a, p.b));
+  }
+}
+
+/// Restore the order of the endpoints along the axis after the boxes moved.
+/// With three axes, update the set of overlapping pairs as endpoints pass
+/// each other.
+void SweepAndPrune::sort(const AABB3* boxes, int axis) {
+  std::vector<Endpoint>& v = sorted_[axis];
+  for (Endpoint& e : v) {
+    const AABB3& box = boxes[e.id >> 1];
+    e.value = (e.id & 1) ? box.pmax[axis] : box.pmin[axis];
+  }
+
+  const bool track = axes_ == Axes::three;
+  for (std::size_t i = 1; i < v.size(); ++i) {
+    const Endpoint e = v[i];
+    std::size_t j = i;
+    for (; j > 0 && less(e, v[j - 1]); --j) {
+      const Endpoint& f = v[j - 1];
+      const std::uint32_t a = e.id >> 1;
+      const std::uint32_t b = f.id >> 1;
+      if (track && a != b) {
+        // A minimum passing a maximum may start an overlap, and a maximum
+        // passing a minimum ends one.
+        if (!(e.id & 1) && (f.id & 1)) {
+          if (intersect(boxes[a], boxes[b])) set_.insert(key(a, b));
+        } else if ((e.id & 1) && !(f.id & 1)) {
+          set_.erase(key(a, b));
+        }
+      }
+      v[j] = f;
+    }
+    v[j] = e;
+  }
+}
+
+/// Find the overlapping pairs by sweeping the boxes in the order of their
+/// minima along the sweep axis.
+void SweepAndPrune::sweep(const AABB3* boxes) {
+  const std::vector<Endpoint>& v = sorted_[axis_];
+  order_.clear();
+  for (const Endpoint& e : v)
+    if (!(e.id & 1)) order_.push_back(e.id >> 1);
+
+  // Store the bounds in sweep order, padded for the last SIMD loads with
+  // boxes that overlap nothing.
+  const std::size_t n = order_.size();
+  const R inf = std::numeric_limits<R>::infinity();
+  for (int a = 0; a < 3; ++a) {
+    lo_[a].assign(n + simd::Rv::N, inf);
+    hi_[a].assign(n + simd::Rv::N, -inf);
+    for (std::size_t i = 0; i < n; ++i) {
+      lo_[a][i] = boxes[order_[i]].pmin[a];
+      hi_[a][i] = boxes[order_[i]].pmax[a];
+    }
+  }
+
+  chunks_.resize((n + kGrain - 1) / kGrain);
+  parallel_for(n, kGrain, [&](std::size_t begin, std::size_t end) {
+    std::vector<BoxPair>& out = chunks_[begin / kGrain];
+    out.clear();
+    sweep(begin, end, out);
+  });
+  pairs_.clear();
+  for (const std::vector<BoxPair>& c : chunks_)
+    pairs_.insert(pairs_.end(), c.begin(), c.end());
+}
+
+/// Test the boxes [begin, end) of the sweep order against the boxes that
+/// follow them and start before they end.
+void SweepAndPrune::sweep(std::size_t begin, std::size_t end,
+                          std::vector<BoxPair>& out) const {
+  using simd::Rv;
+  const std::size_t n = order_.size();
+  const int a = axis_;
+  const int b = (a + 1) % 3;
+  const int c = (a + 2) % 3;
+  const R* lo_a = lo_[a].data();
+  const R* lo_b = lo_[b].data();
+  const R* hi_b = hi_[b].data();
+  const R* lo_c = lo_[c].data();
+  const R* hi_c = hi_[c].data();
+
+  for (std::size_t i = begin; i < end; ++i) {
+    const Rv end_a(hi_[a][i]);
+    const Rv min_b(lo_b[i]);
+    const Rv max_b(hi_b[i]);
+    const Rv min_c(lo_c[i]);
+    const Rv max_c(hi_c[i]);
+    for (std::size_t k = i + 1; k < n; k += Rv::N) {
+      // The boxes are sorted by their minima along the sweep axis, so once
+      // a pack starts after box i ends, so do the rest.
+      const simd::Mask started = simd::load(lo_a + k) <= end_a;
+      if (!any(started)) break;
+      const simd::Mask m = started & (simd::load(lo_b + k) <= max_b) &
+                           (min_b <= simd::load(hi_b + k)) &
+                           (simd::load(lo_c + k) <= max_c) &
+                           (min_c <= simd::load(hi_c + k));
+      for (int bits = simd::bits(m), l = 0; bits != 0; bits >>= 1, ++l) {
+        if ((bits & 1) && k + l < n) {
+          std::uint32_t p = order_[i];
+          std::uint32_t q = order_[k + l];
+          out.push_back(p < q ? BoxPair{p, q} : BoxPair{q, p});
+        }
+      }
+    }
+  }
+}
+
+//
+// PairSet
+//
+
+void SweepAndPrune::PairSet::clear(std::size_t capacity) {
+  std::size_t n = 16;
+  while (n < 2 * capacity) n *= 2;
+  keys_.assign(n, kEmpty);
+  size_ = 0;
+}
+
+std::size_t SweepAndPrune::PairSet::slot(std::uint64_t key) const {
+  const std::uint64_t h = key * 0x9e3779b97f4a7c15ull;
+  return std::size_t(h >> 32) & (keys_.size() - 1);
+}
+
+void SweepAndPrune::PairSet::insert(std::uint64_t key) {
+  // Keep the table at most half full.
+  if (2 * (size_ + 1) > keys_.size()) {
+    std::vector<std::uint64_t> old;
+    old.swap(keys_);
+    clear(old.size());
+    for (std::uint64_t k : old)
+      if (k != kEmpty) insert(k);
+  }
+  const std::size_t mask = keys_.size() - 1;
+  std::size_t i = slot(key);
+  for (; keys_[i] != kEmpty; i = (i + 1) & mask)
+    if (keys_[i] == key) return;
+  keys_[i] = key;
+  ++size_;
+}
+
+void SweepAndPrune::PairSet::erase(std::uint64_t key) {
+  const std::size_t mask = keys_.size() - 1;
+  std::size_t i = slot(key);
+  for (; keys_[i] != key; i = (i + 1) & mask)
+    if (keys_[i] == kEmpty) return;
+
+  // Shift back the keys that follow in the probe sequence, so that no gap
+  // separates a key from its slot.
+  for (std::size_t j = (i + 1) & mask; keys_[j] != kEmpty; j = (j + 1) & mask) {
+    const std::size_t k = slot(keys_[j]);
+    const bool stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+    if (!stays) {
+      keys_[i] = keys_[j];
+      i = j;
+    }
+  }
+  keys_[i] = kEmpty;
+  --size_;
+}
+
+void SweepAndPrune::PairSet::get(std::vector<BoxPair>& out) const {
+  out.clear();
+  for (std::uint64_t k : keys_)
+    if (k != kEmpty)
+      out.push_back({std::uint32_t(k >> 32), std::uint32_t(k)});
+}
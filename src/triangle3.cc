@@ -0,0 +1,24 @@
+#include <math/parallel.h>
+#include <math/triangle3.h>
+
+using namespace kx;
+
+namespace {
+
+/// Triangles per parallel chunk.
+const std::size_t kGrain = 1 << 14;
+
+}  // namespace
+
+std::vector<Triangle3> kx::mesh_triangles(const vec3* vertices,
+                                          const std::uint32_t* indices,
+                                          std::size_t num_triangles) {
+  std::vector<Triangle3> triangles(num_triangles);
+  parallel_for(num_triangles, kGrain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const std::uint32_t* v = indices + 3 * i;
+      triangles[i] = Triangle3(vertices[v[0]], vertices[v[1]], vertices[v[2]]);
+    }
+  });
+  return triangles;
+}
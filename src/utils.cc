@@ -1,3 +1,4 @@
+#include <math/simd.h>
 #include <math/utils.h>
 #include <cstdlib>  // to resolve ambiguous std::abs() when using llvm
 
@@ -27,45 +28,113 @@ KX_MATH_API bool kx::R_eq(R a, R b, R eps, int ULPs) {
   }
 }
 
-KX_MATH_API mat3 kx::qmat3(const quat& q) {
-  R x = q.x;
-  R y = q.y;
-  R z = q.z;
-  R w = q.w;
-  R xx = x * x;
-  R xy = x * y;
-  R xz = x * z;
-  R yy = y * y;
-  R yz = y * z;
-  R zz = z * z;
-  R wx = w * x;
-  R wy = w * y;
-  R wz = w * z;
-
-  return mat3(1 - 2 * yy - 2 * zz, 2 * xy + 2 * wz, 2 * xz - 2 * wy,
-              2 * xy - 2 * wz, 1 - 2 * xx - 2 * zz, 2 * yz + 2 * wx,
-              2 * xz + 2 * wy, 2 * yz - 2 * wx, 1 - 2 * xx - 2 * yy);
+template <typename T>
+KX_MATH_API mat3T<T> kx::qmat3(const quatT<T>& q) {
+  T x = q.x;
+  T y = q.y;
+  T z = q.z;
+  T w = q.w;
+  T xx = x * x;
+  T xy = x * y;
+  T xz = x * z;
+  T yy = y * y;
+  T yz = y * z;
+  T zz = z * z;
+  T wx = w * x;
+  T wy = w * y;
+  T wz = w * z;
+
+  return mat3T<T>(1 - 2 * yy - 2 * zz, 2 * xy + 2 * wz, 2 * xz - 2 * wy,
+                  2 * xy - 2 * wz, 1 - 2 * xx - 2 * zz, 2 * yz + 2 * wx,
+                  2 * xz + 2 * wy, 2 * yz - 2 * wx, 1 - 2 * xx - 2 * yy);
 }
 
-KX_MATH_API mat4 kx::qmat4(const quat& q) {
-  R x = q.x;
-  R y = q.y;
-  R z = q.z;
-  R w = q.w;
-  R xx = x * x;
-  R xy = x * y;
-  R xz = x * z;
-  R yy = y * y;
-  R yz = y * z;
-  R zz = z * z;
-  R wx = w * x;
-  R wy = w * y;
-  R wz = w * z;
-
-  return mat4(1 - 2 * yy - 2 * zz, 2 * xy + 2 * wz, 2 * xz - 2 * wy, 0.0f,
-              2 * xy - 2 * wz, 1 - 2 * xx - 2 * zz, 2 * yz + 2 * wx, 0.0f,
-              2 * xz + 2 * wy, 2 * yz - 2 * wx, 1 - 2 * xx - 2 * yy, 0.0f, 0.0f,
-              0.0f, 0.0f, 1.0f);
+template <typename T>
+KX_MATH_API mat4T<T> kx::qmat4(const quatT<T>& q) {
+  T x = q.x;
+  T y = q.y;
+  T z = q.z;
+  T w = q.w;
+  T xx = x * x;
+  T xy = x * y;
+  T xz = x * z;
+  T yy = y * y;
+  T yz = y * z;
+  T zz = z * z;
+  T wx = w * x;
+  T wy = w * y;
+  T wz = w * z;
+
+  return mat4T<T>(1 - 2 * yy - 2 * zz, 2 * xy + 2 * wz, 2 * xz - 2 * wy, 0.0f,
+                  2 * xy - 2 * wz, 1 - 2 * xx - 2 * zz, 2 * yz + 2 * wx, 0.0f,
+                  2 * xz + 2 * wy, 2 * yz - 2 * wx, 1 - 2 * xx - 2 * yy, 0.0f,
+                  0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+template KX_MATH_API mat3f kx::qmat3(const quatf&);
+template KX_MATH_API mat3d kx::qmat3(const quatd&);
+template KX_MATH_API mat4f kx::qmat4(const quatf&);
+template KX_MATH_API mat4d kx::qmat4(const quatd&);
+
+namespace {
+
+// The entries of the rotation matrix of a pack of quaternions, indexed by
+// (row, col) as in qmat3().
+struct rotv {
+  simd::Rv m[3][3];
+};
+
+rotv qrotv(const quat* q) {
+  using simd::Rv;
+  const R* p = &q->w;
+  Rv w = simd::gather(p, 4);
+  Rv x = simd::gather(p + 1, 4);
+  Rv y = simd::gather(p + 2, 4);
+  Rv z = simd::gather(p + 3, 4);
+  Rv xx = x * x, xy = x * y, xz = x * z;
+  Rv yy = y * y, yz = y * z, zz = z * z;
+  Rv wx = w * x, wy = w * y, wz = w * z;
+  Rv one(1), two(2);
+
+  rotv r;
+  r.m[0][0] = one - two * (yy + zz);
+  r.m[0][1] = two * (xy + wz);
+  r.m[0][2] = two * (xz - wy);
+  r.m[1][0] = two * (xy - wz);
+  r.m[1][1] = one - two * (xx + zz);
+  r.m[1][2] = two * (yz + wx);
+  r.m[2][0] = two * (xz + wy);
+  r.m[2][1] = two * (yz - wx);
+  r.m[2][2] = one - two * (xx + yy);
+  return r;
+}
+
+// Matrices are stored column-major, so entry (row, col) of the ith matrix
+// lives at base + i*stride + col*dim + row.
+void store_rotv(const rotv& r, R* base, int dim, int stride) {
+  for (int row = 0; row < 3; ++row)
+    for (int col = 0; col < 3; ++col)
+      simd::scatter(base + col * dim + row, stride, r.m[row][col]);
+}
+
+}  // namespace
+
+void kx::qmat3(const quat* q, mat3* out, size_t n) {
+  using simd::Rv;
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N)
+    store_rotv(qrotv(q + i), (R*)(const R*)out[i], 3, 9);
+  for (; i < n; ++i) out[i] = qmat3(q[i]);
+}
+
+void kx::qmat4(const quat* q, mat4* out, size_t n) {
+  using simd::Rv;
+  size_t i = 0;
+  for (; i + Rv::N <= n; i += Rv::N) {
+    for (size_t j = i; j < i + Rv::N; ++j) out[j] = mat4();
+    store_rotv(qrotv(q + i), (R*)(const R*)out[i], 4, 16);
+  }
+  for (; i < n; ++i) out[i] = qmat4(q[i]);
 }
 
 KX_MATH_API R kx::pitch_from_fwd(vec3 forward) {